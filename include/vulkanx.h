@@ -30,8 +30,10 @@
 #ifndef VULKANX_H
 #define VULKANX_H
 
+#include <vulkanx/allocator.h>
 #include <vulkanx/buffer.h>
 #include <vulkanx/command_buffer.h>
+#include <vulkanx/deletion_queue.h>
 #include <vulkanx/descriptor_set.h>
 #include <vulkanx/image.h>
 #include <vulkanx/memory.h>
@@ -39,6 +41,8 @@
 #include <vulkanx/result.h>
 #include <vulkanx/shader.h>
 #include <vulkanx/setup.h>
+#include <vulkanx/stream.h>
 #include <vulkanx/swapchain.h>
+#include <vulkanx/transfer.h>
 
 #endif // #ifndef VULKANX_H
@@ -0,0 +1,711 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#pragma once
+#ifndef VULKANX_ALLOCATOR_H
+#define VULKANX_ALLOCATOR_H
+
+#include <vulkanx/memory.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/**
+ * @defgroup allocator Allocator
+ *
+ * `<vulkanx/allocator.h>`
+ */
+/**@{*/
+
+/**
+ * @brief Default allocator block size in bytes (256 MiB).
+ */
+#define VKX_DEFAULT_ALLOCATOR_BLOCK_SIZE ((VkDeviceSize)256 << 20)
+
+/**
+ * @brief Default allocator budget fraction.
+ */
+#define VKX_DEFAULT_ALLOCATOR_BUDGET_FRACTION 0.9f
+
+/**
+ * @brief Allocator block.
+ *
+ * This is an opaque structure representing one `VkDeviceMemory`
+ * allocation of a single memory type, which the allocator sub-allocates
+ * with a best-fit free list.
+ */
+typedef struct VkxAllocatorBlock_ VkxAllocatorBlock;
+
+/**
+ * @brief Budget policy.
+ *
+ * What the allocator does when allocating a new block would exceed the
+ * soft budget of a memory heap.
+ */
+typedef enum VkxBudgetPolicy_
+{
+    /** @brief Ignore budget, leave it to the driver. */
+    VKX_BUDGET_POLICY_IGNORE = 0,
+
+    /** @brief Fail with `VK_ERROR_OUT_OF_DEVICE_MEMORY`. */
+    VKX_BUDGET_POLICY_FAIL = 1,
+
+    /** @brief Ask the client to evict, then fail if still over budget. */
+    VKX_BUDGET_POLICY_EVICT = 2
+}
+VkxBudgetPolicy;
+
+/**
+ * @brief Allocator create info.
+ */
+typedef struct VkxAllocatorCreateInfo_
+{
+    /** 
+     * @brief Block size in bytes.
+     *
+     * If `0`, the implementation uses `VKX_DEFAULT_ALLOCATOR_BLOCK_SIZE`.
+     * The implementation limits the block size to 1/8th of the
+     * associated memory heap, so that small heaps are not exhausted by
+     * a single block.
+     */
+    VkDeviceSize blockSize;
+
+    /**
+     * @brief Enable `VK_EXT_memory_budget`?
+     *
+     * If `VK_TRUE`, the device must have been created with 
+     * `VK_EXT_memory_budget` enabled. The allocator then takes heap 
+     * budgets and usage from the extension, which accounts for every 
+     * allocation in the process. Otherwise, the allocator only accounts 
+     * for its own blocks against the heap size.
+     */
+    VkBool32 memoryBudgetEnabled;
+
+    /** @brief Budget policy. */
+    VkxBudgetPolicy budgetPolicy;
+
+    /**
+     * @brief Soft budget as a fraction of heap budget.
+     *
+     * If `0`, the implementation uses 
+     * `VKX_DEFAULT_ALLOCATOR_BUDGET_FRACTION`.
+     */
+    float budgetFraction;
+
+    /**
+     * @brief _Optional_. Evict callback, for `VKX_BUDGET_POLICY_EVICT`.
+     *
+     * Called with a heap index and the number of bytes the allocator 
+     * needs to release in that heap. The client may free memory, 
+     * including by `vkxAllocatorFreeMemory`, and returns `VK_TRUE` if 
+     * it freed anything. The allocator calls the callback again until
+     * within budget, or until the callback returns `VK_FALSE`.
+     */
+    VkBool32 (*pEvict)(uint32_t, VkDeviceSize, void*);
+
+    /** @brief _Optional_. Evict callback user data. */
+    void* pEvictUserData;
+}
+VkxAllocatorCreateInfo;
+
+/**
+ * @brief Memory heap statistics.
+ */
+typedef struct VkxMemoryHeapStatistics_
+{
+    /** @brief Block count. */
+    uint32_t blockCount;
+
+    /** @brief Allocation count, in live sub-allocations. */
+    uint32_t allocationCount;
+
+    /** @brief Bytes allocated in blocks. */
+    VkDeviceSize blockBytes;
+
+    /** @brief Bytes used by live sub-allocations. */
+    VkDeviceSize allocationBytes;
+
+    /**
+     * @brief Heap budget in bytes.
+     *
+     * From `VK_EXT_memory_budget` if enabled, otherwise heap size.
+     */
+    VkDeviceSize budgetBytes;
+
+    /**
+     * @brief Heap usage in bytes.
+     *
+     * From `VK_EXT_memory_budget` if enabled, otherwise block bytes.
+     */
+    VkDeviceSize usageBytes;
+}
+VkxMemoryHeapStatistics;
+
+/**
+ * @brief Memory statistics.
+ */
+typedef struct VkxMemoryStatistics_
+{
+    /** @brief Memory heap count. */
+    uint32_t memoryHeapCount;
+
+    /** @brief Memory heap statistics. */
+    VkxMemoryHeapStatistics memoryHeaps[VK_MAX_MEMORY_HEAPS];
+}
+VkxMemoryStatistics;
+
+/**
+ * @brief Allocator.
+ *
+ * This structure reserves large `VkDeviceMemory` blocks per memory type 
+ * and hands out `VkxDeviceMemoryView` sub-ranges of them, so that creating
+ * many small objects does not cost one `vkAllocateMemory` each, and does 
+ * not exhaust `maxMemoryAllocationCount`. Requests larger than half of the
+ * block size are given dedicated blocks of their own.
+ *
+ * @note
+ * The allocator is not internally synchronized.
+ */
+typedef struct VkxAllocator_
+{
+    /** @brief Associated physical device. */
+    VkPhysicalDevice physicalDevice;
+
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Memory type table. */
+    VkxMemoryTypeTable memoryTypeTable;
+
+    /** @brief Block size. */
+    VkDeviceSize blockSize;
+
+    /** @brief Memory budget enabled? */
+    VkBool32 memoryBudgetEnabled;
+
+    /** @brief Budget policy. */
+    VkxBudgetPolicy budgetPolicy;
+
+    /** @brief Soft budget as a fraction of heap budget. */
+    float budgetFraction;
+
+    /** @brief _Optional_. Evict callback. */
+    VkBool32 (*pEvict)(uint32_t, VkDeviceSize, void*);
+
+    /** @brief _Optional_. Evict callback user data. */
+    void* pEvictUserData;
+
+    /** 
+     * @brief Memory heap statistics.
+     *
+     * The allocator maintains block and allocation counters only, 
+     * budget and usage are filled in by `vkxGetMemoryStatistics`.
+     */
+    VkxMemoryHeapStatistics heapStatistics[VK_MAX_MEMORY_HEAPS];
+
+    /** @brief Block count. */
+    uint32_t blockCount;
+
+    /** @brief Block capacity. */
+    uint32_t blockCapacity;
+
+    /** @brief Blocks. */
+    VkxAllocatorBlock** ppBlocks;
+}
+VkxAllocator;
+
+/**
+ * @brief Allocation.
+ */
+typedef struct VkxAllocation_
+{
+    /** @brief Memory view to bind. */
+    VkxDeviceMemoryView memoryView;
+
+    /** @brief Memory type index. */
+    uint32_t memoryTypeIndex;
+
+    /** @brief Associated block. */
+    VkxAllocatorBlock* pBlock;
+}
+VkxAllocation;
+
+/**
+ * @brief Create allocator.
+ *
+ * @param[in] physicalDevice
+ * Physical device.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] pCreateInfo
+ * _Optional_. Create info.
+ *
+ * @param[out] pMemoryAllocator
+ * Allocator.
+ *
+ * @pre
+ * - `physicalDevice` is valid
+ * - `device` is valid
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pMemoryAllocator` is uninitialized
+ *
+ * @post
+ * - `pMemoryAllocator` is properly initialized
+ *
+ * @note
+ * No device memory is allocated until the first call to
+ * `vkxAllocatorAllocateMemory`.
+ */
+VkResult vkxCreateAllocator(
+            VkPhysicalDevice physicalDevice,
+            VkDevice device,
+            const VkxAllocatorCreateInfo* pCreateInfo,
+            VkxAllocator* pMemoryAllocator);
+
+/**
+ * @brief Destroy allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to allocate every block in `pMemoryAllocator`
+ * - no object is still bound to memory in `pMemoryAllocator`
+ *
+ * @post
+ * - `pMemoryAllocator` is nullified
+ *
+ * @note
+ * Does nothing if `pMemoryAllocator` is `NULL`.
+ */
+void vkxDestroyAllocator(
+            VkxAllocator* pMemoryAllocator,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Allocate memory from allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pMemoryRequirements
+ * Memory requirements.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] allocationType
+ * Allocation type.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks, used if a new block is necessary.
+ *
+ * @param[out] pAllocation
+ * Allocation.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pMemoryRequirements` is non-`NULL`
+ * - `pAllocation` is non-`NULL`
+ *
+ * @post
+ * - on success, `pAllocation` is properly initialized
+ * - on failure, `pAllocation` is nullified
+ *
+ * @note
+ * If no memory type supports `memoryPropertyFlags`, the 
+ * implementation returns `VK_ERROR_INITIALIZATION_FAILED`. If a new
+ * block fails to allocate in a supported memory type, the implementation
+ * tries the next supported memory type before failing.
+ *
+ * @note
+ * Before allocating a new block, the implementation checks the soft 
+ * budget of the memory heap. If over budget, it first releases empty
+ * blocks it kept in that heap, then applies the budget policy.
+ */
+VkResult vkxAllocatorAllocateMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            VkxAllocationType allocationType,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocation* pAllocation);
+
+/**
+ * @brief Allocate dedicated memory from allocator.
+ *
+ * Like `vkxAllocatorAllocateMemory`, except always allocates a new block
+ * holding this allocation alone, with `pDedicatedAllocateInfo` chained to
+ * the memory allocate info. This is necessary for resources reporting
+ * `requiresDedicatedAllocation`. The block is released when the 
+ * allocation is freed, and never considered for defragmentation.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pMemoryRequirements
+ * Memory requirements.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] allocationType
+ * Allocation type.
+ *
+ * @param[in] pDedicatedAllocateInfo
+ * Dedicated allocate info, naming the buffer or image.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pAllocation
+ * Allocation.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pMemoryRequirements` is non-`NULL`, and queried from the buffer or
+ * image named by `pDedicatedAllocateInfo`
+ * - `pDedicatedAllocateInfo` is non-`NULL`
+ * - `pAllocation` is non-`NULL`
+ *
+ * @post
+ * - on success, `pAllocation` is properly initialized
+ * - on failure, `pAllocation` is nullified
+ *
+ * @note
+ * The allocation size is exactly `pMemoryRequirements->size`, as 
+ * dedicated allocations require, so it is not padded by 
+ * `vkxMemoryTypeTablePadAllocationSize`.
+ */
+VkResult vkxAllocatorAllocateDedicatedMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            VkxAllocationType allocationType,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfo,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocation* pAllocation);
+
+/**
+ * @brief Free memory to allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[inout] pAllocation
+ * Allocation.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks, used if a block is released.
+ *
+ * @pre
+ * - `pAllocation` was previously allocated from `pMemoryAllocator`
+ *
+ * @post
+ * - `pAllocation` is nullified
+ *
+ * @note
+ * Does nothing if `pAllocation` is `NULL` or nullified. Empty blocks are
+ * released, except for the last block of each memory type, which is
+ * kept to avoid thrashing.
+ */
+void vkxAllocatorFreeMemory(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocation* pAllocation,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Map memory in allocator.
+ *
+ * Blocks are mapped in their entirety, and reference counted, so that 
+ * any number of allocations in the same block may be mapped at once
+ * with only one call to `vkMapMemory`, and the mapping persists until
+ * the last allocation is unmapped.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pAllocation
+ * Allocation.
+ *
+ * @param[out] ppData
+ * Mapped data, pointing to the beginning of the allocation.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pAllocation` was previously allocated from `pMemoryAllocator` 
+ * with host-visible memory
+ * - `ppData` is non-`NULL`
+ *
+ * @note
+ * If the memory type is not host-coherent, the client must flush
+ * writes and invalidate before reads, e.g., by `vkxFlushMemoryViews` 
+ * and `vkxInvalidateMemoryViews`.
+ */
+VkResult vkxAllocatorMapMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkxAllocation* pAllocation,
+            void** ppData);
+
+/**
+ * @brief Unmap memory in allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pAllocation
+ * Allocation.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pAllocation` was previously mapped by `vkxAllocatorMapMemory`
+ *
+ * @note
+ * Every call to `vkxAllocatorMapMemory` must be matched by one call to
+ * `vkxAllocatorUnmapMemory` before the allocation is freed.
+ */
+void vkxAllocatorUnmapMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkxAllocation* pAllocation);
+
+/**
+ * @brief Get memory statistics.
+ *
+ * @param[in] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[out] pStatistics
+ * Memory statistics.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pStatistics` is non-`NULL`
+ *
+ * @note
+ * Only queries the physical device if `VK_EXT_memory_budget` is 
+ * enabled, counters are otherwise maintained by the allocator.
+ */
+void vkxGetMemoryStatistics(
+            const VkxAllocator* pMemoryAllocator,
+            VkxMemoryStatistics* pStatistics);
+
+/**
+ * @brief Defragmentation resource.
+ *
+ * An allocation which the client permits the allocator to move, along 
+ * with the buffer or image bound to it. Exactly one of `pBuffer` or 
+ * `pImage` is non-`NULL`.
+ */
+typedef struct VkxDefragmentationResource_
+{
+    /** @brief Allocation. */
+    VkxAllocation* pAllocation;
+
+    /** @brief Buffer, or `NULL`. */
+    VkBuffer* pBuffer;
+
+    /** @brief Buffer create info, if buffer. */
+    const VkBufferCreateInfo* pBufferCreateInfo;
+
+    /** @brief Image, or `NULL`. */
+    VkImage* pImage;
+
+    /** @brief Image create info, if image. */
+    const VkImageCreateInfo* pImageCreateInfo;
+
+    /** @brief Image layout at time of execution, if image. */
+    VkImageLayout imageLayout;
+
+    /** @brief Image aspect mask, if image. */
+    VkImageAspectFlags imageAspectMask;
+}
+VkxDefragmentationResource;
+
+/**
+ * @brief Defragmentation move.
+ */
+typedef struct VkxDefragmentationMove_
+{
+    /** @brief Resource index. */
+    uint32_t resourceIndex;
+
+    /** @brief Old memory view. */
+    VkxDeviceMemoryView oldMemoryView;
+
+    /** @brief New memory view. */
+    VkxDeviceMemoryView newMemoryView;
+
+    /** @brief New buffer, or `VK_NULL_HANDLE`. */
+    VkBuffer newBuffer;
+
+    /** @brief New image, or `VK_NULL_HANDLE`. */
+    VkImage newImage;
+
+    /** @brief New allocation. */
+    VkxAllocation newAllocation;
+
+    /** @brief Resource allocation, updated at end. */
+    VkxAllocation* pAllocation;
+
+    /** @brief Resource buffer, updated at end. */
+    VkBuffer* pBuffer;
+
+    /** @brief Resource image, updated at end. */
+    VkImage* pImage;
+}
+VkxDefragmentationMove;
+
+/**
+ * @brief Defragmentation.
+ *
+ * This structure holds moves between `vkxAllocatorBeginDefragmentation`
+ * and `vkxAllocatorEndDefragmentation`. The moves double as a remap table
+ * from old to new memory views, e.g., to rewrite descriptors.
+ */
+typedef struct VkxDefragmentation_
+{
+    /** @brief Move count. */
+    uint32_t moveCount;
+
+    /** @brief Moves. */
+    VkxDefragmentationMove* pMoves;
+
+    /** @brief Moved bytes. */
+    VkDeviceSize movedBytes;
+}
+VkxDefragmentation;
+
+/**
+ * @brief Begin defragmentation.
+ *
+ * Moves allocations out of sparsely used blocks into gaps in densely 
+ * used blocks, or towards the beginning of their own block, so that
+ * blocks drain and are released at the end of defragmentation. For 
+ * each move, the implementation creates a new buffer or image, binds
+ * it to the new location, and records a copy from the old resource
+ * into `commandBuffer`. Copies are surrounded by one barrier batch each
+ * side. 
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] commandBuffer
+ * Command buffer, in the recording state, to record copies into.
+ *
+ * @param[in] resourceCount
+ * Resource count.
+ *
+ * @param[in] pResources
+ * Resources.
+ *
+ * @param[in] maxMovedBytes
+ * Maximum number of bytes to move, or `VK_WHOLE_SIZE` for no limit.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pDefragmentation
+ * Defragmentation.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pResources` points to `resourceCount` values
+ * - every buffer was created with both `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
+ * and `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ * - every image was created with both `VK_IMAGE_USAGE_TRANSFER_SRC_BIT`
+ * and `VK_IMAGE_USAGE_TRANSFER_DST_BIT`
+ * - no image layout is `VK_IMAGE_LAYOUT_UNDEFINED` or 
+ * `VK_IMAGE_LAYOUT_PREINITIALIZED`
+ * - `pDefragmentation` is non-`NULL`
+ *
+ * @post
+ * - `pDefragmentation` is properly initialized
+ *
+ * @return
+ * `VK_INCOMPLETE` if the implementation stopped at `maxMovedBytes`,
+ * so that calling once per frame compacts incrementally.
+ *
+ * @note
+ * Resources remain valid until `vkxAllocatorEndDefragmentation`, but
+ * the client must not write to moved resources after the copies 
+ * execute. Allocations in dedicated blocks are never moved. Mapped 
+ * allocations must not be passed as resources, since mappings are 
+ * not carried over to new allocations.
+ */
+VkResult vkxAllocatorBeginDefragmentation(
+            VkxAllocator* pMemoryAllocator,
+            VkCommandBuffer commandBuffer,
+            uint32_t resourceCount,
+            const VkxDefragmentationResource* pResources,
+            VkDeviceSize maxMovedBytes,
+            const VkAllocationCallbacks* pAllocator,
+            VkxDefragmentation* pDefragmentation);
+
+/**
+ * @brief End defragmentation.
+ *
+ * Destroys old resources, frees old allocations, and writes new 
+ * resources and allocations back to the client.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[inout] pDefragmentation
+ * Defragmentation.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pDefragmentation` was begun on `pMemoryAllocator`
+ * - the copies recorded by `vkxAllocatorBeginDefragmentation` completed
+ * execution
+ * - the resources passed to `vkxAllocatorBeginDefragmentation` are 
+ * still at the same addresses
+ *
+ * @post
+ * - `pDefragmentation` is nullified
+ */
+void vkxAllocatorEndDefragmentation(
+            VkxAllocator* pMemoryAllocator,
+            VkxDefragmentation* pDefragmentation,
+            const VkAllocationCallbacks* pAllocator);
+
+/**@}*/
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef VULKANX_ALLOCATOR_H
@@ -30,6 +30,8 @@
 #ifndef VULKANX_BUFFER_H
 #define VULKANX_BUFFER_H
 
+#include <vulkanx/allocator.h>
+#include <vulkanx/command_buffer.h>
 #include <vulkanx/memory.h>
 
 #ifdef __cplusplus
@@ -57,14 +59,26 @@ typedef struct VkxBuffer_
      * @brief Memory.
      */
     VkDeviceMemory memory;
+
+    /**
+     * @brief Persistently mapped data, or `NULL` if not host-visible.
+     */
+    void* pMappedData;
 }
 VkxBuffer;
 
 /**
  * @brief Create buffer.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If the implementation prefers or requires a dedicated allocation 
+ * for the buffer, as reported by `VkMemoryDedicatedRequirements`, the
+ * memory is allocated with `VkMemoryDedicatedAllocateInfo`. If 
+ * `memoryPropertyFlags` includes `VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT`,
+ * the memory is mapped once at creation and stays mapped until the
+ * buffer is destroyed, so host access is a plain load or store.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -82,7 +96,7 @@ VkxBuffer;
  * Buffer.
  *
  * @pre
- * - `physicalDevice` is valid
+ * - `pMemoryTypeTable` is non-`NULL`
  * - `device` is valid
  * - `pBufferCreateInfo` is non-`NULL`
  * - `pBuffer` is non-`NULL` 
@@ -93,7 +107,7 @@ VkxBuffer;
  * - on failure, `pBuffer` is nullified
  */
 VkResult vkxCreateBuffer(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             const VkBufferCreateInfo* pBufferCreateInfo,
             const VkMemoryPropertyFlags memoryPropertyFlags,
@@ -130,29 +144,139 @@ void vkxDestroyBuffer(
             const VkAllocationCallbacks* pAllocator);
 
 /**
- * @brief Buffer group.
+ * @brief Create staging buffer.
+ *
+ * Staging buffers are host-visible, and persistently mapped by 
+ * `vkxCreateBuffer`. If `usage` includes `VK_BUFFER_USAGE_TRANSFER_DST_BIT`,
+ * the buffer is for readback, and the implementation prefers 
+ * `VK_MEMORY_PROPERTY_HOST_CACHED_BIT` memory, which is much faster for 
+ * the host to read on integrated GPUs, but may not be host-coherent. 
+ * Otherwise, the implementation prefers host-coherent memory. Either
+ * way, the implementation falls back to any host-visible memory.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] size
+ * Size in bytes.
+ *
+ * @param[in] usage
+ * Buffer usage.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pBuffer
+ * Buffer.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pBuffer` is non-`NULL` 
+ * - `pBuffer` is uninitialized
+ *
+ * @post
+ * - on success, `pBuffer` is properly initialized
+ * - on failure, `pBuffer` is nullified
+ *
+ * @note
+ * Since the memory may not be host-coherent, the client must 
+ * invalidate before reading and flush after writing, e.g., by 
+ * `vkxInvalidateMemoryViews` and `vkxFlushMemoryViews`, or in batches
+ * by `VkxMappedMemoryRangeBatch`.
+ *
+ * @note
+ * Destroy with `vkxDestroyBuffer`.
  */
-typedef struct VkxBufferGroup_
+VkResult vkxCreateStagingBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxBuffer* pBuffer);
+
+/**
+ * @brief Minimum staging pool block size in bytes (4 KiB).
+ */
+#define VKX_STAGING_POOL_MIN_BLOCK_SIZE ((VkDeviceSize)4096)
+
+/**
+ * @brief Staging block.
+ */
+typedef struct VkxStagingBlock_
 {
-    /**
-     * @brief Buffer count.
-     */
-    uint32_t bufferCount;
+    /** @brief Staging buffer, persistently mapped. */
+    VkxBuffer buffer;
 
-    /**
-     * @brief Buffers.
-     */
-    VkBuffer* pBuffers;
+    /** @brief Size in bytes, a power of 2. */
+    VkDeviceSize size;
 
-    /**
-     * @brief Shared memory.
+    /** @brief Buffer usage. */
+    VkBufferUsageFlags usage;
+
+    /** @brief Acquired? */
+    VkBool32 acquired;
+
+    /** 
+     * @brief Fence to wait for before reuse, or `VK_NULL_HANDLE`.
      */
-    VkxSharedDeviceMemory sharedMemory;
+    VkFence fence;
 }
-VkxBufferGroup;
+VkxStagingBlock;
 
 /**
- * @brief Create buffer group.
+ * @brief Staging pool.
+ *
+ * This structure keeps persistently mapped staging buffers in 
+ * power-of-2 size classes, so that repeated transfers recycle staging 
+ * buffers instead of allocating and freeing memory each time. A block
+ * released with a fence is only reacquired once the fence signals.
+ *
+ * @note
+ * The staging pool is not internally synchronized.
+ */
+typedef struct VkxStagingPool_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Memory type table. */
+    VkxMemoryTypeTable memoryTypeTable;
+
+    /** @brief Block count. */
+    uint32_t blockCount;
+
+    /** @brief Block capacity. */
+    uint32_t blockCapacity;
+
+    /** @brief Blocks. */
+    VkxStagingBlock** ppBlocks;
+}
+VkxStagingPool;
+
+/**
+ * @brief Import host buffer.
+ *
+ * Wraps `size` bytes of existing host memory at `pHostPointer` in a 
+ * buffer by `VK_EXT_external_memory_host`, so that copies and shader 
+ * reads come straight from host memory, without staging. The import 
+ * requires that the extension is enabled on `device`, and that both
+ * `pHostPointer` and `size` are multiples of 
+ * `minImportedHostPointerAlignment`, which is usually the page size,
+ * and that the buffer's memory requirements fit in `size` bytes.
+ *
+ * Otherwise, or if allocation or binding fails, the implementation 
+ * falls back to a staging buffer as by
+ * `vkxCreateStagingBuffer`, and copies the data into it. The client 
+ * can distinguish the two cases by `pBuffer->pMappedData`, which equals
+ * `pHostPointer` only if imported.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] physicalDevice
  * Physical device.
@@ -160,231 +284,1593 @@ VkxBufferGroup;
  * @param[in] device
  * Device.
  *
- * @param[in] bufferCount
- * Buffer count.
+ * @param[in] pHostPointer
+ * Host pointer.
  *
- * @param[in] pBufferCreateInfos
- * Buffer create infos.
+ * @param[in] size
+ * Size in bytes.
  *
- * @param[in] pMemoryPropertyFlags
- * Memory property flags per buffer.
+ * @param[in] usage
+ * Buffer usage.
  *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
- * @param[out] pBufferGroup
- * Buffer group.
+ * @param[out] pBuffer
+ * Buffer.
  *
  * @pre
- * - `physicalDevice` is valid
- * - `device` is valid
- * - `pBufferCreateInfos` points to `bufferCount` values
- * - `pMemoryPropertyFlags` points to `bufferCount` values
- * - `pBufferGroup` is non-`NULL` 
- * - `pBufferGroup` is uninitialized
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `physicalDevice` is the physical device of `device`
+ * - `pHostPointer` points to `size` bytes
+ * - `pBuffer` is non-`NULL` 
+ * - `pBuffer` is uninitialized
  *
  * @post
- * - on success, `pBufferGroup` is properly initialized
- * - on failure, `pBufferGroup` is nullified
+ * - on success, `pBuffer` is properly initialized
+ * - on failure, `pBuffer` is nullified
  *
  * @note
- * If `bufferCount` is `0`,
- * `pBufferCreateInfos` may be `NULL`,
- * `pMemoryPropertyFlags` may be `NULL`,
- * `pBufferGroup` is nullified, and result is `VK_SUCCESS`.
+ * If imported, the host memory must remain valid, e.g., remain mapped
+ * if memory-mapped from a file, until `pBuffer` is destroyed. Host 
+ * writes to imported memory after device reads begin are not 
+ * synchronized.
+ *
+ * @note
+ * Destroy with `vkxDestroyBuffer`, which does not free the host memory.
  */
-VkResult vkxCreateBufferGroup(
+VkResult vkxImportHostBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkPhysicalDevice physicalDevice,
             VkDevice device,
-            uint32_t bufferCount,
-            const VkBufferCreateInfo* pBufferCreateInfos,
-            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            void* pHostPointer,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
             const VkAllocationCallbacks* pAllocator,
-            VkxBufferGroup* pBufferGroup);
+            VkxBuffer* pBuffer);
 
 /**
- * @brief Destroy buffer group.
+ * @brief Create staging pool.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
  *
- * @param[inout] pBufferGroup
- * Buffer group.
- *
- * @param[in] pAllocator
- * _Optional_. Allocation callbacks.
+ * @param[out] pStagingPool
+ * Staging pool.
  *
  * @pre
- * - `device` was used to create `pBufferGroup`
- * - `pAllocator` was used to create `pBufferGroup`
- * - `pBufferGroup` was previously created by `vkxCreateBufferGroup`
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pStagingPool` is non-`NULL`
+ * - `pStagingPool` is uninitialized
  *
  * @post
- * - `pBufferGroup` is nullified
+ * - `pStagingPool` is properly initialized
  *
  * @note
- * Does nothing if `pBufferGroup` is `NULL`.
+ * No staging buffer is created until the first call to
+ * `vkxStagingPoolAcquire`.
  */
-void vkxDestroyBufferGroup(
+void vkxCreateStagingPool(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
-            VkxBufferGroup* pBufferGroup,
-            const VkAllocationCallbacks* pAllocator);
+            VkxStagingPool* pStagingPool);
 
 /**
- * @brief Copy buffer.
+ * @brief Destroy staging pool.
  *
- * @param[in] device
- * Device.
+ * @param[inout] pStagingPool
+ * Staging pool.
  *
- * @param[in] queue
- * Queue.
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
  *
- * @param[in] commandPool
- * Command pool.
+ * @pre
+ * - `pAllocator` was used to acquire every block in `pStagingPool`
+ * - the device no longer accesses any block in `pStagingPool`
  *
- * @param[in] srcBuffer
- * Source buffer.
+ * @post
+ * - `pStagingPool` is nullified
  *
- * @param[in] dstBuffer
- * Destination buffer.
+ * @note
+ * Does nothing if `pStagingPool` is `NULL`.
+ */
+void vkxDestroyStagingPool(
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Acquire staging block from staging pool.
  *
- * @param[in] regionCount
- * Region count.
+ * Rounds `size` up to a power of 2, no less than 
+ * `VKX_STAGING_POOL_MIN_BLOCK_SIZE`, and returns a free block of that
+ * size class and usage whose fence, if any, has signaled. If there is
+ * none, creates one by `vkxCreateStagingBuffer`.
  *
- * @param[in] pRegions
- * Regions.
+ * @param[inout] pStagingPool
+ * Staging pool.
+ *
+ * @param[in] size
+ * Size in bytes.
+ *
+ * @param[in] usage
+ * Buffer usage, as for `vkxCreateStagingBuffer`.
  *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
+ * @param[out] ppBlock
+ * Staging block.
+ *
  * @pre
- * - all Vulkan handles are valid
- * - `queue` is compatible with `commandPool`
- * - `srcBuffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
- * - `dstBuffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
- * - `pRegions` points to `regionCount` values
- * - `pRegions` is `NULL` only if `regionCount` is `0`, in which case
- * the implementation immediately returns `VK_SUCCESS`
+ * - `pStagingPool` is non-`NULL`
+ * - `ppBlock` is non-`NULL`
+ *
+ * @post
+ * - on success, `*ppBlock` is acquired, and remains valid until the 
+ * staging pool is destroyed
+ * - on failure, `*ppBlock` is `NULL`
  */
-VkResult vkxCopyBuffer(
-            VkDevice device,
-            VkQueue queue,
-            VkCommandPool commandPool,
-            VkBuffer srcBuffer,
-            VkBuffer dstBuffer,
-            uint32_t regionCount,
-            const VkBufferCopy* pRegions,
-            const VkAllocationCallbacks* pAllocator);
+VkResult vkxStagingPoolAcquire(
+            VkxStagingPool* pStagingPool,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxStagingBlock** ppBlock);
 
 /**
- * @brief Buffer data access.
+ * @brief Release staging block to staging pool.
+ *
+ * @param[inout] pStagingPool
+ * Staging pool.
+ *
+ * @param[inout] pBlock
+ * Staging block.
+ *
+ * @param[in] fence
+ * Fence which signals once the device no longer accesses the block, 
+ * or `VK_NULL_HANDLE` if the device already does not.
+ *
+ * @pre
+ * - `pBlock` was acquired from `pStagingPool`
+ * - `fence` is not destroyed or reset before it signals and 
+ * `pBlock` is reacquired, or the pool is destroyed
+ *
+ * @note
+ * The staging pool does not take ownership of `fence`.
  */
-typedef struct VkxBufferDataAccess_
-{
-    /**
-     * @brief Offset in bytes.
-     */
-    VkDeviceSize offset;
-
-    /**
-     * @brief Size in bytes.
-     */
-    VkDeviceSize size;
-}
-VkxBufferDataAccess;
+void vkxStagingPoolRelease(
+            VkxStagingPool* pStagingPool,
+            VkxStagingBlock* pBlock,
+            VkFence fence);
 
 /**
- * @brief Get buffer data via temporary staging buffer.
+ * @brief Acquire staging buffer.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If `pStagingPool` is non-`NULL`, acquires a block from the staging 
+ * pool, otherwise creates a staging buffer by `vkxCreateStagingBuffer`.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
  *
- * @param[in] queue
- * Queue.
- *
- * @param[in] commandPool
- * Command pool.
+ * @param[in] size
+ * Size in bytes.
  *
- * @param[in] buffer
- * Buffer.
+ * @param[in] usage
+ * Buffer usage, as for `vkxCreateStagingBuffer`.
  *
- * @param[in] pBufferDataAccess
- * Buffer data access.
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
  *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
- * @param[out] pData
- * Data.
+ * @param[out] ppStagingBlock
+ * Staging block, or `NULL` if not acquired from a staging pool.
+ *
+ * @param[out] pStagingBuffer
+ * Staging buffer, at least `size` bytes.
  *
  * @pre
- * - all Vulkan handles are valid
- * - `queue` is compatible with `commandPool`
- * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
- * - `pBufferDataAccess` is non-`NULL`
- * - `pData` points to `pBufferDataAccess->size` bytes
- * - `pData` is `NULL` only if `pBufferDataAccess->size` is `0`, in which case 
- * the implementation immediately returns `VK_SUCCESS`
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `ppStagingBlock` is non-`NULL`
+ * - `pStagingBuffer` is non-`NULL`
+ *
+ * @post
+ * - on failure, `*ppStagingBlock` is `NULL`, and `pStagingBuffer` is 
+ * nullified
+ *
+ * @note
+ * Release with `vkxReleaseStagingBuffer`.
  */
-VkResult vkxGetBufferData(
-            VkPhysicalDevice physicalDevice,
+VkResult vkxAcquireStagingBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
-            VkQueue queue,
-            VkCommandPool commandPool,
-            VkBuffer buffer,
-            const VkxBufferDataAccess* pBufferDataAccess,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator,
-            void* pData);
+            VkxStagingBlock** ppStagingBlock,
+            VkxBuffer* pStagingBuffer);
 
 /**
- * @brief Set buffer data via temporary staging buffer.
+ * @brief Release staging buffer.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If `pStagingBlock` is non-`NULL`, releases it to the staging pool
+ * with no fence, otherwise destroys the staging buffer.
  *
  * @param[in] device
  * Device.
  *
- * @param[in] queue
- * Queue.
- *
- * @param[in] commandPool
- * Command pool.
- *
- * @param[in] buffer
- * Buffer.
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
  *
- * @param[in] pBufferDataAccess
- * Buffer data access.
+ * @param[inout] pStagingBlock
+ * _Optional_. Staging block.
  *
- * @param[in] pData
- * Data.
+ * @param[inout] pStagingBuffer
+ * Staging buffer.
  *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
  * @pre
- * - all Vulkan handles are valid
- * - `queue` is compatible with `commandPool`
- * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
- * - `pBufferDataAccess` is non-`NULL`
- * - `pData` points to `pBufferDataAccess->size` bytes
- * - `pData` is `NULL` only if `pBufferDataAccess->size` is `0`, in which case 
- * the implementation immediately returns `VK_SUCCESS`
+ * - `pStagingPool`, `pStagingBlock`, and `pStagingBuffer` were 
+ * acquired by `vkxAcquireStagingBuffer`
+ * - the device no longer accesses the staging buffer
  */
-VkResult vkxSetBufferData(
-            VkPhysicalDevice physicalDevice,
+void vkxReleaseStagingBuffer(
             VkDevice device,
-            VkQueue queue,
-            VkCommandPool commandPool,
-            VkBuffer buffer,
-            const VkxBufferDataAccess* pBufferDataAccess,
-            const void* pData,
+            VkxStagingPool* pStagingPool,
+            VkxStagingBlock* pStagingBlock,
+            VkxBuffer* pStagingBuffer,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Transfer ticket.
+ *
+ * This structure represents one submitted command buffer, along with 
+ * the resources which must outlive its execution. Completion is signaled
+ * either by a fence owned by the ticket, or by a value of a timeline
+ * semaphore owned by the client. The command buffer and any staging 
+ * buffer are only released by `vkxDestroyTransferTicket`, so the host 
+ * may continue recording while the device executes.
+ */
+typedef struct VkxTransferTicket_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Command pool. */
+    VkCommandPool commandPool;
+
+    /** @brief Command buffer. */
+    VkCommandBuffer commandBuffer;
+
+    /** @brief Fence, or `VK_NULL_HANDLE` if signaling timeline. */
+    VkFence fence;
+
+    /** 
+     * @brief _Optional_. Fence pool, which the client may set between 
+     * begin and submit, to acquire the fence from instead of creating it.
+     */
+    VkxFencePool* pFencePool;
+
+    /** @brief Timeline semaphore, or `VK_NULL_HANDLE` if signaling fence. */
+    VkSemaphore timelineSemaphore;
+
+    /** @brief Timeline value. */
+    uint64_t timelineValue;
+
+    /** @brief _Optional_. Staging pool of staging buffer. */
+    VkxStagingPool* pStagingPool;
+
+    /** @brief _Optional_. Staging block of staging buffer. */
+    VkxStagingBlock* pStagingBlock;
+
+    /** @brief _Optional_. Staging buffer, or nullified. */
+    VkxBuffer stagingBuffer;
+}
+VkxTransferTicket;
+
+/**
+ * @brief Begin transfer ticket.
+ *
+ * Allocates a primary command buffer from `commandPool` and begins it
+ * for one-time submission.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[out] pTicket
+ * Transfer ticket, whose command buffer is in the recording state.
+ *
+ * @pre
+ * - `device` is valid
+ * - `commandPool` is valid
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxBeginTransferTicket(
+            VkDevice device,
+            VkCommandPool commandPool,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Submit transfer ticket.
+ *
+ * Ends the command buffer and submits it to `queue`, signaling 
+ * `timelineValue` on `timelineSemaphore` if non-`VK_NULL_HANDLE`, 
+ * otherwise signaling a fence owned by the ticket, acquired from the
+ * fence pool of the ticket if any.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore.
+ *
+ * @param[in] timelineValue
+ * Timeline value, ignored if `timelineSemaphore` is `VK_NULL_HANDLE`.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[inout] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - `queue` is compatible with the command pool of `pTicket`
+ * - `pTicket` was previously begun by `vkxBeginTransferTicket`
+ *
+ * @post
+ * - on failure, `pTicket` is destroyed
+ */
+VkResult vkxSubmitTransferTicket(
+            VkQueue queue,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Submit transfer ticket with semaphores.
+ *
+ * Like `vkxSubmitTransferTicket`, additionally waiting on and signaling
+ * binary semaphores, e.g., to order a queue family ownership release 
+ * before the matching acquire on another queue.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] waitSemaphoreCount
+ * Wait semaphore count.
+ *
+ * @param[in] pWaitSemaphores
+ * Wait semaphores.
+ *
+ * @param[in] pWaitDstStageMasks
+ * Wait destination stage masks.
+ *
+ * @param[in] signalSemaphoreCount
+ * Signal semaphore count.
+ *
+ * @param[in] pSignalSemaphores
+ * Signal semaphores.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore.
+ *
+ * @param[in] timelineValue
+ * Timeline value, ignored if `timelineSemaphore` is `VK_NULL_HANDLE`.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[inout] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - `pWaitSemaphores` and `pSignalSemaphores` are binary semaphores
+ * - otherwise same as `vkxSubmitTransferTicket`
+ *
+ * @post
+ * - on failure, `pTicket` is destroyed
+ */
+VkResult vkxSubmitTransferTicketWithSemaphores(
+            VkQueue queue,
+            uint32_t waitSemaphoreCount,
+            const VkSemaphore* pWaitSemaphores,
+            const VkPipelineStageFlags* pWaitDstStageMasks,
+            uint32_t signalSemaphoreCount,
+            const VkSemaphore* pSignalSemaphores,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Get transfer ticket status.
+ *
+ * @param[in] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - `pTicket` is non-`NULL`
+ *
+ * @return
+ * `VK_SUCCESS` if complete, `VK_NOT_READY` if still executing, or an
+ * error code, e.g., `VK_ERROR_DEVICE_LOST`.
+ *
+ * @note
+ * Does not block. A ticket with nothing submitted is complete.
+ */
+VkResult vkxGetTransferTicketStatus(
+            const VkxTransferTicket* pTicket);
+
+/**
+ * @brief Wait for transfer ticket.
+ *
+ * @param[in] pTicket
+ * Transfer ticket.
+ *
+ * @param[in] timeout
+ * Timeout in nanoseconds.
+ *
+ * @pre
+ * - `pTicket` is non-`NULL`
+ *
+ * @return
+ * `VK_SUCCESS` if complete, `VK_TIMEOUT` if not complete in time, or
+ * an error code.
+ */
+VkResult vkxWaitTransferTicket(
+            const VkxTransferTicket* pTicket,
+            uint64_t timeout);
+
+/**
+ * @brief Destroy transfer ticket.
+ *
+ * Waits for completion if necessary, then frees the command buffer, 
+ * destroys the fence, and releases the staging buffer.
+ *
+ * @param[inout] pTicket
+ * Transfer ticket.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @post
+ * - `pTicket` is nullified
+ *
+ * @note
+ * Does nothing if `pTicket` is `NULL`. To avoid blocking, destroy 
+ * tickets once `vkxGetTransferTicketStatus` returns `VK_SUCCESS`.
+ */
+void vkxDestroyTransferTicket(
+            VkxTransferTicket* pTicket,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Allocated buffer.
+ *
+ * This structure is like `VkxBuffer`, except that its memory is 
+ * a sub-range of a `VkxAllocator` block rather than a dedicated
+ * `VkDeviceMemory` allocation.
+ */
+typedef struct VkxAllocatedBuffer_
+{
+    /**
+     * @brief Buffer.
+     */
+    VkBuffer buffer;
+
+    /**
+     * @brief Allocation.
+     */
+    VkxAllocation allocation;
+
+    /**
+     * @brief Persistently mapped data, or `NULL` if not host-visible.
+     *
+     * Mapped by `vkxAllocatorMapMemory`, so buffers sharing a block 
+     * share one mapping.
+     */
+    void* pMappedData;
+}
+VkxAllocatedBuffer;
+
+/**
+ * @brief Create buffer with memory from allocator.
+ *
+ * If `memoryPropertyFlags` includes `VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT`,
+ * the memory is persistently mapped as with `vkxCreateBuffer`. If the
+ * implementation prefers or requires a dedicated allocation, the memory
+ * is allocated by `vkxAllocatorAllocateDedicatedMemory`.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pBufferCreateInfo
+ * Buffer create info.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pBuffer
+ * Buffer.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pBufferCreateInfo` is non-`NULL`
+ * - `pBuffer` is non-`NULL` 
+ * - `pBuffer` is uninitialized
+ *
+ * @post
+ * - on success, `pBuffer` is properly initialized
+ * - on failure, `pBuffer` is nullified
+ */
+VkResult vkxCreateAllocatedBuffer(
+            VkxAllocator* pMemoryAllocator,
+            const VkBufferCreateInfo* pBufferCreateInfo,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocatedBuffer* pBuffer);
+
+/**
+ * @brief Destroy buffer with memory from allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[inout] pBuffer
+ * Buffer.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pMemoryAllocator` was used to create `pBuffer`
+ * - `pAllocator` was used to create `pBuffer`
+ * - `pBuffer` was previously created by `vkxCreateAllocatedBuffer`
+ *
+ * @post
+ * - `pBuffer` is nullified
+ *
+ * @note
+ * Does nothing if `pBuffer` is `NULL`.
+ */
+void vkxDestroyAllocatedBuffer(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedBuffer* pBuffer,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Buffer group.
+ */
+typedef struct VkxBufferGroup_
+{
+    /**
+     * @brief Buffer count.
+     */
+    uint32_t bufferCount;
+
+    /**
+     * @brief Buffers.
+     */
+    VkBuffer* pBuffers;
+
+    /**
+     * @brief Shared memory.
+     */
+    VkxSharedDeviceMemory sharedMemory;
+}
+VkxBufferGroup;
+
+/**
+ * @brief Create buffer group.
+ *
+ * Buffers for which the implementation prefers or requires a dedicated
+ * allocation get their own dedicated memory, and all other buffers are
+ * packed into shared memory.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] bufferCount
+ * Buffer count.
+ *
+ * @param[in] pBufferCreateInfos
+ * Buffer create infos.
+ *
+ * @param[in] pMemoryPropertyFlags
+ * Memory property flags per buffer.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pBufferGroup
+ * Buffer group.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pBufferCreateInfos` points to `bufferCount` values
+ * - `pMemoryPropertyFlags` points to `bufferCount` values
+ * - `pBufferGroup` is non-`NULL` 
+ * - `pBufferGroup` is uninitialized
+ *
+ * @post
+ * - on success, `pBufferGroup` is properly initialized
+ * - on failure, `pBufferGroup` is nullified
+ *
+ * @note
+ * If `bufferCount` is `0`,
+ * `pBufferCreateInfos` may be `NULL`,
+ * `pMemoryPropertyFlags` may be `NULL`,
+ * `pBufferGroup` is nullified, and result is `VK_SUCCESS`.
+ */
+VkResult vkxCreateBufferGroup(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t bufferCount,
+            const VkBufferCreateInfo* pBufferCreateInfos,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxBufferGroup* pBufferGroup);
+
+/**
+ * @brief Destroy buffer group.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[inout] pBufferGroup
+ * Buffer group.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `device` was used to create `pBufferGroup`
+ * - `pAllocator` was used to create `pBufferGroup`
+ * - `pBufferGroup` was previously created by `vkxCreateBufferGroup`
+ *
+ * @post
+ * - `pBufferGroup` is nullified
+ *
+ * @note
+ * Does nothing if `pBufferGroup` is `NULL`.
+ */
+void vkxDestroyBufferGroup(
+            VkDevice device,
+            VkxBufferGroup* pBufferGroup,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Copy coalescing statistics.
+ *
+ * Counters are accumulated, so the client may share one structure 
+ * across many calls, and reset it by zeroing it.
+ */
+typedef struct VkxCopyCoalesceStats_
+{
+    /** @brief Regions passed in. */
+    uint64_t inputRegionCount;
+
+    /** @brief Regions recorded. */
+    uint64_t outputRegionCount;
+
+    /** @brief Bytes copied in gaps between merged regions. */
+    VkDeviceSize wastedBytes;
+}
+VkxCopyCoalesceStats;
+
+/**
+ * @brief Record buffer copy, coalescing regions.
+ *
+ * Sorts regions by source offset, then merges each region with the 
+ * next if both the source and destination gaps between them are equal
+ * and no greater than `maxWastedBytes`, so that many small copies 
+ * become a few large ones.
+ *
+ * @param[in] commandBuffer
+ * Command buffer.
+ *
+ * @param[in] srcBuffer
+ * Source buffer.
+ *
+ * @param[in] dstBuffer
+ * Destination buffer.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[in] maxWastedBytes
+ * Maximum gap in bytes to copy when merging, or `0` to merge only
+ * contiguous regions.
+ *
+ * @param[inout] pStats
+ * _Optional_. Statistics to accumulate.
+ *
+ * @pre
+ * - `commandBuffer` is in the recording state
+ * - `srcBuffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
+ * - `dstBuffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ * - `pRegions` points to `regionCount` values
+ * - `pRegions` is `NULL` only if `regionCount` is `0`
+ *
+ * @note
+ * Gaps merged into a copy are overwritten in `dstBuffer` with the 
+ * corresponding bytes of `srcBuffer`. A non-zero `maxWastedBytes` is
+ * thus appropriate only if those bytes are unused, or if `srcBuffer` 
+ * mirrors `dstBuffer`, and if no other region writes to them.
+ */
+void vkxCmdCopyBufferCoalesced(
+            VkCommandBuffer commandBuffer,
+            VkBuffer srcBuffer,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferCopy* pRegions,
+            VkDeviceSize maxWastedBytes,
+            VkxCopyCoalesceStats* pStats);
+
+/**
+ * @brief Copy buffer.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] srcBuffer
+ * Source buffer.
+ *
+ * @param[in] dstBuffer
+ * Destination buffer.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `srcBuffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
+ * - `dstBuffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ * - `pRegions` points to `regionCount` values
+ * - `pRegions` is `NULL` only if `regionCount` is `0`, in which case
+ * the implementation immediately returns `VK_SUCCESS`
+ *
+ * @note
+ * The implementation merges contiguous regions, as if by 
+ * `vkxCmdCopyBufferCoalesced` with `maxWastedBytes` of `0`.
+ */
+VkResult vkxCopyBuffer(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer srcBuffer,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferCopy* pRegions,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Copy buffer asynchronously.
+ *
+ * Like `vkxCopyBuffer`, except returns once submitted.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] srcBuffer
+ * Source buffer.
+ *
+ * @param[in] dstBuffer
+ * Destination buffer.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxCopyBuffer`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized, and complete if
+ * there was nothing to copy
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxCopyBufferAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer srcBuffer,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Buffer data access.
+ */
+typedef struct VkxBufferDataAccess_
+{
+    /**
+     * @brief Offset in bytes.
+     */
+    VkDeviceSize offset;
+
+    /**
+     * @brief Size in bytes.
+     */
+    VkDeviceSize size;
+}
+VkxBufferDataAccess;
+
+/**
+ * @brief Get buffer data via temporary staging buffer.
+ *
+ * If `pStagingPool` is non-`NULL`, the staging buffer is acquired 
+ * from and released to the pool, so repeated transfers allocate nothing.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] pBufferDataAccess
+ * Buffer data access.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pData
+ * Data.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
+ * - `pBufferDataAccess` is non-`NULL`
+ * - `pData` points to `pBufferDataAccess->size` bytes
+ * - `pData` is `NULL` only if `pBufferDataAccess->size` is `0`, in which case 
+ * the implementation immediately returns `VK_SUCCESS`
+ */
+VkResult vkxGetBufferData(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator,
+            void* pData);
+
+/**
+ * @brief Set buffer data via temporary staging buffer.
+ *
+ * If `pStagingPool` is non-`NULL`, the staging buffer is acquired 
+ * from and released to the pool, so repeated transfers allocate nothing.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] pBufferDataAccess
+ * Buffer data access.
+ *
+ * @param[in] pData
+ * Data.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ * - `pBufferDataAccess` is non-`NULL`
+ * - `pData` points to `pBufferDataAccess->size` bytes
+ * - `pData` is `NULL` only if `pBufferDataAccess->size` is `0`, in which case 
+ * the implementation immediately returns `VK_SUCCESS`
+ */
+VkResult vkxSetBufferData(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            const void* pData,
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Set buffer data asynchronously.
+ *
+ * Like `vkxSetBufferData`, except returns once submitted. The staging
+ * buffer is held by the ticket, and released when the ticket is 
+ * destroyed. Since `pData` is copied before returning, the client may
+ * reuse it immediately.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] pBufferDataAccess
+ * Buffer data access.
+ *
+ * @param[in] pData
+ * Data.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxSetBufferData`
+ * - `pStagingPool`, if non-`NULL`, outlives `pTicket`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxSetBufferDataAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            const void* pData,
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Frame allocator.
+ *
+ * This structure holds one persistently mapped, host-visible and 
+ * host-coherent buffer split into `frameCount` equally sized slices, one 
+ * per frame in flight. Allocation within a frame is a bump of an 
+ * offset, so transient per-frame data (uniforms, dynamic vertices, 
+ * upload sources) costs no driver calls and no `malloc`. A slice is 
+ * recycled as a whole once the fence associated with its frame signals.
+ */
+typedef struct VkxFrameAllocator_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Buffer. */
+    VkxBuffer buffer;
+
+    /** @brief Mapped buffer data. */
+    void* pMappedData;
+
+    /** @brief Frame slice size in bytes. */
+    VkDeviceSize frameSize;
+
+    /** @brief Frame count. */
+    uint32_t frameCount;
+
+    /** @brief Current frame index. */
+    uint32_t frameIndex;
+
+    /** @brief Current offset in bytes, relative to current frame slice. */
+    VkDeviceSize frameOffset;
+
+    /** @brief Fences for each frame, or `VK_NULL_HANDLE`. */
+    VkFence* pFences;
+}
+VkxFrameAllocator;
+
+/**
+ * @brief Frame allocation.
+ */
+typedef struct VkxFrameAllocation_
+{
+    /** @brief Buffer. */
+    VkBuffer buffer;
+
+    /** @brief Offset in bytes, relative to buffer. */
+    VkDeviceSize offset;
+
+    /** @brief Size in bytes. */
+    VkDeviceSize size;
+
+    /** @brief Mapped data, to write directly. */
+    void* pData;
+}
+VkxFrameAllocation;
+
+/**
+ * @brief Create frame allocator.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] frameSize
+ * Frame slice size in bytes.
+ *
+ * @param[in] frameCount
+ * Frame count, usually the number of frames in flight.
+ *
+ * @param[in] usage
+ * Buffer usage flags.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pFrameAllocator
+ * Frame allocator.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `frameCount` is non-zero
+ * - `pFrameAllocator` is non-`NULL`
+ * - `pFrameAllocator` is uninitialized
+ *
+ * @post
+ * - on success, `pFrameAllocator` is properly initialized
+ * - on failure, `pFrameAllocator` is nullified
+ *
+ * @note
+ * The implementation rounds `frameSize` up to a multiple of 256 bytes,
+ * the largest offset alignment the specification permits for uniform 
+ * and storage buffers, so that every slice begins suitably aligned.
+ */
+VkResult vkxCreateFrameAllocator(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize frameSize,
+            uint32_t frameCount,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxFrameAllocator* pFrameAllocator);
+
+/**
+ * @brief Destroy frame allocator.
+ *
+ * @param[inout] pFrameAllocator
+ * Frame allocator.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to create `pFrameAllocator`
+ * - the device no longer accesses the buffer of `pFrameAllocator`
+ *
+ * @post
+ * - `pFrameAllocator` is nullified
+ *
+ * @note
+ * Does nothing if `pFrameAllocator` is `NULL`.
+ */
+void vkxDestroyFrameAllocator(
+            VkxFrameAllocator* pFrameAllocator,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Begin frame.
+ *
+ * Advances to the next frame slice. If a fence was associated with 
+ * that slice by `vkxFrameAllocatorEndFrame`, waits for the fence 
+ * before recycling the slice.
+ *
+ * @param[inout] pFrameAllocator
+ * Frame allocator.
+ *
+ * @param[in] timeout
+ * Timeout in nanoseconds.
+ *
+ * @pre
+ * - `pFrameAllocator` is non-`NULL`
+ * - the fence associated with the next slice, if any, has not been
+ * reset since it was submitted
+ *
+ * @return
+ * `VK_TIMEOUT` if the fence did not signal in time, in which case the 
+ * current frame does not change.
+ */
+VkResult vkxFrameAllocatorBeginFrame(
+            VkxFrameAllocator* pFrameAllocator,
+            uint64_t timeout);
+
+/**
+ * @brief End frame.
+ *
+ * @param[inout] pFrameAllocator
+ * Frame allocator.
+ *
+ * @param[in] fence
+ * Fence which signals once the device no longer accesses allocations
+ * made in the current frame, or `VK_NULL_HANDLE`.
+ *
+ * @note
+ * The frame allocator does not take ownership of `fence`.
+ */
+void vkxFrameAllocatorEndFrame(
+            VkxFrameAllocator* pFrameAllocator,
+            VkFence fence);
+
+/**
+ * @brief Allocate from current frame.
+ *
+ * @param[inout] pFrameAllocator
+ * Frame allocator.
+ *
+ * @param[in] size
+ * Size in bytes.
+ *
+ * @param[in] alignment
+ * Alignment in bytes, or `0` for no alignment.
+ *
+ * @param[out] pAllocation
+ * Frame allocation.
+ *
+ * @pre
+ * - `pFrameAllocator` is non-`NULL`
+ * - `alignment` is `0` or a power of 2 no greater than 256
+ * - `pAllocation` is non-`NULL`
+ *
+ * @return
+ * `VK_ERROR_OUT_OF_DEVICE_MEMORY` if the current frame slice is 
+ * exhausted, in which case `pAllocation` is nullified.
+ */
+VkResult vkxFrameAllocatorAllocate(
+            VkxFrameAllocator* pFrameAllocator,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            VkxFrameAllocation* pAllocation);
+
+/**
+ * @brief Readback ring.
+ *
+ * This structure holds one persistently mapped, host-visible and,
+ * preferably, host-cached buffer split into `frameCount` equally sized
+ * slices, one per frame in flight. Copies to host are recorded into
+ * the frame's own command buffer, and results are collected some
+ * frames later, once the fence associated with the frame signals, so
+ * readback never drains the queue.
+ */
+typedef struct VkxReadbackRing_
+{
+    /** @brief Memory type table. */
+    VkxMemoryTypeTable memoryTypeTable;
+
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Buffer. */
+    VkxBuffer buffer;
+
+    /** @brief Frame slice size in bytes. */
+    VkDeviceSize frameSize;
+
+    /** @brief Frame count. */
+    uint32_t frameCount;
+
+    /** @brief Current frame index. */
+    uint32_t frameIndex;
+
+    /** @brief Current frame number, counting from `0`. */
+    uint64_t frameNumber;
+
+    /** @brief Current offset in bytes, relative to current frame slice. */
+    VkDeviceSize frameOffset;
+
+    /** @brief Fences for each frame, or `VK_NULL_HANDLE`. */
+    VkFence* pFences;
+}
+VkxReadbackRing;
+
+/**
+ * @brief Readback region.
+ */
+typedef struct VkxReadbackRegion_
+{
+    /** @brief Frame number the region was recorded in. */
+    uint64_t frameNumber;
+
+    /** @brief Offset in bytes, relative to buffer. */
+    VkDeviceSize offset;
+
+    /** @brief Size in bytes. */
+    VkDeviceSize size;
+}
+VkxReadbackRegion;
+
+/**
+ * @brief Create readback ring.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] frameSize
+ * Frame slice size in bytes.
+ *
+ * @param[in] frameCount
+ * Frame count, usually the number of frames in flight.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pReadbackRing
+ * Readback ring.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `frameCount` is non-zero
+ * - `pReadbackRing` is non-`NULL`
+ * - `pReadbackRing` is uninitialized
+ *
+ * @post
+ * - on success, `pReadbackRing` is properly initialized
+ * - on failure, `pReadbackRing` is nullified
+ *
+ * @note
+ * The implementation rounds `frameSize` up to a multiple of 256 bytes.
+ */
+VkResult vkxCreateReadbackRing(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize frameSize,
+            uint32_t frameCount,
+            const VkAllocationCallbacks* pAllocator,
+            VkxReadbackRing* pReadbackRing);
+
+/**
+ * @brief Destroy readback ring.
+ *
+ * @param[inout] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to create `pReadbackRing`
+ * - the device no longer accesses the buffer of `pReadbackRing`
+ *
+ * @post
+ * - `pReadbackRing` is nullified
+ *
+ * @note
+ * Does nothing if `pReadbackRing` is `NULL`.
+ */
+void vkxDestroyReadbackRing(
+            VkxReadbackRing* pReadbackRing,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Begin frame.
+ *
+ * Advances to the next frame slice. If a fence was associated with 
+ * that slice by `vkxReadbackRingEndFrame`, waits for the fence 
+ * before recycling the slice. Regions recorded `frameCount` frames 
+ * ago are invalidated.
+ *
+ * @param[inout] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] timeout
+ * Timeout in nanoseconds.
+ *
+ * @pre
+ * - `pReadbackRing` is non-`NULL`
+ * - the fence associated with the next slice, if any, has not been
+ * reset since it was submitted
+ *
+ * @return
+ * `VK_TIMEOUT` if the fence did not signal in time, in which case the 
+ * current frame does not change.
+ *
+ * @note
+ * With the frame's own fences, which the application waits on 
+ * anyway to reuse per-frame command buffers, the wait here returns
+ * immediately.
+ */
+VkResult vkxReadbackRingBeginFrame(
+            VkxReadbackRing* pReadbackRing,
+            uint64_t timeout);
+
+/**
+ * @brief End frame.
+ *
+ * Records a barrier which makes the copies recorded in the current 
+ * frame visible to the host.
+ *
+ * @param[inout] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] commandBuffer
+ * Command buffer, after all copies recorded in the current frame.
+ *
+ * @param[in] fence
+ * Fence which signals once `commandBuffer` completes.
+ *
+ * @pre
+ * - `pReadbackRing` is non-`NULL`
+ * - `commandBuffer` is in the recording state
+ * - `fence` is valid
+ *
+ * @note
+ * The readback ring does not take ownership of `fence`.
+ */
+void vkxReadbackRingEndFrame(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkFence fence);
+
+/**
+ * @brief Record buffer copy into current frame.
+ *
+ * @param[inout] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] commandBuffer
+ * Command buffer.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] pBufferDataAccess
+ * Buffer data access.
+ *
+ * @param[out] pRegion
+ * Readback region.
+ *
+ * @pre
+ * - `pReadbackRing` is non-`NULL`
+ * - `commandBuffer` is in the recording state
+ * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_SRC_BIT`
+ * - `pBufferDataAccess` is non-`NULL`
+ * - `pRegion` is non-`NULL`
+ *
+ * @return
+ * `VK_ERROR_OUT_OF_DEVICE_MEMORY` if the current frame slice is
+ * exhausted, in which case nothing is recorded and `pRegion` is 
+ * nullified.
+ *
+ * @note
+ * The caller is responsible for any barrier between prior writes to 
+ * `buffer` and the copy.
+ */
+VkResult vkxReadbackRingCmdCopyBuffer(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            VkxReadbackRegion* pRegion);
+
+/**
+ * @brief Record image copy into current frame.
+ *
+ * @param[inout] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] commandBuffer
+ * Command buffer.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] imageLayout
+ * Image layout, `VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL`, 
+ * `VK_IMAGE_LAYOUT_GENERAL`, or `VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR`.
+ *
+ * @param[in] texelSize
+ * Texel size in bytes.
+ *
+ * @param[in] subresourceLayers
+ * Image subresource layers.
+ *
+ * @param[in] offset
+ * Image offset.
+ *
+ * @param[in] extent
+ * Image extent.
+ *
+ * @param[in] size
+ * Size in bytes, tightly packed.
+ *
+ * @param[out] pRegion
+ * Readback region.
+ *
+ * @pre
+ * - `pReadbackRing` is non-`NULL`
+ * - `commandBuffer` is in the recording state
+ * - `image` supports `VK_IMAGE_USAGE_TRANSFER_SRC_BIT`
+ * - the image format is uncompressed, with texels of `texelSize` bytes
+ * - `pRegion` is non-`NULL`
+ *
+ * @return
+ * `VK_ERROR_OUT_OF_DEVICE_MEMORY` if the current frame slice is
+ * exhausted, in which case nothing is recorded and `pRegion` is 
+ * nullified.
+ *
+ * @note
+ * The region offset is aligned to the least common multiple of 
+ * `texelSize` and 4, as `vkCmdCopyImageToBuffer` requires.
+ *
+ * @note
+ * The caller is responsible for any barrier between prior writes to 
+ * `image` and the copy.
+ */
+VkResult vkxReadbackRingCmdCopyImage(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            VkImageSubresourceLayers subresourceLayers,
+            VkOffset3D offset,
+            VkExtent3D extent,
+            VkDeviceSize size,
+            VkxReadbackRegion* pRegion);
+
+/**
+ * @brief Get readback region data, without waiting.
+ *
+ * @param[in] pReadbackRing
+ * Readback ring.
+ *
+ * @param[in] pRegion
+ * Readback region.
+ *
+ * @param[out] ppData
+ * Mapped region data, valid until the slice is recycled by
+ * `vkxReadbackRingBeginFrame`.
+ *
+ * @pre
+ * - `pReadbackRing` is non-`NULL`
+ * - `pRegion` is non-`NULL`, and was recorded by `pReadbackRing` in 
+ * one of the last `frameCount` frames
+ * - `ppData` is non-`NULL`
+ *
+ * @return
+ * - `VK_NOT_READY` if the frame has not ended, or its fence has not
+ * signaled, in which case `*ppData` is `NULL`
+ * - `VK_SUCCESS` otherwise
+ */
+VkResult vkxReadbackRingGetData(
+            const VkxReadbackRing* pReadbackRing,
+            const VkxReadbackRegion* pRegion,
+            const void** ppData);
+
 /**@}*/
 
 #ifdef __cplusplus
@@ -131,6 +131,804 @@ void vkxDestroySemaphores(
             VkSemaphore* pSemaphores,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Sync object pool chunk size.
+ *
+ * Empty pools grow by creating this many objects at once.
+ */
+#define VKX_SYNC_POOL_CHUNK_SIZE 8
+
+/**
+ * @brief Fence pool.
+ *
+ * This structure recycles unsignaled fences through a free list, so
+ * that submitting and waiting repeatedly costs no `vkCreateFence`
+ * and no `vkDestroyFence`.
+ */
+typedef struct VkxFencePool_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Free fence count. */
+    uint32_t fenceCount;
+
+    /** @brief Free fence capacity. */
+    uint32_t fenceCapacity;
+
+    /** @brief Free fences. */
+    VkFence* pFences;
+
+    /** @brief _Optional_. Mutex, if thread-safe. */
+    void* pMutex;
+}
+VkxFencePool;
+
+/**
+ * @brief Create fence pool.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] threadSafe
+ * Thread-safe? If so, acquire and release may be called from any
+ * thread concurrently.
+ *
+ * @param[out] pFencePool
+ * Fence pool.
+ *
+ * @pre
+ * - `device` is valid
+ * - `pFencePool` is non-`NULL`
+ *
+ * @post
+ * - on success, `pFencePool` is properly initialized
+ * - on failure, `pFencePool` is nullified
+ *
+ * @note
+ * Creates no fences until the first acquire.
+ */
+VkResult vkxCreateFencePool(
+            VkDevice device,
+            VkBool32 threadSafe,
+            VkxFencePool* pFencePool);
+
+/**
+ * @brief Destroy fence pool.
+ *
+ * @param[inout] pFencePool
+ * Fence pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - every fence acquired from `pFencePool` was released
+ * - `pAllocator` was used to acquire fences from `pFencePool`
+ *
+ * @post
+ * - `pFencePool` is nullified
+ *
+ * @note
+ * Does nothing if `pFencePool` is `NULL`.
+ */
+void vkxDestroyFencePool(
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Acquire unsignaled fence from fence pool.
+ *
+ * @param[inout] pFencePool
+ * Fence pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pFence
+ * Fence.
+ *
+ * @pre
+ * - `pFencePool` is non-`NULL`
+ * - `pFence` is non-`NULL`
+ */
+VkResult vkxFencePoolAcquire(
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator,
+            VkFence* pFence);
+
+/**
+ * @brief Release fence to fence pool.
+ *
+ * Resets the fence, then returns it to the free list.
+ *
+ * @param[inout] pFencePool
+ * Fence pool.
+ *
+ * @param[in] fence
+ * Fence.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pFencePool` is non-`NULL`
+ * - `fence` was acquired from `pFencePool`
+ * - `fence` has no pending queue submission
+ *
+ * @note
+ * If the fence cannot be reset, it is destroyed instead.
+ */
+void vkxFencePoolRelease(
+            VkxFencePool* pFencePool,
+            VkFence fence,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Semaphore pool.
+ *
+ * This structure recycles unsignaled binary semaphores through a free 
+ * list, so that ordering submissions costs no `vkCreateSemaphore` and 
+ * no `vkDestroySemaphore`.
+ */
+typedef struct VkxSemaphorePool_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Free semaphore count. */
+    uint32_t semaphoreCount;
+
+    /** @brief Free semaphore capacity. */
+    uint32_t semaphoreCapacity;
+
+    /** @brief Free semaphores. */
+    VkSemaphore* pSemaphores;
+
+    /** @brief _Optional_. Mutex, if thread-safe. */
+    void* pMutex;
+}
+VkxSemaphorePool;
+
+/**
+ * @brief Create semaphore pool.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] threadSafe
+ * Thread-safe? If so, acquire and release may be called from any
+ * thread concurrently.
+ *
+ * @param[out] pSemaphorePool
+ * Semaphore pool.
+ *
+ * @pre
+ * - `device` is valid
+ * - `pSemaphorePool` is non-`NULL`
+ *
+ * @post
+ * - on success, `pSemaphorePool` is properly initialized
+ * - on failure, `pSemaphorePool` is nullified
+ *
+ * @note
+ * Creates no semaphores until the first acquire.
+ */
+VkResult vkxCreateSemaphorePool(
+            VkDevice device,
+            VkBool32 threadSafe,
+            VkxSemaphorePool* pSemaphorePool);
+
+/**
+ * @brief Destroy semaphore pool.
+ *
+ * @param[inout] pSemaphorePool
+ * Semaphore pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - every semaphore acquired from `pSemaphorePool` was released
+ * - `pAllocator` was used to acquire semaphores from `pSemaphorePool`
+ *
+ * @post
+ * - `pSemaphorePool` is nullified
+ *
+ * @note
+ * Does nothing if `pSemaphorePool` is `NULL`.
+ */
+void vkxDestroySemaphorePool(
+            VkxSemaphorePool* pSemaphorePool,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Acquire unsignaled binary semaphore from semaphore pool.
+ *
+ * @param[inout] pSemaphorePool
+ * Semaphore pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pSemaphore
+ * Semaphore.
+ *
+ * @pre
+ * - `pSemaphorePool` is non-`NULL`
+ * - `pSemaphore` is non-`NULL`
+ */
+VkResult vkxSemaphorePoolAcquire(
+            VkxSemaphorePool* pSemaphorePool,
+            const VkAllocationCallbacks* pAllocator,
+            VkSemaphore* pSemaphore);
+
+/**
+ * @brief Release binary semaphore to semaphore pool.
+ *
+ * @param[inout] pSemaphorePool
+ * Semaphore pool.
+ *
+ * @param[in] semaphore
+ * Semaphore.
+ *
+ * @pre
+ * - `pSemaphorePool` is non-`NULL`
+ * - `semaphore` was acquired from `pSemaphorePool`
+ * - `semaphore` is unsignaled, and no pending queue operation waits 
+ * on or signals it
+ */
+void vkxSemaphorePoolRelease(
+            VkxSemaphorePool* pSemaphorePool,
+            VkSemaphore semaphore);
+
+/**
+ * @brief Queue timeline.
+ *
+ * This structure wraps one timeline semaphore per queue, and hands out
+ * an increasing value for each submission, so that completion of any 
+ * submission, and reclamation of any resource it used, is tracked by 
+ * comparing against a single counter instead of scanning fences.
+ *
+ * Functions which accept a timeline semaphore and value, such as
+ * `vkxSubmitTransferTicket`, work with `semaphore` and a value 
+ * obtained from `vkxTimelineAdvance`.
+ */
+typedef struct VkxQueueTimeline_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Queue. */
+    VkQueue queue;
+
+    /** @brief Timeline semaphore, owned. */
+    VkSemaphore semaphore;
+
+    /** @brief Last value handed out. */
+    uint64_t lastValue;
+
+    /** @brief Last value known to be complete. */
+    uint64_t completedValue;
+}
+VkxQueueTimeline;
+
+/**
+ * @brief Create queue timeline.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTimeline
+ * Queue timeline.
+ *
+ * @pre
+ * - `device` is valid, with `timelineSemaphore` enabled
+ * - `queue` is valid
+ * - `pTimeline` is non-`NULL`
+ *
+ * @post
+ * - on success, `pTimeline` is properly initialized
+ * - on failure, `pTimeline` is nullified
+ */
+VkResult vkxCreateQueueTimeline(
+            VkDevice device,
+            VkQueue queue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxQueueTimeline* pTimeline);
+
+/**
+ * @brief Destroy queue timeline.
+ *
+ * Waits for the last value handed out, then destroys the semaphore.
+ *
+ * @param[inout] pTimeline
+ * Queue timeline.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to create `pTimeline`
+ * - every value handed out was submitted to signal
+ *
+ * @post
+ * - `pTimeline` is nullified
+ *
+ * @note
+ * Does nothing if `pTimeline` is `NULL`.
+ */
+void vkxDestroyQueueTimeline(
+            VkxQueueTimeline* pTimeline,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Advance queue timeline.
+ *
+ * @param[inout] pTimeline
+ * Queue timeline.
+ *
+ * @pre
+ * - `pTimeline` is non-`NULL`
+ *
+ * @return
+ * Value for the next submission to signal, greater than every value
+ * handed out before.
+ */
+uint64_t vkxTimelineAdvance(
+            VkxQueueTimeline* pTimeline);
+
+/**
+ * @brief Submit to queue timeline.
+ *
+ * Submits command buffers to the queue, signaling a new value.
+ *
+ * @param[inout] pTimeline
+ * Queue timeline.
+ *
+ * @param[in] waitSemaphoreCount
+ * Wait semaphore count.
+ *
+ * @param[in] pWaitSemaphores
+ * Wait semaphores, binary.
+ *
+ * @param[in] pWaitDstStageMasks
+ * Wait destination stage masks.
+ *
+ * @param[in] commandBufferCount
+ * Command buffer count.
+ *
+ * @param[in] pCommandBuffers
+ * Command buffers.
+ *
+ * @param[in] signalSemaphoreCount
+ * Signal semaphore count.
+ *
+ * @param[in] pSignalSemaphores
+ * Signal semaphores, binary.
+ *
+ * @param[in] fence
+ * _Optional_. Fence, e.g., for presentation engines which require one.
+ *
+ * @param[out] pValue
+ * _Optional_. Value signaled once the submission completes.
+ *
+ * @pre
+ * - `pTimeline` is non-`NULL`
+ * - access to the queue of `pTimeline` is externally synchronized
+ *
+ * @post
+ * - on failure, the value is not handed out
+ */
+VkResult vkxTimelineSubmit(
+            VkxQueueTimeline* pTimeline,
+            uint32_t waitSemaphoreCount,
+            const VkSemaphore* pWaitSemaphores,
+            const VkPipelineStageFlags* pWaitDstStageMasks,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            uint32_t signalSemaphoreCount,
+            const VkSemaphore* pSignalSemaphores,
+            VkFence fence,
+            uint64_t* pValue);
+
+/**
+ * @brief Wait for queue timeline value.
+ *
+ * @param[inout] pTimeline
+ * Queue timeline.
+ *
+ * @param[in] value
+ * Value.
+ *
+ * @param[in] timeout
+ * Timeout in nanoseconds.
+ *
+ * @pre
+ * - `pTimeline` is non-`NULL`
+ * - `value` was handed out by `pTimeline`, or is `0`
+ *
+ * @return
+ * `VK_SUCCESS` if complete, `VK_TIMEOUT` if not complete in time, or
+ * an error code, e.g., `VK_ERROR_DEVICE_LOST`.
+ *
+ * @note
+ * Returns immediately if `value` is known to be complete.
+ */
+VkResult vkxTimelineWait(
+            VkxQueueTimeline* pTimeline,
+            uint64_t value,
+            uint64_t timeout);
+
+/**
+ * @brief Is queue timeline value complete?
+ *
+ * @param[inout] pTimeline
+ * Queue timeline.
+ *
+ * @param[in] value
+ * Value.
+ *
+ * @pre
+ * - `pTimeline` is non-`NULL`
+ *
+ * @return
+ * `VK_SUCCESS` if complete, `VK_NOT_READY` if not, or an error code,
+ * e.g., `VK_ERROR_DEVICE_LOST`.
+ *
+ * @note
+ * Does not block, and queries the semaphore only if `value` is not
+ * already known to be complete.
+ */
+VkResult vkxTimelineIsComplete(
+            VkxQueueTimeline* pTimeline,
+            uint64_t value);
+
+/**
+ * @brief Command pool set slot.
+ *
+ * This structure holds one transient command pool, and the command
+ * buffers allocated from it, which are handed out linearly and 
+ * recycled all at once when the pool is reset.
+ */
+typedef struct VkxCommandPoolSlot_
+{
+    /** @brief Command pool, or `VK_NULL_HANDLE` until first used. */
+    VkCommandPool commandPool;
+
+    /** @brief Command buffer count for each level. */
+    uint32_t commandBufferCounts[2];
+
+    /** @brief Command buffer capacity for each level. */
+    uint32_t commandBufferCapacities[2];
+
+    /** @brief Command buffers handed out for each level. */
+    uint32_t commandBufferUsedCounts[2];
+
+    /** @brief Command buffers for each level. */
+    VkCommandBuffer* pCommandBuffers[2];
+}
+VkxCommandPoolSlot;
+
+/**
+ * @brief Command pool set.
+ *
+ * This structure holds one transient command pool per thread, per 
+ * queue family, and per frame in flight, each created lazily on first
+ * use. Since no two threads share a pool, threads record in parallel 
+ * without locks. Rather than freeing individual command buffers, the
+ * pools of a frame are reset together when the frame begins again.
+ */
+typedef struct VkxCommandPoolSet_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Thread count. */
+    uint32_t threadCount;
+
+    /** @brief Queue family count. */
+    uint32_t queueFamilyCount;
+
+    /** @brief Queue family indices. */
+    uint32_t* pQueueFamilyIndices;
+
+    /** @brief Frame count. */
+    uint32_t frameCount;
+
+    /** @brief Current frame index. */
+    uint32_t frameIndex;
+
+    /** 
+     * @brief Slots, indexed by frame, then queue family, then thread.
+     */
+    VkxCommandPoolSlot* pSlots;
+}
+VkxCommandPoolSet;
+
+/**
+ * @brief Create command pool set.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] threadCount
+ * Thread count.
+ *
+ * @param[in] queueFamilyCount
+ * Queue family count.
+ *
+ * @param[in] pQueueFamilyIndices
+ * Queue family indices.
+ *
+ * @param[in] frameCount
+ * Frame count, usually the number of frames in flight.
+ *
+ * @param[out] pCommandPoolSet
+ * Command pool set.
+ *
+ * @pre
+ * - `device` is valid
+ * - `threadCount`, `queueFamilyCount`, and `frameCount` are non-zero
+ * - `pQueueFamilyIndices` points to `queueFamilyCount` values
+ * - `pCommandPoolSet` is non-`NULL`
+ *
+ * @post
+ * - on success, `pCommandPoolSet` is properly initialized
+ * - on failure, `pCommandPoolSet` is nullified
+ *
+ * @note
+ * Creates no command pools until first used.
+ */
+VkResult vkxCreateCommandPoolSet(
+            VkDevice device,
+            uint32_t threadCount,
+            uint32_t queueFamilyCount,
+            const uint32_t* pQueueFamilyIndices,
+            uint32_t frameCount,
+            VkxCommandPoolSet* pCommandPoolSet);
+
+/**
+ * @brief Destroy command pool set.
+ *
+ * @param[inout] pCommandPoolSet
+ * Command pool set.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to allocate from `pCommandPoolSet`
+ * - the device no longer executes command buffers of 
+ * `pCommandPoolSet`
+ *
+ * @post
+ * - `pCommandPoolSet` is nullified
+ *
+ * @note
+ * Does nothing if `pCommandPoolSet` is `NULL`.
+ */
+void vkxDestroyCommandPoolSet(
+            VkxCommandPoolSet* pCommandPoolSet,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Begin frame.
+ *
+ * Advances to the next frame, and resets every command pool of that
+ * frame, so that its command buffers may be handed out again.
+ *
+ * @param[inout] pCommandPoolSet
+ * Command pool set.
+ *
+ * @pre
+ * - `pCommandPoolSet` is non-`NULL`
+ * - the device no longer executes command buffers handed out the last
+ * time the next frame was current, e.g., its fence or timeline value
+ * was waited on
+ * - no thread is allocating from `pCommandPoolSet`
+ */
+VkResult vkxCommandPoolSetBeginFrame(
+            VkxCommandPoolSet* pCommandPoolSet);
+
+/**
+ * @brief Allocate command buffer from current frame.
+ *
+ * @param[inout] pCommandPoolSet
+ * Command pool set.
+ *
+ * @param[in] threadIndex
+ * Index of calling thread, less than `threadCount`.
+ *
+ * @param[in] queueFamily
+ * Index in `pQueueFamilyIndices`.
+ *
+ * @param[in] level
+ * Command buffer level.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pCommandBuffer
+ * Command buffer, in the initial state.
+ *
+ * @pre
+ * - `pCommandPoolSet` is non-`NULL`
+ * - no two threads use the same `threadIndex` concurrently
+ * - `pAllocator`, if non-`NULL`, is thread-safe
+ * - `pCommandBuffer` is non-`NULL`
+ *
+ * @note
+ * Command buffers are valid until the current frame begins again, and
+ * need not be freed.
+ */
+VkResult vkxCommandPoolSetAllocate(
+            VkxCommandPoolSet* pCommandPoolSet,
+            uint32_t threadIndex,
+            uint32_t queueFamily,
+            VkCommandBufferLevel level,
+            const VkAllocationCallbacks* pAllocator,
+            VkCommandBuffer* pCommandBuffer);
+
+/**
+ * @brief Record callback.
+ *
+ * @param[in] pUserData
+ * User data.
+ *
+ * @param[in] commandBuffer
+ * Secondary command buffer, in the recording state, inside the render
+ * pass.
+ *
+ * @param[in] jobIndex
+ * Job index.
+ */
+typedef void (*PFN_vkxRecordCallback)(
+            void* pUserData,
+            VkCommandBuffer commandBuffer,
+            uint32_t jobIndex);
+
+/**
+ * @brief Record job.
+ */
+typedef struct VkxRecordJob_
+{
+    /** @brief Record callback. */
+    PFN_vkxRecordCallback pfnRecord;
+
+    /** @brief _Optional_. User data. */
+    void* pUserData;
+}
+VkxRecordJob;
+
+/**
+ * @brief Record thread pool state, private to the implementation.
+ */
+typedef struct VkxRecordThreadPoolState_ VkxRecordThreadPoolState;
+
+/**
+ * @brief Record thread pool.
+ *
+ * This structure holds worker threads which record secondary command 
+ * buffers in parallel. Worker thread `i` allocates from thread index
+ * `i` of a command pool set, so workers never contend for a pool.
+ */
+typedef struct VkxRecordThreadPool_
+{
+    /** @brief Thread count. */
+    uint32_t threadCount;
+
+    /** @brief Private state. */
+    VkxRecordThreadPoolState* pState;
+}
+VkxRecordThreadPool;
+
+/**
+ * @brief Create record thread pool.
+ *
+ * @param[in] threadCount
+ * Thread count, usually the number of cores.
+ *
+ * @param[out] pThreadPool
+ * Record thread pool.
+ *
+ * @pre
+ * - `threadCount` is non-zero
+ * - `pThreadPool` is non-`NULL`
+ *
+ * @post
+ * - on success, `pThreadPool` is properly initialized
+ * - on failure, `pThreadPool` is nullified
+ */
+VkResult vkxCreateRecordThreadPool(
+            uint32_t threadCount,
+            VkxRecordThreadPool* pThreadPool);
+
+/**
+ * @brief Destroy record thread pool.
+ *
+ * @param[inout] pThreadPool
+ * Record thread pool.
+ *
+ * @post
+ * - `pThreadPool` is nullified
+ *
+ * @note
+ * Does nothing if `pThreadPool` is `NULL`.
+ */
+void vkxDestroyRecordThreadPool(
+            VkxRecordThreadPool* pThreadPool);
+
+/**
+ * @brief Record secondary command buffers in parallel.
+ *
+ * Fans jobs out to the worker threads, each recording into its own
+ * secondary command buffer, which inherits `renderPass`, `subpass`, 
+ * and `framebuffer`. Then executes the secondary command buffers in 
+ * `primaryCommandBuffer`, in job order, with one `vkCmdExecuteCommands`.
+ *
+ * @param[inout] pThreadPool
+ * Record thread pool.
+ *
+ * @param[inout] pCommandPoolSet
+ * Command pool set, to allocate secondary command buffers from.
+ *
+ * @param[in] queueFamily
+ * Index in `pCommandPoolSet->pQueueFamilyIndices`.
+ *
+ * @param[in] primaryCommandBuffer
+ * Primary command buffer.
+ *
+ * @param[in] renderPass
+ * Render pass.
+ *
+ * @param[in] subpass
+ * Subpass.
+ *
+ * @param[in] framebuffer
+ * _Optional_. Framebuffer.
+ *
+ * @param[in] jobCount
+ * Job count.
+ *
+ * @param[in] pJobs
+ * Jobs.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pThreadPool` is non-`NULL`, and not used by any other thread
+ * - `pCommandPoolSet` is non-`NULL`, with `threadCount` at least
+ * `pThreadPool->threadCount`, and no other thread allocates from its 
+ * first `pThreadPool->threadCount` thread indices concurrently
+ * - `primaryCommandBuffer` is inside `subpass` of `renderPass`, begun
+ * with `VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS`
+ * - `pJobs` points to `jobCount` jobs
+ * - callbacks are safe to call from worker threads
+ *
+ * @return
+ * The first error encountered, if any, in which case nothing is
+ * executed in `primaryCommandBuffer`.
+ */
+VkResult vkxRecordSecondaryCommandBuffers(
+            VkxRecordThreadPool* pThreadPool,
+            VkxCommandPoolSet* pCommandPoolSet,
+            uint32_t queueFamily,
+            VkCommandBuffer primaryCommandBuffer,
+            VkRenderPass renderPass,
+            uint32_t subpass,
+            VkFramebuffer framebuffer,
+            uint32_t jobCount,
+            const VkxRecordJob* pJobs,
+            const VkAllocationCallbacks* pAllocator);
+
 /**
  * @brief Allocate and begin command buffers.
  *
@@ -177,6 +975,39 @@ VkResult vkxFlushCommandBuffers(
             const VkCommandBuffer* pCommandBuffers,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Flush command buffers, with fence pool.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandBufferCount
+ * Command buffer count.
+ *
+ * @param[in] pCommandBuffers
+ * Command buffers.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to recycle the fence signaled on completion.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @note
+ * If `pFencePool` is `NULL`, this is equivalent to 
+ * `vkxFlushCommandBuffers()`.
+ */
+VkResult vkxFlushCommandBuffersWithFencePool(
+            VkDevice device,
+            VkQueue queue,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator);
+
 /**
  * @brief End, flush, and free command buffers.
  *
@@ -206,6 +1037,43 @@ VkResult vkxEndFlushAndFreeCommandBuffers(
             const VkCommandBuffer* pCommandBuffers,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief End, flush, and free command buffers, with fence pool.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] commandBufferCount
+ * Command buffer count.
+ *
+ * @param[in] pCommandBuffers
+ * Command buffers.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to recycle the fence signaled on completion.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @note
+ * If `pFencePool` is `NULL`, this is equivalent to 
+ * `vkxEndFlushAndFreeCommandBuffers()`.
+ */
+VkResult vkxEndFlushAndFreeCommandBuffersWithFencePool(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator);
+
 /**
  * @brief Begin command buffer.
  *
@@ -0,0 +1,411 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#pragma once
+#ifndef VULKANX_DELETION_QUEUE_H
+#define VULKANX_DELETION_QUEUE_H
+
+#include <vulkanx/allocator.h>
+#include <vulkanx/buffer.h>
+#include <vulkanx/descriptor_set.h>
+#include <vulkanx/image.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/**
+ * @defgroup deletion_queue Deletion queue
+ *
+ * `<vulkanx/deletion_queue.h>`
+ */
+/**@{*/
+
+/**
+ * @brief Deletion key.
+ *
+ * The point the device must pass before a deletion is retired, either
+ * a fence, or a value on a timeline semaphore.
+ */
+typedef struct VkxDeletionKey_
+{
+    /** @brief Fence, or `VK_NULL_HANDLE` if keyed by timeline. */
+    VkFence fence;
+
+    /** @brief Timeline semaphore, or `VK_NULL_HANDLE` if keyed by fence. */
+    VkSemaphore timelineSemaphore;
+
+    /** @brief Timeline value. */
+    uint64_t timelineValue;
+}
+VkxDeletionKey;
+
+/**
+ * @brief Deletion callback.
+ *
+ * @param[in] pUserData
+ * User data.
+ */
+typedef void (*PFN_vkxDeletionCallback)(void* pUserData);
+
+/**
+ * @brief Deletion type.
+ */
+typedef enum VkxDeletionType_
+{
+    /** @brief Buffer, by `vkxDestroyBuffer`. */
+    VKX_DELETION_TYPE_BUFFER = 1,
+
+    /** @brief Image, by `vkxDestroyImage`. */
+    VKX_DELETION_TYPE_IMAGE = 2,
+
+    /** @brief Allocated buffer, by `vkxDestroyAllocatedBuffer`. */
+    VKX_DELETION_TYPE_ALLOCATED_BUFFER = 3,
+
+    /** @brief Allocated image, by `vkxDestroyAllocatedImage`. */
+    VKX_DELETION_TYPE_ALLOCATED_IMAGE = 4,
+
+    /** @brief Dynamic descriptor set, by `vkxFreeDynamicDescriptorSets`. */
+    VKX_DELETION_TYPE_DYNAMIC_DESCRIPTOR_SET = 5,
+
+    /** @brief Callback, for anything else. */
+    VKX_DELETION_TYPE_CALLBACK = 6
+}
+VkxDeletionType;
+
+/**
+ * @brief Deletion.
+ */
+typedef struct VkxDeletion_
+{
+    /** @brief Key. */
+    VkxDeletionKey key;
+
+    /** @brief Type. */
+    VkxDeletionType type;
+
+    /** @brief Object, according to type. */
+    union
+    {
+        /** @brief If `VKX_DELETION_TYPE_BUFFER`. */
+        VkxBuffer buffer;
+
+        /** @brief If `VKX_DELETION_TYPE_IMAGE`. */
+        VkxImage image;
+
+        /** @brief If `VKX_DELETION_TYPE_ALLOCATED_BUFFER`. */
+        struct
+        {
+            /** @brief Memory allocator. */
+            VkxAllocator* pMemoryAllocator;
+
+            /** @brief Allocated buffer. */
+            VkxAllocatedBuffer buffer;
+        }
+        allocatedBuffer;
+
+        /** @brief If `VKX_DELETION_TYPE_ALLOCATED_IMAGE`. */
+        struct
+        {
+            /** @brief Memory allocator. */
+            VkxAllocator* pMemoryAllocator;
+
+            /** @brief Allocated image. */
+            VkxAllocatedImage image;
+        }
+        allocatedImage;
+
+        /** @brief If `VKX_DELETION_TYPE_DYNAMIC_DESCRIPTOR_SET`. */
+        struct
+        {
+            /** @brief Dynamic descriptor pool. */
+            VkxDynamicDescriptorPool* pDynamicPool;
+
+            /** @brief Dynamic descriptor set. */
+            VkxDynamicDescriptorSet set;
+        }
+        dynamicDescriptorSet;
+
+        /** @brief If `VKX_DELETION_TYPE_CALLBACK`. */
+        struct
+        {
+            /** @brief Callback. */
+            PFN_vkxDeletionCallback pfnCallback;
+
+            /** @brief _Optional_. User data. */
+            void* pUserData;
+        }
+        callback;
+    };
+}
+VkxDeletion;
+
+/**
+ * @brief Deletion queue.
+ *
+ * This structure defers destruction of objects which the device may 
+ * still access until the device passes a fence or timeline value,
+ * then retires them in bulk, so that freeing memory never requires
+ * `vkDeviceWaitIdle`.
+ */
+typedef struct VkxDeletionQueue_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Deletion count. */
+    uint32_t deletionCount;
+
+    /** @brief Deletion capacity. */
+    uint32_t deletionCapacity;
+
+    /** @brief Deletions, in order of enqueueing. */
+    VkxDeletion* pDeletions;
+}
+VkxDeletionQueue;
+
+/**
+ * @brief Create deletion queue.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[out] pDeletionQueue
+ * Deletion queue.
+ *
+ * @pre
+ * - `device` is valid
+ * - `pDeletionQueue` is non-`NULL`
+ *
+ * @note
+ * Allocates nothing until the first deletion.
+ */
+void vkxCreateDeletionQueue(
+            VkDevice device,
+            VkxDeletionQueue* pDeletionQueue);
+
+/**
+ * @brief Destroy deletion queue.
+ *
+ * Waits for every key, then retires every deletion.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pAllocator` was used to create every object enqueued
+ *
+ * @post
+ * - `pDeletionQueue` is nullified
+ *
+ * @note
+ * Does nothing if `pDeletionQueue` is `NULL`.
+ */
+void vkxDestroyDeletionQueue(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Enqueue deletion.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pDeletion
+ * Deletion.
+ *
+ * @pre
+ * - `pDeletionQueue` is non-`NULL`
+ * - `pDeletion` is non-`NULL`
+ * - exactly one of `pDeletion->key.fence` and 
+ * `pDeletion->key.timelineSemaphore` is non-`VK_NULL_HANDLE`
+ * - the client no longer uses the object of `pDeletion`
+ */
+void vkxDeletionQueuePush(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletion* pDeletion);
+
+/**
+ * @brief Defer destroy buffer.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[inout] pBuffer
+ * Buffer, nullified on return.
+ */
+void vkxDeferDestroyBuffer(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxBuffer* pBuffer);
+
+/**
+ * @brief Defer destroy image.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[inout] pImage
+ * Image, nullified on return.
+ */
+void vkxDeferDestroyImage(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxImage* pImage);
+
+/**
+ * @brief Defer destroy allocated buffer.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[in] pMemoryAllocator
+ * Memory allocator, which must outlive the deletion.
+ *
+ * @param[inout] pBuffer
+ * Allocated buffer, nullified on return.
+ */
+void vkxDeferDestroyAllocatedBuffer(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedBuffer* pBuffer);
+
+/**
+ * @brief Defer destroy allocated image.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[in] pMemoryAllocator
+ * Memory allocator, which must outlive the deletion.
+ *
+ * @param[inout] pImage
+ * Allocated image, nullified on return.
+ */
+void vkxDeferDestroyAllocatedImage(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedImage* pImage);
+
+/**
+ * @brief Defer free dynamic descriptor sets.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[in] pDynamicPool
+ * Dynamic descriptor pool, which must outlive the deletions.
+ *
+ * @param[in] setCount
+ * Descriptor set count.
+ *
+ * @param[inout] pDynamicSets
+ * Dynamic descriptor sets, nullified on return.
+ */
+void vkxDeferFreeDynamicDescriptorSets(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxDynamicDescriptorPool* pDynamicPool,
+            uint32_t setCount,
+            VkxDynamicDescriptorSet* pDynamicSets);
+
+/**
+ * @brief Defer callback.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pKey
+ * Key.
+ *
+ * @param[in] pfnCallback
+ * Callback.
+ *
+ * @param[in] pUserData
+ * _Optional_. User data.
+ */
+void vkxDeferCallback(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            PFN_vkxDeletionCallback pfnCallback,
+            void* pUserData);
+
+/**
+ * @brief Retire deletions whose keys the device has passed.
+ *
+ * Queries each distinct fence and timeline semaphore at most once,
+ * without waiting.
+ *
+ * @param[inout] pDeletionQueue
+ * Deletion queue.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pDeletionQueue` is non-`NULL`
+ * - `pAllocator` was used to create every object enqueued
+ * - fences keying enqueued deletions have not been reset since they 
+ * were submitted, so a typical frame loop waits for the frame fence,
+ * retires, and only then resets the fence
+ *
+ * @return
+ * An error code if querying a key fails, e.g., `VK_ERROR_DEVICE_LOST`,
+ * in which case deletions keyed by it are not retired.
+ */
+VkResult vkxDeletionQueueRetire(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkAllocationCallbacks* pAllocator);
+
+/**@}*/
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef VULKANX_DELETION_QUEUE_H
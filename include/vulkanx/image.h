@@ -30,6 +30,8 @@
 #ifndef VULKANX_IMAGE_H
 #define VULKANX_IMAGE_H
 
+#include <vulkanx/allocator.h>
+#include <vulkanx/buffer.h>
 #include <vulkanx/memory.h>
 
 #ifdef __cplusplus
@@ -59,8 +61,12 @@ VkxImage;
 /**
  * @brief Create image.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If the implementation prefers or requires a dedicated allocation 
+ * for the image, as reported by `VkMemoryDedicatedRequirements`, the
+ * memory is allocated with `VkMemoryDedicatedAllocateInfo`.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -78,7 +84,7 @@ VkxImage;
  * Image.
  *
  * @pre
- * - `physicalDevice` is valid
+ * - `pMemoryTypeTable` is non-`NULL`
  * - `device` is valid
  * - `pImageCreateInfo` is non-`NULL`
  * - `pImage` is non-`NULL` 
@@ -89,7 +95,7 @@ VkxImage;
  * - on failure, `pImage` is nullified
  */
 VkResult vkxCreateImage(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             const VkImageCreateInfo* pImageCreateInfo,
             const VkMemoryPropertyFlags memoryPropertyFlags,
@@ -124,6 +130,89 @@ void vkxDestroyImage(
             VkxImage* pImage,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Allocated image.
+ *
+ * This structure is like `VkxImage`, except that its memory is 
+ * a sub-range of a `VkxAllocator` block rather than a dedicated
+ * `VkDeviceMemory` allocation.
+ */
+typedef struct VkxAllocatedImage_
+{
+    /** @brief Image. */
+    VkImage image;
+
+    /** @brief Allocation. */
+    VkxAllocation allocation;
+}
+VkxAllocatedImage;
+
+/**
+ * @brief Create image with memory from allocator.
+ *
+ * If the implementation prefers or requires a dedicated allocation, the
+ * memory is allocated by `vkxAllocatorAllocateDedicatedMemory`.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[in] pImageCreateInfo
+ * Image create info.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pImage
+ * Image.
+ *
+ * @pre
+ * - `pMemoryAllocator` is non-`NULL`
+ * - `pImageCreateInfo` is non-`NULL`
+ * - `pImage` is non-`NULL` 
+ * - `pImage` is uninitialized
+ *
+ * @post
+ * - on success, `pImage` is properly initialized
+ * - on failure, `pImage` is nullified
+ */
+VkResult vkxCreateAllocatedImage(
+            VkxAllocator* pMemoryAllocator,
+            const VkImageCreateInfo* pImageCreateInfo,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocatedImage* pImage);
+
+/**
+ * @brief Destroy image with memory from allocator.
+ *
+ * @param[inout] pMemoryAllocator
+ * Allocator.
+ *
+ * @param[inout] pImage
+ * Image.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pMemoryAllocator` was used to create `pImage`
+ * - `pAllocator` was used to create `pImage`
+ * - `pImage` was previously created by `vkxCreateAllocatedImage`
+ *
+ * @post
+ * - `pImage` is nullified
+ *
+ * @note
+ * Does nothing if `pImage` is `NULL`.
+ */
+void vkxDestroyAllocatedImage(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedImage* pImage,
+            const VkAllocationCallbacks* pAllocator);
+
 /**
  * @brief Image group.
  */
@@ -143,8 +232,12 @@ VkxImageGroup;
 /**
  * @brief Create image group.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * Images for which the implementation prefers or requires a dedicated
+ * allocation get their own dedicated memory, and all other images are
+ * packed into shared memory.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -165,7 +258,7 @@ VkxImageGroup;
  * Image group.
  *
  * @pre
- * - `physicalDevice` is valid
+ * - `pMemoryTypeTable` is non-`NULL`
  * - `device` is valid
  * - `pImageCreateInfos` points to `imageCount` values
  * - `pMemoryPropertyFlags` points to `imageCount` values
@@ -183,7 +276,7 @@ VkxImageGroup;
  * `pImageGroup` is nullified, and result is `VK_SUCCESS`.
  */
 VkResult vkxCreateImageGroup(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             uint32_t imageCount,
             const VkImageCreateInfo* pImageCreateInfos,
@@ -191,6 +284,91 @@ VkResult vkxCreateImageGroup(
             const VkAllocationCallbacks* pAllocator,
             VkxImageGroup* pImageGroup);
 
+/**
+ * @brief Image lifetime.
+ *
+ * An inclusive interval of abstract time steps, e.g., pass indices
+ * in a frame graph, during which an image holds meaningful contents.
+ */
+typedef struct VkxImageLifetime_
+{
+    /** @brief First use. */
+    uint32_t firstUse;
+
+    /** @brief Last use, inclusive. */
+    uint32_t lastUse;
+}
+VkxImageLifetime;
+
+/**
+ * @brief Create aliased image group.
+ *
+ * Like `vkxCreateImageGroup`, except images whose lifetimes do not
+ * overlap may be bound to the same memory range. The implementation 
+ * colors the interval graph of lifetimes greedily in order of first use,
+ * which uses as many memory ranges as the maximum number of 
+ * simultaneously live images, and prefers the range that grows least.
+ * Images only share a range if they have the same memory property flags,
+ * the same tiling class, and at least one common memory type. Images
+ * for which the implementation prefers a dedicated allocation are never
+ * aliased.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] imageCount
+ * Image count.
+ *
+ * @param[in] pImageCreateInfos
+ * Image create infos.
+ *
+ * @param[in] pMemoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] pImageLifetimes
+ * Image lifetimes.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pImageGroup
+ * Image group.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pImageCreateInfos` points to `imageCount` values
+ * - `pMemoryPropertyFlags` points to `imageCount` values
+ * - `pImageLifetimes` points to `imageCount` values
+ * - `pImageGroup` is non-`NULL` 
+ * - `pImageGroup` is uninitialized
+ *
+ * @post
+ * - on success, `pImageGroup` is properly initialized
+ * - on failure, `pImageGroup` is nullified
+ *
+ * @note
+ * Contents of an image are undefined at its first use, since another
+ * image may have written the same memory. The first use must therefore
+ * transition from `VK_IMAGE_LAYOUT_UNDEFINED`, and the client must 
+ * synchronize the last use of one image with the first use of the next.
+ *
+ * @note
+ * Destroy with `vkxDestroyImageGroup`.
+ */
+VkResult vkxCreateAliasedImageGroup(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t imageCount,
+            const VkImageCreateInfo* pImageCreateInfos,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxImageLifetime* pImageLifetimes,
+            const VkAllocationCallbacks* pAllocator,
+            VkxImageGroup* pImageGroup);
+
 /**
  * @brief Destroy image group.
  *
@@ -294,6 +472,42 @@ void vkxDestroyImageViews(
             VkImageView* pImageViews,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Get transition image layout barrier.
+ *
+ * Initializes an image memory barrier from `oldLayout` to `newLayout`,
+ * inferring source and destination access masks from the layouts, so
+ * that several transitions may be recorded in one pipeline barrier.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] oldLayout
+ * Old image layout.
+ *
+ * @param[in] newLayout
+ * New image layout.
+ *
+ * @param[in] subresourceRange
+ * Subresource range.
+ *
+ * @param[out] pMemoryBarrier
+ * Image memory barrier.
+ *
+ * @pre
+ * - `pMemoryBarrier` is non-`NULL`
+ *
+ * @return
+ * `VK_SUCCESS`, or `VK_ERROR_INITIALIZATION_FAILED` if either layout
+ * is unsupported.
+ */
+VkResult vkxGetTransitionImageLayoutBarrier(
+            VkImage image,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkImageSubresourceRange subresourceRange,
+            VkImageMemoryBarrier* pMemoryBarrier);
+
 /**
  * @brief Transition image layout command.
  *
@@ -373,6 +587,71 @@ VkResult vkxTransitionImageLayout(
             VkImageSubresourceRange subresourceRange,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Transition image layout asynchronously.
+ *
+ * Like `vkxTransitionImageLayout`, except returns once submitted.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] oldLayout
+ * Old layout.
+ *
+ * @param[in] newLayout
+ * New layout.
+ *
+ * @param[in] subresourceRange
+ * Subresource range.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxTransitionImageLayout`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxTransitionImageLayoutAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkImageSubresourceRange subresourceRange,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
 /**
  * @brief Copy image to buffer.
  *
@@ -426,6 +705,76 @@ VkResult vkxCopyImageToBuffer(
             const VkBufferImageCopy* pRegions,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Copy image to buffer asynchronously.
+ *
+ * Like `vkxCopyImageToBuffer`, except returns once submitted.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] srcImage
+ * Source image.
+ *
+ * @param[in] srcImageLayout
+ * Source image layout.
+ *
+ * @param[in] dstBuffer
+ * Destination buffer.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxCopyImageToBuffer`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized, and complete if
+ * there was nothing to copy
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxCopyImageToBufferAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage srcImage,
+            VkImageLayout srcImageLayout,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferImageCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
 /**
  * @brief Copy buffer to image.
  *
@@ -479,6 +828,76 @@ VkResult vkxCopyBufferToImage(
             const VkBufferImageCopy* pRegions,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Copy buffer to image asynchronously.
+ *
+ * Like `vkxCopyBufferToImage`, except returns once submitted.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] srcBuffer
+ * Source buffer.
+ *
+ * @param[in] dstImage
+ * Destination image.
+ *
+ * @param[in] dstImageLayout
+ * Destination image layout.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxCopyBufferToImage`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized, and complete if
+ * there was nothing to copy
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxCopyBufferToImageAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer srcBuffer,
+            VkImage dstImage,
+            VkImageLayout dstImageLayout,
+            uint32_t regionCount,
+            const VkBufferImageCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
 /**
  * @brief Image data access.
  */
@@ -504,8 +923,11 @@ VkxImageDataAccess;
 /**
  * @brief Get image data via temporary staging buffer.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If `pStagingPool` is non-`NULL`, the staging buffer is acquired 
+ * from and released to the pool, so repeated transfers allocate nothing.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -522,6 +944,9 @@ VkxImageDataAccess;
  * @param[in] pImageDataAccess
  * Image data access.
  *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
@@ -541,20 +966,24 @@ VkxImageDataAccess;
  * the implementation immediately returns `VK_SUCCESS`
  */
 VkResult vkxGetImageData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkImage image,
             const VkxImageDataAccess* pImageDataAccess,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator,
             void* pData);
 
 /**
  * @brief Set image data via temporary staging buffer.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * If `pStagingPool` is non-`NULL`, the staging buffer is acquired 
+ * from and released to the pool, so repeated transfers allocate nothing.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -574,6 +1003,9 @@ VkResult vkxGetImageData(
  * @param[in] pData
  * Data.
  *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
  * @param[in] pAllocator
  * _Optional_. Allocation callbacks.
  *
@@ -590,15 +1022,267 @@ VkResult vkxGetImageData(
  * the implementation immediately returns `VK_SUCCESS`
  */
 VkResult vkxSetImageData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            const void* pData,
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Set image data asynchronously.
+ *
+ * Like `vkxSetImageData`, except returns once submitted. The staging
+ * buffer is held by the ticket, and released when the ticket is 
+ * destroyed. Since `pData` is copied before returning, the client may
+ * reuse it immediately.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] image
+ * Image.
+ * 
+ * @param[in] pImageDataAccess
+ * Image data access.
+ *
+ * @param[in] pData
+ * Data.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxSetImageData`
+ * - `pStagingPool`, if non-`NULL`, outlives `pTicket`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxSetImageDataAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkImage image,
             const VkxImageDataAccess* pImageDataAccess,
             const void* pData,
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
+/**
+ * @brief Image region data.
+ *
+ * This structure describes a rectangle, or box, of texels to write,
+ * and where its texels live in client memory. Rows are `rowPitch` 
+ * bytes apart, and slices are `slicePitch` bytes apart, where slices 
+ * are counted over depth first, then over array layers.
+ */
+typedef struct VkxImageRegionData_
+{
+    /** @brief Subresource layers. */
+    VkImageSubresourceLayers subresourceLayers;
+
+    /** @brief Offset. */
+    VkOffset3D offset;
+
+    /** @brief Extent. */
+    VkExtent3D extent;
+
+    /** @brief Data, pointing to the first texel. */
+    const void* pData;
+
+    /** @brief Row pitch in bytes, or `0` if tightly packed. */
+    VkDeviceSize rowPitch;
+
+    /** @brief Slice pitch in bytes, or `0` if tightly packed. */
+    VkDeviceSize slicePitch;
+}
+VkxImageRegionData;
+
+/**
+ * @brief Set image regions via one staging buffer.
+ *
+ * Packs every region into one staging allocation, then copies all of
+ * them with one `vkCmdCopyBufferToImage`, so updating many small 
+ * rectangles of an atlas costs one submission.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] imageLayout
+ * Image layout.
+ *
+ * @param[in] texelSize
+ * Texel size in bytes.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `image` supports `VK_IMAGE_USAGE_TRANSFER_DST_BIT`
+ * - `imageLayout` is
+ * `VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL`,
+ * `VK_IMAGE_LAYOUT_GENERAL`, or `VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR`
+ * - the image format is uncompressed, with texels of `texelSize` bytes
+ * - `pRegions` points to `regionCount` regions
+ * - regions do not overlap
+ *
+ * @note
+ * If `regionCount` is `0`, the implementation immediately returns 
+ * `VK_SUCCESS`.
+ */
+VkResult vkxSetImageRegions(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            uint32_t regionCount,
+            const VkxImageRegionData* pRegions,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Set image regions asynchronously.
+ *
+ * Like `vkxSetImageRegions`, except returns once submitted. Since 
+ * region data is copied before returning, the client may reuse it
+ * immediately.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] imageLayout
+ * Image layout.
+ *
+ * @param[in] texelSize
+ * Texel size in bytes.
+ *
+ * @param[in] regionCount
+ * Region count.
+ *
+ * @param[in] pRegions
+ * Regions.
+ *
+ * @param[inout] pStagingPool
+ * _Optional_. Staging pool.
+ *
+ * @param[inout] pFencePool
+ * _Optional_. Fence pool, to acquire the fence signaled on completion from.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pTicket
+ * Transfer ticket.
+ *
+ * @pre
+ * - same as `vkxSetImageRegions`
+ * - `pStagingPool`, if non-`NULL`, outlives `pTicket`
+ * - `pFencePool`, if non-`NULL`, outlives `pTicket`
+ * - `pTicket` is non-`NULL`
+ * - `pTicket` is uninitialized
+ *
+ * @post
+ * - on success, `pTicket` is properly initialized
+ * - on failure, `pTicket` is nullified
+ */
+VkResult vkxSetImageRegionsAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            uint32_t regionCount,
+            const VkxImageRegionData* pRegions,
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket);
+
 /**@}*/
 
 #ifdef __cplusplus
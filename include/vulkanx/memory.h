@@ -78,6 +78,145 @@ extern "C" {
  */
 #define VKX_LOCAL_FREE VKX_LOCAL_FREE_
 
+/**
+ * @brief Memory type table.
+ *
+ * This structure caches `VkPhysicalDeviceMemoryProperties` along with
+ * precomputed lookups, so that finding a memory type index for an
+ * allocation does not call into the driver and does not scan every 
+ * memory type for property flags.
+ */
+typedef struct VkxMemoryTypeTable_
+{
+    /** @brief Memory properties. */
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+
+    /**
+     * @brief Memory type bits for each memory property flag bit.
+     *
+     * Bit `memoryTypeIndex` of element `flagBitIndex` is set if memory
+     * type `memoryTypeIndex` supports property flag `1 << flagBitIndex`.
+     */
+    uint32_t memoryTypeBitsPerFlagBit[32];
+
+    /**
+     * @brief Memory type indices ranked for device-local requests.
+     *
+     * Device-local memory types come first, then memory types are ranked
+     * by heap size, largest first.
+     */
+    uint32_t deviceLocalRankedIndices[VK_MAX_MEMORY_TYPES];
+
+    /**
+     * @brief Memory type indices ranked for other requests.
+     *
+     * Memory types which are not device-local come first, then memory
+     * types are ranked by heap size, largest first.
+     */
+    uint32_t hostRankedIndices[VK_MAX_MEMORY_TYPES];
+
+    /** @brief Buffer image granularity. */
+    VkDeviceSize bufferImageGranularity;
+
+    /** @brief Non-coherent atom size. */
+    VkDeviceSize nonCoherentAtomSize;
+}
+VkxMemoryTypeTable;
+
+/**
+ * @brief Get memory type table.
+ *
+ * @param[in] physicalDevice
+ * Physical device.
+ *
+ * @param[out] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @pre
+ * - `physicalDevice` is valid
+ * - `pMemoryTypeTable` is non-`NULL`
+ */
+void vkxGetMemoryTypeTable(
+            VkPhysicalDevice physicalDevice,
+            VkxMemoryTypeTable* pMemoryTypeTable);
+
+/**
+ * @brief Find memory type index in memory type table.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] memoryTypeBits
+ * Memory type bits.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ *
+ * @note
+ * Of the memory types in `memoryTypeBits` supporting 
+ * `memoryPropertyFlags`, returns the highest ranked. If no suitable
+ * memory type index, returns `UINT32_MAX`.
+ */
+uint32_t vkxMemoryTypeTableFindIndex(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+                         uint32_t memoryTypeBits);
+
+/**
+ * @brief Filter memory type bits in memory type table.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] memoryPropertyFlags
+ * Memory property flags.
+ *
+ * @param[in] memoryTypeBits
+ * Memory type bits.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ *
+ * @note
+ * Returns the subset of `memoryTypeBits` supporting 
+ * `memoryPropertyFlags`.
+ */
+uint32_t vkxMemoryTypeTableFilterBits(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+                         uint32_t memoryTypeBits);
+
+/**
+ * @brief Pad allocation size in memory type table.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] memoryTypeIndex
+ * Memory type index.
+ *
+ * @param[in] allocationSize
+ * Allocation size.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `memoryTypeIndex` is valid
+ *
+ * @note
+ * If the memory type is host-visible but not host-coherent, returns 
+ * `allocationSize` rounded up to a multiple of `nonCoherentAtomSize`, 
+ * so that any flushed or invalidated range rounded out to 
+ * `nonCoherentAtomSize` stays within the allocation. Otherwise, returns 
+ * `allocationSize`.
+ */
+VkDeviceSize vkxMemoryTypeTablePadAllocationSize(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            uint32_t memoryTypeIndex,
+            VkDeviceSize allocationSize);
+
 /**
  * @brief Find memory type index.
  *
@@ -92,6 +231,11 @@ extern "C" {
  *
  * @note
  * If no suitable memory type index, returns `UINT32_MAX`.
+ *
+ * @note
+ * Queries memory properties on every call. To find memory types
+ * repeatedly, get a `VkxMemoryTypeTable` once and use
+ * `vkxMemoryTypeTableFindIndex` instead.
  */
 uint32_t vkxFindMemoryTypeIndex(
             VkPhysicalDevice physicalDevice,
@@ -124,6 +268,24 @@ typedef struct VkxDeviceMemoryView_
 }
 VkxDeviceMemoryView;
 
+/**
+ * @brief Allocation type.
+ *
+ * Vulkan requires linear and non-linear resources sharing a 
+ * `VkDeviceMemory` allocation to be separated by
+ * `bufferImageGranularity`. Allocation routines use the allocation type
+ * to decide when this padding is necessary.
+ */
+typedef enum VkxAllocationType_
+{
+    /** @brief Linear resource, e.g., buffer or linear-tiling image. */
+    VKX_ALLOCATION_TYPE_LINEAR = 1,
+
+    /** @brief Non-linear resource, e.g., optimal-tiling image. */
+    VKX_ALLOCATION_TYPE_OPTIMAL = 2
+}
+VkxAllocationType;
+
 /**
  * @brief Shared device memory.
  *
@@ -161,8 +323,8 @@ VkxSharedDeviceMemory;
 /**
  * @brief Allocate shared memory.
  *
- * @param[in] physicalDevice
- * Physical device.
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
  *
  * @param[in] device
  * Device.
@@ -183,7 +345,7 @@ VkxSharedDeviceMemory;
  * Shared memory.
  *
  * @pre
- * - `physicalDevice` is valid
+ * - `pMemoryTypeTable` is non-`NULL`
  * - `device` is valid
  * - `pMemoryRequirements` points to `memoryRequirementCount` values
  * - `pMemoryPropertyFlags` points to `memoryRequirementCount` values
@@ -201,7 +363,7 @@ VkxSharedDeviceMemory;
  * `pSharedMemory` is nullified, and result is `VK_SUCCESS`.
  */
 VkResult vkxAllocateSharedMemory(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             uint32_t memoryRequirementCount,
             const VkMemoryRequirements* pMemoryRequirements,
@@ -209,6 +371,77 @@ VkResult vkxAllocateSharedMemory(
             const VkAllocationCallbacks* pAllocator,
             VkxSharedDeviceMemory* pSharedMemory);
 
+/**
+ * @brief Allocate packed shared memory.
+ *
+ * Like `vkxAllocateSharedMemory`, except the implementation does not
+ * place requirements in input order. Instead, for each memory type, 
+ * requirements are grouped by allocation type, then sorted by 
+ * decreasing alignment and decreasing size, which minimizes the padding
+ * necessary to satisfy mixed alignments. If allocation types are 
+ * specified, linear and non-linear requirements are additionally 
+ * separated by `bufferImageGranularity`.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] memoryRequirementCount
+ * Memory requirement count.
+ *
+ * @param[in] pMemoryRequirements
+ * Memory requirements.
+ *
+ * @param[in] pMemoryPropertyFlags
+ * Memory property flags per requirement.
+ *
+ * @param[in] pAllocationTypes
+ * _Optional_. Allocation types per requirement. If `NULL`, every 
+ * requirement is treated as linear.
+ *
+ * @param[in] pDedicatedAllocateInfos
+ * _Optional_. Dedicated allocate infos per requirement. Requirements 
+ * whose info names an image or a buffer are given dedicated unique 
+ * memories of their own, chaining the info, and every other
+ * requirement is pooled as usual.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pSharedMemory
+ * Shared memory.
+ *
+ * @param[out] pWastedSize
+ * _Optional_. Total padding in bytes.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pMemoryRequirements` points to `memoryRequirementCount` values
+ * - `pMemoryPropertyFlags` points to `memoryRequirementCount` values
+ * - `pSharedMemory` is non-`NULL`
+ * - `pSharedMemory` is uninitialized
+ *
+ * @post
+ * - on success, `pSharedMemory` is properly initialized
+ * - on failure, `pSharedMemory` is nullified
+ * - memory views in `pSharedMemory` correspond to requirements in
+ * input order, regardless of placement
+ */
+VkResult vkxAllocatePackedSharedMemory(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryRequirementCount,
+            const VkMemoryRequirements* pMemoryRequirements,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxAllocationType* pAllocationTypes,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos,
+            const VkAllocationCallbacks* pAllocator,
+            VkxSharedDeviceMemory* pSharedMemory,
+            VkDeviceSize* pWastedSize);
+
 /**
  * @brief Free shared memory.
  *
@@ -237,6 +470,213 @@ void vkxFreeSharedMemory(
             VkxSharedDeviceMemory* pSharedMemory,
             const VkAllocationCallbacks* pAllocator);
 
+/**
+ * @brief Flush memory views.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] memoryViewCount
+ * Memory view count.
+ *
+ * @param[in] pMemoryViews
+ * Memory views, whose sizes may be `VK_WHOLE_SIZE`.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pMemoryViews` points to `memoryViewCount` values
+ * - each memory in `pMemoryViews` is currently host mapped
+ *
+ * @note
+ * Rounds each view out to `nonCoherentAtomSize` and makes host writes
+ * available to the device in a single call to 
+ * `vkFlushMappedMemoryRanges`. This is necessary after writing memory 
+ * of host-visible memory types that are not host-coherent. Memory 
+ * allocated by vulkanx is padded by 
+ * `vkxMemoryTypeTablePadAllocationSize`, except dedicated allocations,
+ * which must be flushed with views that end at the end of the memory
+ * or at a multiple of `nonCoherentAtomSize`.
+ */
+VkResult vkxFlushMemoryViews(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryViewCount,
+            const VkxDeviceMemoryView* pMemoryViews);
+
+/**
+ * @brief Invalidate memory views.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] memoryViewCount
+ * Memory view count.
+ *
+ * @param[in] pMemoryViews
+ * Memory views, whose sizes may be `VK_WHOLE_SIZE`.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pMemoryViews` points to `memoryViewCount` values
+ * - each memory in `pMemoryViews` is currently host mapped
+ *
+ * @note
+ * Like `vkxFlushMemoryViews`, except makes device writes visible to
+ * the host by `vkInvalidateMappedMemoryRanges`. This is necessary 
+ * before reading memory of host-visible memory types that are not
+ * host-coherent.
+ */
+VkResult vkxInvalidateMemoryViews(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryViewCount,
+            const VkxDeviceMemoryView* pMemoryViews);
+
+/**
+ * @brief Mapped memory range batch.
+ *
+ * This structure accumulates host-written (dirty) or device-written 
+ * ranges of mapped non-coherent memory, rounded out to 
+ * `nonCoherentAtomSize`, so that a frame's worth of ranges is sorted, 
+ * coalesced, and submitted in a single call to 
+ * `vkFlushMappedMemoryRanges` or `vkInvalidateMappedMemoryRanges`. 
+ * This makes `VK_MEMORY_PROPERTY_HOST_CACHED_BIT` memory types without
+ * `VK_MEMORY_PROPERTY_HOST_COHERENT_BIT` practical for frequent 
+ * readback and upload.
+ *
+ * @note
+ * Flushing and invalidating host-coherent memory is valid but 
+ * unnecessary, so clients need not add ranges of host-coherent memory.
+ */
+typedef struct VkxMappedMemoryRangeBatch_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Non-coherent atom size. */
+    VkDeviceSize nonCoherentAtomSize;
+
+    /** @brief Range count. */
+    uint32_t rangeCount;
+
+    /** @brief Range capacity. */
+    uint32_t rangeCapacity;
+
+    /** @brief Ranges. */
+    VkMappedMemoryRange* pRanges;
+}
+VkxMappedMemoryRangeBatch;
+
+/**
+ * @brief Create mapped memory range batch.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[out] pBatch
+ * Batch.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pBatch` is non-`NULL`
+ *
+ * @post
+ * - `pBatch` is properly initialized, and empty
+ */
+void vkxCreateMappedMemoryRangeBatch(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkxMappedMemoryRangeBatch* pBatch);
+
+/**
+ * @brief Destroy mapped memory range batch.
+ *
+ * @param[inout] pBatch
+ * Batch.
+ *
+ * @post
+ * - `pBatch` is nullified
+ *
+ * @note
+ * Does nothing if `pBatch` is `NULL`. Pending ranges are discarded.
+ */
+void vkxDestroyMappedMemoryRangeBatch(
+            VkxMappedMemoryRangeBatch* pBatch);
+
+/**
+ * @brief Add memory view to mapped memory range batch.
+ *
+ * @param[inout] pBatch
+ * Batch.
+ *
+ * @param[in] pMemoryView
+ * Memory view, whose size may be `VK_WHOLE_SIZE`.
+ *
+ * @pre
+ * - `pBatch` is non-`NULL`
+ * - `pMemoryView` is non-`NULL`
+ * - `pMemoryView->memory` is host mapped until the batch is submitted
+ *
+ * @note
+ * Extends the last range in place if the view continues it, as 
+ * is the case for sequential writes, otherwise appends a range.
+ */
+void vkxMappedMemoryRangeBatchAdd(
+            VkxMappedMemoryRangeBatch* pBatch,
+            const VkxDeviceMemoryView* pMemoryView);
+
+/**
+ * @brief Flush mapped memory range batch.
+ *
+ * @param[inout] pBatch
+ * Batch.
+ *
+ * @pre
+ * - `pBatch` is non-`NULL`
+ *
+ * @post
+ * - `pBatch` is empty
+ *
+ * @note
+ * Coalesces overlapping and adjacent ranges, and flushes in a single 
+ * call to `vkFlushMappedMemoryRanges`. Call after host writes, before
+ * submitting device work that reads them.
+ */
+VkResult vkxMappedMemoryRangeBatchFlush(
+            VkxMappedMemoryRangeBatch* pBatch);
+
+/**
+ * @brief Invalidate mapped memory range batch.
+ *
+ * @param[inout] pBatch
+ * Batch.
+ *
+ * @pre
+ * - `pBatch` is non-`NULL`
+ *
+ * @post
+ * - `pBatch` is empty
+ *
+ * @note
+ * Like `vkxMappedMemoryRangeBatchFlush`, except invalidates by 
+ * `vkInvalidateMappedMemoryRanges`. Call after device writes complete,
+ * before host reads.
+ */
+VkResult vkxMappedMemoryRangeBatchInvalidate(
+            VkxMappedMemoryRangeBatch* pBatch);
+
 /**@}*/
 
 #ifdef __cplusplus
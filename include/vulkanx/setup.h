@@ -30,7 +30,7 @@
 #ifndef VULKANX_SETUP_H
 #define VULKANX_SETUP_H
 
-#include <vulkan/vulkan.h>
+#include <vulkanx/memory.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -294,6 +294,9 @@ typedef struct VkxDevice_
     /** @brief Physical device features. */
     VkPhysicalDeviceFeatures* pPhysicalDeviceFeatures;
 
+    /** @brief Physical device memory type table. */
+    VkxMemoryTypeTable* pMemoryTypeTable;
+
     /** @brief Logical device. */
     VkDevice device;
 
@@ -0,0 +1,421 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#pragma once
+#ifndef VULKANX_STREAM_H
+#define VULKANX_STREAM_H
+
+#include <vulkanx/transfer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/**
+ * @defgroup stream Stream
+ *
+ * `<vulkanx/stream.h>`
+ */
+/**@{*/
+
+/**
+ * @brief Streamer maximum batch size in bytes.
+ *
+ * The worker stops gathering requests into a batch once it holds at 
+ * least this many bytes.
+ */
+#define VKX_STREAMER_MAX_BATCH_SIZE ((VkDeviceSize)(64 << 20))
+
+/**
+ * @brief Streamer maximum batches in flight.
+ */
+#define VKX_STREAMER_MAX_BATCHES_IN_FLIGHT 4
+
+/**
+ * @brief Stream callback.
+ *
+ * Invoked on the worker thread once a request completes, or fails with
+ * `result`.
+ */
+typedef void (*PFN_vkxStreamCallback)(void* pUserData, VkResult result);
+
+/**
+ * @brief Stream request.
+ *
+ * Writes `pData` to either `buffer` or `image`. Exactly one of `buffer`
+ * and `image` must be non-`VK_NULL_HANDLE`. Image writes are subject to
+ * the preconditions of `vkxUploadBatchWriteImage`, in particular that 
+ * the image format is uncompressed.
+ */
+typedef struct VkxStreamRequest_
+{
+    /** @brief Buffer, or `VK_NULL_HANDLE` if writing image. */
+    VkBuffer buffer;
+
+    /** @brief Buffer data access, if writing buffer. */
+    VkxBufferDataAccess bufferDataAccess;
+
+    /** @brief Image, or `VK_NULL_HANDLE` if writing buffer. */
+    VkImage image;
+
+    /** @brief Image data access, if writing image. */
+    VkxImageDataAccess imageDataAccess;
+
+    /** @brief Image layout after writing, if writing image. */
+    VkImageLayout newImageLayout;
+
+    /** @brief Data, which must remain valid until completion. */
+    const void* pData;
+
+    /** @brief _Optional_. Callback. */
+    PFN_vkxStreamCallback pfnCallback;
+
+    /** @brief _Optional_. Callback user data. */
+    void* pUserData;
+}
+VkxStreamRequest;
+
+/**
+ * @brief Streamer state, private to the implementation.
+ */
+typedef struct VkxStreamerState_ VkxStreamerState;
+
+/**
+ * @brief Streamer.
+ *
+ * A streamer owns a worker thread and a command pool. Any number of 
+ * producer threads push requests into a bounded lock-free ring, without
+ * blocking one another or the worker. The worker drains the ring into
+ * upload batches, submits each batch once, and keeps up to 
+ * `VKX_STREAMER_MAX_BATCHES_IN_FLIGHT` batches executing while it 
+ * gathers the next.
+ *
+ * Each pushed request is assigned a stream value, increasing in push 
+ * order. Requests complete in the same order, so a single completed 
+ * value, like a timeline semaphore, tells whether any request is done.
+ *
+ * The thread-shared state lives behind `pState`, so that this header 
+ * exposes no atomic or thread types to C++ clients.
+ */
+typedef struct VkxStreamer_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Queue, used only by the worker thread. */
+    VkQueue queue;
+
+    /** @brief Command pool, used only by the worker thread. */
+    VkCommandPool commandPool;
+
+    /** @brief Private state. */
+    VkxStreamerState* pState;
+}
+VkxStreamer;
+
+/**
+ * @brief Create streamer.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] queueFamilyIndex
+ * Queue family index of `queue`.
+ *
+ * @param[in] ringCapacity
+ * Request ring capacity, rounded up to a power of two.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pStreamer
+ * Streamer.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `queue` is not used by any other thread while `pStreamer` exists,
+ * e.g., the only queue of a dedicated transfer queue family
+ * - `pAllocator`, if non-`NULL`, is thread-safe
+ * - `pStreamer` is non-`NULL`, and does not move while it exists, 
+ * since the worker thread refers to it
+ *
+ * @post
+ * - on success, `pStreamer` is properly initialized
+ * - on failure, `pStreamer` is nullified
+ *
+ * @note
+ * The worker performs no queue family ownership transfer, so written
+ * resources must either use `VK_SHARING_MODE_CONCURRENT` or be used 
+ * only in `queueFamilyIndex`.
+ */
+VkResult vkxCreateStreamer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            uint32_t queueFamilyIndex,
+            uint32_t ringCapacity,
+            const VkAllocationCallbacks* pAllocator,
+            VkxStreamer* pStreamer);
+
+/**
+ * @brief Destroy streamer.
+ *
+ * Completes every pushed request, invoking callbacks, then joins the 
+ * worker thread and destroys the command pool.
+ *
+ * @param[inout] pStreamer
+ * Streamer.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - no producer pushes concurrently
+ *
+ * @post
+ * - `pStreamer` is nullified
+ *
+ * @note
+ * Does nothing if `pStreamer` is `NULL`.
+ */
+void vkxDestroyStreamer(
+            VkxStreamer* pStreamer,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Streamer push.
+ *
+ * Thread-safe and lock-free. 
+ *
+ * @param[inout] pStreamer
+ * Streamer.
+ *
+ * @param[in] pRequest
+ * Request, copied.
+ *
+ * @param[out] pValue
+ * _Optional_. Stream value of request, for `vkxStreamerIsComplete`.
+ *
+ * @return
+ * `VK_SUCCESS`, or `VK_NOT_READY` if the ring is full, in which case 
+ * nothing is pushed and the client may retry later.
+ */
+VkResult vkxStreamerPush(
+            VkxStreamer* pStreamer,
+            const VkxStreamRequest* pRequest,
+            uint64_t* pValue);
+
+/**
+ * @brief Streamer get completed value.
+ *
+ * Thread-safe and lock-free. Every request with stream value less 
+ * than or equal to the completed value is complete, and its callback
+ * has returned.
+ *
+ * @param[in] pStreamer
+ * Streamer.
+ */
+uint64_t vkxStreamerGetCompletedValue(
+            const VkxStreamer* pStreamer);
+
+/**
+ * @brief Streamer is complete?
+ *
+ * Thread-safe and lock-free.
+ *
+ * @param[in] pStreamer
+ * Streamer.
+ *
+ * @param[in] value
+ * Stream value.
+ *
+ * @return
+ * `VK_SUCCESS` if the request with stream value `value` is complete,
+ * `VK_NOT_READY` otherwise.
+ */
+VkResult vkxStreamerIsComplete(
+            const VkxStreamer* pStreamer,
+            uint64_t value);
+
+/**
+ * @brief File stream chunk size.
+ */
+#define VKX_FILE_STREAM_CHUNK_SIZE ((VkDeviceSize)(4 << 20))
+
+/**
+ * @brief File stream staging block count.
+ *
+ * The host fills one staging block while the device copies from the 
+ * others, so peak staging memory is this many chunks regardless of 
+ * file size.
+ */
+#define VKX_FILE_STREAM_BLOCK_COUNT 3
+
+/**
+ * @brief Stream file to buffer.
+ *
+ * Maps the file, where supported, and streams it in chunks of 
+ * `VKX_FILE_STREAM_CHUNK_SIZE` bytes through a ring of
+ * `VKX_FILE_STREAM_BLOCK_COUNT` persistently mapped staging blocks,
+ * copying each chunk straight from the file mapping into staging 
+ * memory, so data is copied once on the host. If the file cannot be 
+ * mapped, e.g., because it exceeds the address space, each chunk is 
+ * read into staging memory instead. Reading chunk `N + 1` overlaps 
+ * with the device copying chunk `N`.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] pFilename
+ * Filename.
+ *
+ * @param[in] fileOffset
+ * File offset in bytes.
+ *
+ * @param[in] size
+ * Size in bytes, or `VK_WHOLE_SIZE` for the rest of the file.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] bufferOffset
+ * Buffer offset in bytes.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ *
+ * @return
+ * `VK_ERROR_INITIALIZATION_FAILED` if the file cannot be opened, or
+ * is too short.
+ *
+ * @note
+ * Returns once every chunk is copied.
+ */
+VkResult vkxStreamFileToBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            const char* pFilename,
+            VkDeviceSize fileOffset,
+            VkDeviceSize size,
+            VkBuffer buffer,
+            VkDeviceSize bufferOffset,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Stream file to image.
+ *
+ * Like `vkxStreamFileToBuffer`, except each chunk holds whole rows 
+ * of texels, and is copied to a band of rows of the image. Within the 
+ * staging block, the rows of each slice spanned start at a multiple of 
+ * the least common multiple of the texel size and 4, as 
+ * `vkCmdCopyBufferToImage` requires.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] pFilename
+ * Filename.
+ *
+ * @param[in] fileOffset
+ * File offset in bytes.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] pImageDataAccess
+ * Image data access.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - all Vulkan handles are valid
+ * - `queue` is compatible with `commandPool`
+ * - `image` supports `VK_IMAGE_USAGE_TRANSFER_DST_BIT`
+ * - `pImageDataAccess` is non-`NULL`
+ * - `pImageDataAccess->layout` is
+ * `VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL`,
+ * `VK_IMAGE_LAYOUT_GENERAL`, or `VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR`
+ * - the file holds `pImageDataAccess->size` bytes of tightly packed 
+ * texels at `fileOffset`, layer by layer, slice by slice, row by row
+ * - the image format is uncompressed
+ *
+ * @return
+ * `VK_ERROR_INITIALIZATION_FAILED` if the file cannot be opened, or
+ * is too short.
+ */
+VkResult vkxStreamFileToImage(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            const char* pFilename,
+            VkDeviceSize fileOffset,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            const VkAllocationCallbacks* pAllocator);
+
+/**@}*/
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef VULKANX_STREAM_H
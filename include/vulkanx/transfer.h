@@ -0,0 +1,542 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#pragma once
+#ifndef VULKANX_TRANSFER_H
+#define VULKANX_TRANSFER_H
+
+#include <vulkanx/buffer.h>
+#include <vulkanx/image.h>
+#include <vulkanx/memory.h>
+#include <vulkanx/setup.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+/**
+ * @defgroup transfer Transfer
+ *
+ * `<vulkanx/transfer.h>`
+ */
+/**@{*/
+
+/**
+ * @brief Upload batch minimum staging chunk size.
+ */
+#define VKX_UPLOAD_BATCH_MIN_CHUNK_SIZE ((VkDeviceSize)65536)
+
+/**
+ * @brief Upload batch buffer write.
+ */
+typedef struct VkxUploadBufferWrite_
+{
+    /** @brief Destination buffer. */
+    VkBuffer buffer;
+
+    /** @brief Staging chunk index. */
+    uint32_t chunkIndex;
+
+    /** @brief Region, source offset relative to staging chunk. */
+    VkBufferCopy region;
+}
+VkxUploadBufferWrite;
+
+/**
+ * @brief Upload batch image write.
+ */
+typedef struct VkxUploadImageWrite_
+{
+    /** @brief Destination image. */
+    VkImage image;
+
+    /** @brief Layout before batch. */
+    VkImageLayout oldLayout;
+
+    /** @brief Layout after batch. */
+    VkImageLayout newLayout;
+
+    /** @brief Staging chunk index. */
+    uint32_t chunkIndex;
+
+    /** @brief Region, buffer offset relative to staging chunk. */
+    VkBufferImageCopy region;
+}
+VkxUploadImageWrite;
+
+/**
+ * @brief Upload batch.
+ *
+ * An upload batch accumulates any number of buffer and image writes,
+ * copying each into a shared staging arena immediately, then records 
+ * them all into one command buffer with one submission. Buffer writes 
+ * are sorted and adjacent regions merged, so that each destination 
+ * buffer is written by one `vkCmdCopyBuffer` per staging chunk. Image 
+ * layout transitions are gathered into one pipeline barrier before the
+ * copies and one after.
+ *
+ * The staging arena is a list of persistently mapped staging chunks,
+ * each at least double the size of the last, so that enqueueing costs 
+ * amortized constant time and writes never move.
+ */
+typedef struct VkxUploadBatch_
+{
+    /** @brief Memory type table, copied. */
+    VkxMemoryTypeTable memoryTypeTable;
+
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Staging chunk count. */
+    uint32_t chunkCount;
+
+    /** @brief Staging chunk capacity. */
+    uint32_t chunkCapacity;
+
+    /** @brief Staging chunks. */
+    VkxBuffer* pChunks;
+
+    /** @brief Size of last staging chunk. */
+    VkDeviceSize chunkSize;
+
+    /** @brief Used size of last staging chunk. */
+    VkDeviceSize chunkOffset;
+
+    /** @brief Buffer write count. */
+    uint32_t bufferWriteCount;
+
+    /** @brief Buffer write capacity. */
+    uint32_t bufferWriteCapacity;
+
+    /** @brief Buffer writes. */
+    VkxUploadBufferWrite* pBufferWrites;
+
+    /** @brief Image write count. */
+    uint32_t imageWriteCount;
+
+    /** @brief Image write capacity. */
+    uint32_t imageWriteCapacity;
+
+    /** @brief Image writes. */
+    VkxUploadImageWrite* pImageWrites;
+
+    /** @brief Transfer ticket, valid once submitted. */
+    VkxTransferTicket ticket;
+
+    /** 
+     * @brief Queue family ownership acquire ticket, valid once submitted
+     * by a transfer engine with distinct queue families.
+     */
+    VkxTransferTicket acquireTicket;
+
+    /** @brief Semaphore ordering release before acquire. */
+    VkSemaphore ownershipSemaphore;
+
+    /** 
+     * @brief _Optional_. Fence pool, which the client may set before
+     * submitting, to acquire ticket fences from.
+     */
+    VkxFencePool* pFencePool;
+
+    /** 
+     * @brief _Optional_. Semaphore pool, to acquire the ownership 
+     * semaphore from.
+     */
+    VkxSemaphorePool* pSemaphorePool;
+}
+VkxUploadBatch;
+
+/**
+ * @brief Begin upload batch.
+ *
+ * @param[in] pMemoryTypeTable
+ * Memory type table.
+ *
+ * @param[in] device
+ * Device.
+ *
+ * @param[out] pBatch
+ * Upload batch.
+ *
+ * @pre
+ * - `pMemoryTypeTable` is non-`NULL`
+ * - `device` is valid
+ * - `pBatch` is non-`NULL`
+ *
+ * @note
+ * Allocates nothing until the first write.
+ */
+void vkxBeginUploadBatch(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkxUploadBatch* pBatch);
+
+/**
+ * @brief Upload batch write buffer.
+ *
+ * Copies `pData` into the staging arena, and enqueues a copy into
+ * `buffer`.
+ *
+ * @param[inout] pBatch
+ * Upload batch.
+ *
+ * @param[in] buffer
+ * Buffer.
+ *
+ * @param[in] pBufferDataAccess
+ * Buffer data access.
+ *
+ * @param[in] pData
+ * Data.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pBatch` is not yet submitted
+ * - `buffer` supports `VK_BUFFER_USAGE_TRANSFER_DST_BIT`
+ * - `pBufferDataAccess` is non-`NULL`
+ * - `pData` points to `pBufferDataAccess->size` bytes
+ * - the destination range does not overlap the destination range of
+ * any other write to `buffer` in the same batch
+ *
+ * @note
+ * The client may reuse `pData` immediately.
+ */
+VkResult vkxUploadBatchWriteBuffer(
+            VkxUploadBatch* pBatch,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            const void* pData,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Upload batch write image.
+ *
+ * Copies `pData` into the staging arena, and enqueues a copy into
+ * `image`. The batch transitions the written subresources from 
+ * `pImageDataAccess->layout` to `VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL`
+ * before copying, then to `newLayout` after copying.
+ *
+ * The staging offset is aligned to the least common multiple of the
+ * texel size and 4, as `vkCmdCopyBufferToImage` requires, where the 
+ * texel size is `pImageDataAccess->size` divided by the texel count.
+ *
+ * @param[inout] pBatch
+ * Upload batch.
+ *
+ * @param[in] image
+ * Image.
+ *
+ * @param[in] pImageDataAccess
+ * Image data access, where `layout` is the layout before the batch.
+ *
+ * @param[in] newLayout
+ * Layout after the batch.
+ *
+ * @param[in] pData
+ * Data.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pBatch` is not yet submitted
+ * - `image` supports `VK_IMAGE_USAGE_TRANSFER_DST_BIT`
+ * - `pImageDataAccess` is non-`NULL`
+ * - `pData` points to `pImageDataAccess->size` bytes, tightly packed
+ * - the image format is uncompressed
+ * - writes to the same subresource in the same batch agree on layouts
+ *
+ * @return
+ * `VK_ERROR_INITIALIZATION_FAILED` if either layout is unsupported by
+ * `vkxGetTransitionImageLayoutBarrier`.
+ */
+VkResult vkxUploadBatchWriteImage(
+            VkxUploadBatch* pBatch,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            VkImageLayout newLayout,
+            const void* pData,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Submit upload batch.
+ *
+ * Flushes the staging arena, records every write into one command 
+ * buffer, and submits it once, signaling a fence or `timelineValue`
+ * on `timelineSemaphore`. Poll or wait on `pBatch->ticket` to learn 
+ * when the batch completes.
+ *
+ * @param[inout] pBatch
+ * Upload batch.
+ *
+ * @param[in] queue
+ * Queue.
+ *
+ * @param[in] commandPool
+ * Command pool.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pBatch` is not yet submitted
+ * - `queue` is compatible with `commandPool`, and supports transfer
+ * and every stage which reads images in their new layouts
+ *
+ * @note
+ * If the batch is empty, the implementation submits nothing, and
+ * `pBatch->ticket` is immediately complete.
+ */
+VkResult vkxSubmitUploadBatch(
+            VkxUploadBatch* pBatch,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Destroy upload batch.
+ *
+ * Waits for the batch if submitted, then frees the command buffers,
+ * the ownership semaphore, and the staging arena.
+ *
+ * @param[inout] pBatch
+ * Upload batch.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @post
+ * - `pBatch` is nullified
+ *
+ * @note
+ * Does nothing if `pBatch` is `NULL`.
+ *
+ * @note
+ * Frees the command buffers to the command pools the batch was 
+ * submitted with. If submitted by `vkxTransferEngineSubmitUploadBatch`,
+ * the client must externally synchronize this with other calls on the 
+ * engine.
+ */
+void vkxDestroyUploadBatch(
+            VkxUploadBatch* pBatch,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Transfer engine.
+ *
+ * A transfer engine submits upload batches to a transfer queue family 
+ * distinct from the graphics queue family, if the device has one, so 
+ * that uploads overlap with rendering rather than competing for the 
+ * graphics queue. Each batch is then recorded as two command buffers: 
+ * the copies with queue family ownership release barriers on the 
+ * transfer queue, and the matching acquire barriers on the graphics 
+ * queue, ordered by a semaphore. If there is no distinct transfer 
+ * queue family, batches are submitted to the graphics queue as usual.
+ *
+ * The command pools of the engine are not thread-safe, so calls to 
+ * `vkxTransferEngineSubmitUploadBatch` on the same engine, and calls 
+ * to `vkxDestroyUploadBatch` on batches it submitted, must be 
+ * externally synchronized.
+ */
+typedef struct VkxTransferEngine_
+{
+    /** @brief Associated device. */
+    VkDevice device;
+
+    /** @brief Graphics queue family index. */
+    uint32_t graphicsQueueFamilyIndex;
+
+    /** @brief Graphics queue. */
+    VkQueue graphicsQueue;
+
+    /** @brief Graphics command pool, owned, externally synchronized. */
+    VkCommandPool graphicsCommandPool;
+
+    /** @brief Transfer queue family index. */
+    uint32_t transferQueueFamilyIndex;
+
+    /** @brief Transfer queue. */
+    VkQueue transferQueue;
+
+    /** 
+     * @brief Transfer command pool, owned, externally synchronized, or 
+     * same as graphics command pool if no distinct transfer queue family.
+     */
+    VkCommandPool transferCommandPool;
+
+    /** @brief Transfer queue family minimum image transfer granularity. */
+    VkExtent3D transferGranularity;
+
+    /** @brief Fence pool, thread-safe, for batches without one. */
+    VkxFencePool fencePool;
+
+    /** @brief Semaphore pool, thread-safe, for batches without one. */
+    VkxSemaphorePool semaphorePool;
+}
+VkxTransferEngine;
+
+/**
+ * @brief Create transfer engine.
+ *
+ * Selects the transfer queue from the queue families of `pDevice`,
+ * preferring a family which supports transfer but neither graphics nor
+ * compute, then a family which does not support graphics, then falling
+ * back to the graphics queue family.
+ *
+ * @param[in] pDevice
+ * Device.
+ *
+ * @param[in] graphicsQueueFamily
+ * Index of graphics queue family in `pDevice->pQueueFamilies`.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @param[out] pEngine
+ * Transfer engine.
+ *
+ * @pre
+ * - `pDevice` is non-`NULL`
+ * - `graphicsQueueFamily` is less than `pDevice->queueFamilyCount`
+ * - `pEngine` is non-`NULL`
+ *
+ * @post
+ * - on success, `pEngine` is properly initialized
+ * - on failure, `pEngine` is nullified
+ *
+ * @note
+ * The engine uses the first queue of each queue family, so the client 
+ * must externally synchronize submissions to those queues.
+ */
+VkResult vkxCreateTransferEngine(
+            const VkxDevice* pDevice,
+            uint32_t graphicsQueueFamily,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferEngine* pEngine);
+
+/**
+ * @brief Destroy transfer engine.
+ *
+ * @param[inout] pEngine
+ * Transfer engine.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - every upload batch submitted by `pEngine` is destroyed
+ *
+ * @post
+ * - `pEngine` is nullified
+ *
+ * @note
+ * Does nothing if `pEngine` is `NULL`.
+ */
+void vkxDestroyTransferEngine(
+            VkxTransferEngine* pEngine,
+            const VkAllocationCallbacks* pAllocator);
+
+/**
+ * @brief Transfer engine submit upload batch.
+ *
+ * If the engine has a distinct transfer queue family, records the 
+ * copies on the transfer queue, releasing ownership of every written 
+ * buffer and image subresource to the graphics queue family, then
+ * records the matching acquire on the graphics queue. Otherwise, 
+ * equivalent to `vkxSubmitUploadBatch` on the graphics queue.
+ *
+ * Completion, including the acquire, is signaled by `timelineValue` 
+ * on `timelineSemaphore` if non-`VK_NULL_HANDLE`, or by a fence
+ * otherwise. Poll or wait on `pBatch->acquireTicket` if valid, else
+ * `pBatch->ticket`, or simply destroy the batch.
+ *
+ * @param[inout] pEngine
+ * Transfer engine.
+ *
+ * @param[inout] pBatch
+ * Upload batch.
+ *
+ * @param[in] timelineSemaphore
+ * _Optional_. Timeline semaphore to signal, instead of a fence.
+ *
+ * @param[in] timelineValue
+ * Timeline value.
+ *
+ * @param[in] pAllocator
+ * _Optional_. Allocation callbacks.
+ *
+ * @pre
+ * - `pBatch` is not yet submitted
+ * - with distinct queue families, every written buffer is either new
+ * or last released to the transfer queue family, and every written 
+ * image subresource either has old layout `VK_IMAGE_LAYOUT_UNDEFINED`
+ * or was last released to the transfer queue family
+ * - with distinct queue families, every image write offset is a 
+ * multiple of `pEngine->transferGranularity`, and every image write 
+ * extent is a multiple of `pEngine->transferGranularity` or reaches 
+ * the edge of the subresource, where a zero granularity component
+ * requires the whole subresource
+ *
+ * @note
+ * Subsequent graphics queue submissions are ordered after the acquire
+ * by submission order, so they need not wait on anything.
+ *
+ * @note
+ * If `pBatch` has no fence pool or semaphore pool, it draws from 
+ * those of `pEngine`.
+ *
+ * @note
+ * Allocates command buffers from the command pools of `pEngine`, so 
+ * the client must externally synchronize this with other calls on 
+ * `pEngine`, and with `vkxDestroyUploadBatch` on batches submitted by 
+ * `pEngine`.
+ */
+VkResult vkxTransferEngineSubmitUploadBatch(
+            VkxTransferEngine* pEngine,
+            VkxUploadBatch* pBatch,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator);
+
+/**@}*/
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef VULKANX_TRANSFER_H
@@ -0,0 +1,1444 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkanx/result.h>
+#include <vulkanx/allocator.h>
+
+// Allocator range.
+typedef struct VkxAllocatorRange_
+{
+    // Offset.
+    VkDeviceSize offset;
+
+    // Size.
+    VkDeviceSize size;
+
+    // Allocation type, or 0 if free.
+    uint32_t allocationType;
+}
+VkxAllocatorRange;
+
+// Allocator block.
+struct VkxAllocatorBlock_
+{
+    // Memory.
+    VkDeviceMemory memory;
+
+    // Size.
+    VkDeviceSize size;
+
+    // Memory type index.
+    uint32_t memoryTypeIndex;
+
+    // Dedicated to a single allocation?
+    VkBool32 dedicated;
+
+    // Allocation count.
+    uint32_t allocationCount;
+
+    // Allocated size, in live allocations.
+    VkDeviceSize allocatedSize;
+
+    // Map count, in outstanding map references.
+    uint32_t mapCount;
+
+    // Mapped data, or NULL if not mapped.
+    void* pMappedData;
+
+    // Range count.
+    uint32_t rangeCount;
+
+    // Range capacity.
+    uint32_t rangeCapacity;
+
+    // Ranges, sorted by offset, covering the entire block.
+    VkxAllocatorRange* pRanges;
+};
+
+// Round up to multiple of alignment.
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    if (alignment > 1 && value % alignment) {
+        value = value - value % alignment + alignment;
+    }
+    return value;
+}
+
+// Ranges conflict with respect to buffer image granularity? Range 1 must
+// precede range 2.
+static VkBool32 rangesConflict(
+            VkDeviceSize granularity,
+            const VkxAllocatorRange* pRange1,
+            VkDeviceSize offset2,
+            uint32_t allocationType2)
+{
+    // Same type, or granularity irrelevant?
+    if (granularity <= 1 ||
+        pRange1->allocationType == 0 ||
+        pRange1->allocationType == allocationType2) {
+        return VK_FALSE;
+    }
+
+    // Range 1 ends on same granularity page that range 2 begins?
+    VkDeviceSize end1 = pRange1->offset + pRange1->size - 1;
+    return end1 / granularity == offset2 / granularity;
+}
+
+// Insert range into block.
+static void insertRange(
+            VkxAllocatorBlock* pBlock,
+            uint32_t rangeIndex,
+            VkxAllocatorRange range)
+{
+    if (pBlock->rangeCount == pBlock->rangeCapacity) {
+        pBlock->rangeCapacity *= 2;
+        pBlock->pRanges = 
+            (VkxAllocatorRange*)realloc(
+                    pBlock->pRanges,
+                    sizeof(VkxAllocatorRange) * pBlock->rangeCapacity);
+    }
+    memmove(
+        &pBlock->pRanges[rangeIndex + 1],
+        &pBlock->pRanges[rangeIndex],
+        sizeof(VkxAllocatorRange) * (pBlock->rangeCount - rangeIndex));
+    pBlock->pRanges[rangeIndex] = range;
+    pBlock->rangeCount++;
+}
+
+// Erase range from block.
+static void eraseRange(
+            VkxAllocatorBlock* pBlock,
+            uint32_t rangeIndex)
+{
+    memmove(
+        &pBlock->pRanges[rangeIndex],
+        &pBlock->pRanges[rangeIndex + 1],
+        sizeof(VkxAllocatorRange) * (pBlock->rangeCount - rangeIndex - 1));
+    pBlock->rangeCount--;
+}
+
+// Find placement of requirements in free range of block.
+//
+// On success, returns VK_TRUE and writes the aligned offset. The
+// offset is aligned to memoryRequirements.alignment, and additionally
+// to bufferImageGranularity if a neighbor of different allocation 
+// type shares a granularity page.
+static VkBool32 findPlacement(
+            const VkxAllocatorBlock* pBlock,
+            uint32_t rangeIndex,
+            const VkMemoryRequirements* pMemoryRequirements,
+            uint32_t allocationType,
+            VkDeviceSize granularity,
+            VkDeviceSize* pOffset)
+{
+    const VkxAllocatorRange* pRange = &pBlock->pRanges[rangeIndex];
+    if (pRange->allocationType != 0 ||
+        pRange->size < pMemoryRequirements->size) {
+        return VK_FALSE;
+    }
+
+    // Align offset.
+    VkDeviceSize offset = 
+        alignUp(pRange->offset, pMemoryRequirements->alignment);
+
+    // Conflict with previous range?
+    if (rangeIndex > 0 &&
+        rangesConflict(
+            granularity, 
+            &pBlock->pRanges[rangeIndex - 1], offset, allocationType)) {
+        offset = alignUp(offset, granularity);
+        offset = alignUp(offset, pMemoryRequirements->alignment);
+    }
+
+    // Fits?
+    VkDeviceSize end = offset + pMemoryRequirements->size;
+    if (end > pRange->offset + pRange->size) {
+        return VK_FALSE;
+    }
+
+    // Conflict with next range?
+    if (rangeIndex + 1 < pBlock->rangeCount) {
+        const VkxAllocatorRange* pNextRange = &pBlock->pRanges[rangeIndex + 1];
+        VkxAllocatorRange range = {
+            .offset = offset,
+            .size = pMemoryRequirements->size,
+            .allocationType = allocationType
+        };
+        if (rangesConflict(
+                granularity, 
+                &range, pNextRange->offset, pNextRange->allocationType)) {
+            return VK_FALSE;
+        }
+    }
+
+    *pOffset = offset;
+    return VK_TRUE;
+}
+
+// Carve allocation out of free range of block.
+static void carveRange(
+            VkxAllocatorBlock* pBlock,
+            uint32_t rangeIndex,
+            VkDeviceSize offset,
+            VkDeviceSize size,
+            uint32_t allocationType)
+{
+    VkxAllocatorRange range = pBlock->pRanges[rangeIndex];
+    VkDeviceSize end = offset + size;
+
+    // Allocated range.
+    pBlock->pRanges[rangeIndex].offset = offset;
+    pBlock->pRanges[rangeIndex].size = size;
+    pBlock->pRanges[rangeIndex].allocationType = allocationType;
+
+    // Free range after?
+    if (end < range.offset + range.size) {
+        VkxAllocatorRange freeRange = {
+            .offset = end,
+            .size = range.offset + range.size - end,
+            .allocationType = 0
+        };
+        insertRange(pBlock, rangeIndex + 1, freeRange);
+    }
+
+    // Free range before?
+    if (range.offset < offset) {
+        VkxAllocatorRange freeRange = {
+            .offset = range.offset,
+            .size = offset - range.offset,
+            .allocationType = 0
+        };
+        insertRange(pBlock, rangeIndex, freeRange);
+    }
+
+    pBlock->allocationCount++;
+    pBlock->allocatedSize += size;
+}
+
+// Get heap statistics for memory type.
+static VkxMemoryHeapStatistics* getHeapStatistics(
+            VkxAllocator* pMemoryAllocator,
+            uint32_t memoryTypeIndex)
+{
+    uint32_t heapIndex = 
+        pMemoryAllocator->memoryTypeTable.memoryProperties.
+            memoryTypes[memoryTypeIndex].heapIndex;
+    return &pMemoryAllocator->heapStatistics[heapIndex];
+}
+
+// Create block.
+static VkResult createBlock(
+            VkxAllocator* pMemoryAllocator,
+            uint32_t memoryTypeIndex,
+            VkDeviceSize size,
+            VkBool32 dedicated,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfo,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocatorBlock** ppBlock)
+{
+    *ppBlock = NULL;
+
+    // Pad size, so non-coherent ranges may be rounded out, unless 
+    // dedicated to a resource, which requires the exact size.
+    if (!pDedicatedAllocateInfo) {
+        size = 
+            vkxMemoryTypeTablePadAllocationSize(
+                    &pMemoryAllocator->memoryTypeTable,
+                    memoryTypeIndex,
+                    size);
+    }
+
+    // Allocate memory.
+    VkMemoryAllocateInfo allocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = pDedicatedAllocateInfo,
+        .allocationSize = size,
+        .memoryTypeIndex = memoryTypeIndex
+    };
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult result = 
+        vkAllocateMemory(
+                pMemoryAllocator->device,
+                &allocateInfo, pAllocator,
+                &memory);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Initialize block with one free range.
+    VkxAllocatorBlock* pBlock = 
+        (VkxAllocatorBlock*)malloc(sizeof(VkxAllocatorBlock));
+    pBlock->memory = memory;
+    pBlock->size = size;
+    pBlock->memoryTypeIndex = memoryTypeIndex;
+    pBlock->dedicated = dedicated;
+    pBlock->allocationCount = 0;
+    pBlock->allocatedSize = 0;
+    pBlock->mapCount = 0;
+    pBlock->pMappedData = NULL;
+    pBlock->rangeCount = 1;
+    pBlock->rangeCapacity = 16;
+    pBlock->pRanges = 
+        (VkxAllocatorRange*)malloc(
+                sizeof(VkxAllocatorRange) * pBlock->rangeCapacity);
+    pBlock->pRanges[0].offset = 0;
+    pBlock->pRanges[0].size = size;
+    pBlock->pRanges[0].allocationType = 0;
+
+    // Push block.
+    if (pMemoryAllocator->blockCount == pMemoryAllocator->blockCapacity) {
+        pMemoryAllocator->blockCapacity = 
+        pMemoryAllocator->blockCapacity == 0 ? 8 :
+        pMemoryAllocator->blockCapacity * 2;
+        pMemoryAllocator->ppBlocks = 
+            (VkxAllocatorBlock**)realloc(
+                    pMemoryAllocator->ppBlocks,
+                    sizeof(VkxAllocatorBlock*) * 
+                    pMemoryAllocator->blockCapacity);
+    }
+    pMemoryAllocator->ppBlocks[pMemoryAllocator->blockCount++] = pBlock;
+    *ppBlock = pBlock;
+
+    // Update heap statistics.
+    VkxMemoryHeapStatistics* pHeapStatistics = 
+        getHeapStatistics(pMemoryAllocator, memoryTypeIndex);
+    pHeapStatistics->blockCount++;
+    pHeapStatistics->blockBytes += size;
+    return VK_SUCCESS;
+}
+
+// Destroy block.
+static void destroyBlock(
+            VkxAllocator* pMemoryAllocator,
+            uint32_t blockIndex,
+            const VkAllocationCallbacks* pAllocator)
+{
+    VkxAllocatorBlock* pBlock = pMemoryAllocator->ppBlocks[blockIndex];
+    vkFreeMemory(pMemoryAllocator->device, pBlock->memory, pAllocator);
+
+    // Update heap statistics.
+    VkxMemoryHeapStatistics* pHeapStatistics = 
+        getHeapStatistics(pMemoryAllocator, pBlock->memoryTypeIndex);
+    pHeapStatistics->blockCount--;
+    pHeapStatistics->blockBytes -= pBlock->size;
+    free(pBlock->pRanges);
+    free(pBlock);
+
+    // Erase block, order is irrelevant.
+    pMemoryAllocator->ppBlocks[blockIndex] = 
+    pMemoryAllocator->ppBlocks[--pMemoryAllocator->blockCount];
+}
+
+// Get heap budget and usage.
+static void getHeapBudget(
+            const VkxAllocator* pMemoryAllocator,
+            uint32_t heapIndex,
+            VkDeviceSize* pBudget,
+            VkDeviceSize* pUsage)
+{
+    if (pMemoryAllocator->memoryBudgetEnabled) {
+        // Query budget properties.
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+            .sType = 
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+            .pNext = NULL
+        };
+        VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &budgetProperties
+        };
+        vkGetPhysicalDeviceMemoryProperties2(
+                pMemoryAllocator->physicalDevice,
+                &memoryProperties2);
+        *pBudget = budgetProperties.heapBudget[heapIndex];
+        *pUsage = budgetProperties.heapUsage[heapIndex];
+    }
+    else {
+        // Fall back to heap size and own blocks.
+        *pBudget = 
+            pMemoryAllocator->memoryTypeTable.memoryProperties.
+                memoryHeaps[heapIndex].size;
+        *pUsage = pMemoryAllocator->heapStatistics[heapIndex].blockBytes;
+    }
+}
+
+// Reserve budget for new block, applying budget policy.
+//
+// Returns VK_TRUE if a block of the given size fits in the soft budget
+// of the heap, possibly after releasing empty blocks and evicting.
+static VkBool32 reserveBudget(
+            VkxAllocator* pMemoryAllocator,
+            uint32_t heapIndex,
+            VkDeviceSize size,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pMemoryAllocator->budgetPolicy == VKX_BUDGET_POLICY_IGNORE) {
+        return VK_TRUE;
+    }
+
+    VkBool32 releasedEmptyBlocks = VK_FALSE;
+    for (;;) {
+        // Within soft budget?
+        VkDeviceSize budget = 0;
+        VkDeviceSize usage = 0;
+        getHeapBudget(pMemoryAllocator, heapIndex, &budget, &usage);
+        VkDeviceSize softBudget = 
+            (VkDeviceSize)(budget * (double)pMemoryAllocator->budgetFraction);
+        if (usage + size <= softBudget) {
+            return VK_TRUE;
+        }
+
+        if (!releasedEmptyBlocks) {
+            // Release empty blocks in heap.
+            releasedEmptyBlocks = VK_TRUE;
+            for (uint32_t blockIndex = pMemoryAllocator->blockCount;
+                          blockIndex-- > 0;) {
+                VkxAllocatorBlock* pBlock = 
+                    pMemoryAllocator->ppBlocks[blockIndex];
+                if (pBlock->allocationCount == 0 &&
+                    pMemoryAllocator->memoryTypeTable.memoryProperties.
+                        memoryTypes[pBlock->memoryTypeIndex].heapIndex ==
+                        heapIndex) {
+                    destroyBlock(pMemoryAllocator, blockIndex, pAllocator);
+                }
+            }
+            continue;
+        }
+
+        // Evict?
+        if (pMemoryAllocator->budgetPolicy == VKX_BUDGET_POLICY_EVICT &&
+            pMemoryAllocator->pEvict &&
+            pMemoryAllocator->pEvict(
+                    heapIndex, 
+                    usage + size - softBudget,
+                    pMemoryAllocator->pEvictUserData)) {
+            continue;
+        }
+        return VK_FALSE;
+    }
+}
+
+// Create allocator.
+VkResult vkxCreateAllocator(
+            VkPhysicalDevice physicalDevice,
+            VkDevice device,
+            const VkxAllocatorCreateInfo* pCreateInfo,
+            VkxAllocator* pMemoryAllocator)
+{
+    assert(pMemoryAllocator);
+    memset(pMemoryAllocator, 0, sizeof(VkxAllocator));
+    pMemoryAllocator->physicalDevice = physicalDevice;
+    pMemoryAllocator->device = device;
+
+    // Get memory type table.
+    vkxGetMemoryTypeTable(
+            physicalDevice,
+            &pMemoryAllocator->memoryTypeTable);
+
+    // Block size.
+    pMemoryAllocator->blockSize = VKX_DEFAULT_ALLOCATOR_BLOCK_SIZE;
+    if (pCreateInfo && pCreateInfo->blockSize != 0) {
+        pMemoryAllocator->blockSize = pCreateInfo->blockSize;
+    }
+
+    // Budget.
+    pMemoryAllocator->budgetFraction = VKX_DEFAULT_ALLOCATOR_BUDGET_FRACTION;
+    if (pCreateInfo) {
+        pMemoryAllocator->memoryBudgetEnabled = 
+            pCreateInfo->memoryBudgetEnabled;
+        pMemoryAllocator->budgetPolicy = pCreateInfo->budgetPolicy;
+        if (pCreateInfo->budgetFraction != 0) {
+            pMemoryAllocator->budgetFraction = pCreateInfo->budgetFraction;
+        }
+        pMemoryAllocator->pEvict = pCreateInfo->pEvict;
+        pMemoryAllocator->pEvictUserData = pCreateInfo->pEvictUserData;
+    }
+    return VK_SUCCESS;
+}
+
+// Destroy allocator.
+void vkxDestroyAllocator(
+            VkxAllocator* pMemoryAllocator,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pMemoryAllocator) {
+        // Destroy blocks.
+        while (pMemoryAllocator->blockCount > 0) {
+            destroyBlock(
+                pMemoryAllocator, 
+                pMemoryAllocator->blockCount - 1, pAllocator);
+        }
+        // Free blocks.
+        free(pMemoryAllocator->ppBlocks);
+
+        // Nullify.
+        memset(pMemoryAllocator, 0, sizeof(VkxAllocator));
+    }
+}
+
+// Allocate memory from allocator.
+VkResult vkxAllocatorAllocateMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            VkxAllocationType allocationType,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocation* pAllocation)
+{
+    assert(pMemoryAllocator);
+    assert(pMemoryRequirements);
+    assert(pAllocation);
+    memset(pAllocation, 0, sizeof(VkxAllocation));
+    pAllocation->memoryTypeIndex = UINT32_MAX;
+
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = 
+        &pMemoryAllocator->memoryTypeTable.memoryProperties;
+    VkDeviceSize granularity = 
+        pMemoryAllocator->memoryTypeTable.bufferImageGranularity;
+    VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+
+    // Iterate memory types supporting requirement, in rank order.
+    uint32_t memoryTypeBits = pMemoryRequirements->memoryTypeBits;
+    for (uint32_t memoryTypeIndex = 
+                  vkxMemoryTypeTableFindIndex(
+                        &pMemoryAllocator->memoryTypeTable,
+                        memoryPropertyFlags,
+                        memoryTypeBits);
+                  memoryTypeIndex != UINT32_MAX;
+                  memoryTypeIndex = 
+                  vkxMemoryTypeTableFindIndex(
+                        &pMemoryAllocator->memoryTypeTable,
+                        memoryPropertyFlags,
+                        memoryTypeBits)) {
+        // Exclude from subsequent iterations.
+        memoryTypeBits &= ~((uint32_t)1 << memoryTypeIndex);
+
+        // Best fit.
+        VkxAllocatorBlock* pBestBlock = NULL;
+        uint32_t bestRangeIndex = 0;
+        VkDeviceSize bestOffset = 0;
+        VkDeviceSize bestRangeSize = VK_WHOLE_SIZE;
+
+        // Iterate blocks of memory type.
+        for (uint32_t blockIndex = 0;
+                      blockIndex < pMemoryAllocator->blockCount;
+                      blockIndex++) {
+            VkxAllocatorBlock* pBlock = pMemoryAllocator->ppBlocks[blockIndex];
+            if (pBlock->memoryTypeIndex != memoryTypeIndex ||
+                pBlock->dedicated) {
+                continue;
+            }
+
+            // Iterate free ranges.
+            for (uint32_t rangeIndex = 0;
+                          rangeIndex < pBlock->rangeCount; 
+                          rangeIndex++) {
+                VkDeviceSize offset = 0;
+                if (pBlock->pRanges[rangeIndex].size < bestRangeSize &&
+                    findPlacement(
+                        pBlock, rangeIndex,
+                        pMemoryRequirements,
+                        allocationType,
+                        granularity,
+                        &offset)) {
+                    pBestBlock = pBlock;
+                    bestRangeIndex = rangeIndex;
+                    bestOffset = offset;
+                    bestRangeSize = pBlock->pRanges[rangeIndex].size;
+                }
+            }
+        }
+
+        // Nothing found?
+        if (!pBestBlock) {
+
+            // Block size, no more than 1/8th of heap.
+            uint32_t heapIndex = 
+                pMemoryProperties->memoryTypes[memoryTypeIndex].heapIndex;
+            VkDeviceSize blockSize = pMemoryAllocator->blockSize;
+            if (blockSize > 
+                pMemoryProperties->memoryHeaps[heapIndex].size / 8) {
+                blockSize = 
+                pMemoryProperties->memoryHeaps[heapIndex].size / 8;
+            }
+
+            // Dedicated if larger than half of block size.
+            VkBool32 dedicated = 
+                pMemoryRequirements->size > blockSize / 2;
+            if (dedicated) {
+                blockSize = pMemoryRequirements->size;
+            }
+
+            // Within soft budget?
+            if (!reserveBudget(
+                    pMemoryAllocator,
+                    heapIndex,
+                    blockSize,
+                    pAllocator)) {
+                // Try next memory type.
+                result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+                continue;
+            }
+
+            // Create block.
+            result = 
+                createBlock(
+                    pMemoryAllocator, 
+                    memoryTypeIndex,
+                    blockSize,
+                    dedicated,
+                    NULL,
+                    pAllocator,
+                    &pBestBlock);
+            if (VKX_IS_ERROR(result)) {
+                // Try next memory type.
+                continue;
+            }
+
+            // Place at beginning.
+            bestRangeIndex = 0;
+            bestOffset = 0;
+        }
+
+        // Carve range.
+        carveRange(
+            pBestBlock, 
+            bestRangeIndex,
+            bestOffset,
+            pMemoryRequirements->size,
+            allocationType);
+
+        // Update heap statistics.
+        VkxMemoryHeapStatistics* pHeapStatistics = 
+            getHeapStatistics(pMemoryAllocator, memoryTypeIndex);
+        pHeapStatistics->allocationCount++;
+        pHeapStatistics->allocationBytes += pMemoryRequirements->size;
+
+        // Initialize allocation.
+        pAllocation->memoryView.memory = pBestBlock->memory;
+        pAllocation->memoryView.offset = bestOffset;
+        pAllocation->memoryView.size = pMemoryRequirements->size;
+        pAllocation->memoryTypeIndex = memoryTypeIndex;
+        pAllocation->pBlock = pBestBlock;
+        return VK_SUCCESS;
+    }
+
+    return result;
+}
+
+// Allocate dedicated memory from allocator.
+VkResult vkxAllocatorAllocateDedicatedMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            VkxAllocationType allocationType,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfo,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocation* pAllocation)
+{
+    assert(pMemoryAllocator);
+    assert(pMemoryRequirements);
+    assert(pDedicatedAllocateInfo);
+    assert(pAllocation);
+    memset(pAllocation, 0, sizeof(VkxAllocation));
+    pAllocation->memoryTypeIndex = UINT32_MAX;
+
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = 
+        &pMemoryAllocator->memoryTypeTable.memoryProperties;
+    VkResult result = VK_ERROR_INITIALIZATION_FAILED;
+
+    // Iterate memory types supporting requirement, in rank order.
+    uint32_t memoryTypeBits = pMemoryRequirements->memoryTypeBits;
+    for (uint32_t memoryTypeIndex = 
+                  vkxMemoryTypeTableFindIndex(
+                        &pMemoryAllocator->memoryTypeTable,
+                        memoryPropertyFlags,
+                        memoryTypeBits);
+                  memoryTypeIndex != UINT32_MAX;
+                  memoryTypeIndex = 
+                  vkxMemoryTypeTableFindIndex(
+                        &pMemoryAllocator->memoryTypeTable,
+                        memoryPropertyFlags,
+                        memoryTypeBits)) {
+        // Exclude from subsequent iterations.
+        memoryTypeBits &= ~((uint32_t)1 << memoryTypeIndex);
+
+        // Within soft budget?
+        uint32_t heapIndex = 
+            pMemoryProperties->memoryTypes[memoryTypeIndex].heapIndex;
+        if (!reserveBudget(
+                pMemoryAllocator,
+                heapIndex,
+                pMemoryRequirements->size,
+                pAllocator)) {
+            // Try next memory type.
+            result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+            continue;
+        }
+
+        // Create block.
+        VkxAllocatorBlock* pBlock = NULL;
+        result = 
+            createBlock(
+                pMemoryAllocator, 
+                memoryTypeIndex,
+                pMemoryRequirements->size,
+                VK_TRUE,
+                pDedicatedAllocateInfo,
+                pAllocator,
+                &pBlock);
+        if (VKX_IS_ERROR(result)) {
+            // Try next memory type.
+            continue;
+        }
+
+        // Carve entire block.
+        carveRange(
+            pBlock, 
+            0, 0,
+            pMemoryRequirements->size,
+            allocationType);
+
+        // Update heap statistics.
+        VkxMemoryHeapStatistics* pHeapStatistics = 
+            getHeapStatistics(pMemoryAllocator, memoryTypeIndex);
+        pHeapStatistics->allocationCount++;
+        pHeapStatistics->allocationBytes += pMemoryRequirements->size;
+
+        // Initialize allocation.
+        pAllocation->memoryView.memory = pBlock->memory;
+        pAllocation->memoryView.offset = 0;
+        pAllocation->memoryView.size = pMemoryRequirements->size;
+        pAllocation->memoryTypeIndex = memoryTypeIndex;
+        pAllocation->pBlock = pBlock;
+        return VK_SUCCESS;
+    }
+
+    return result;
+}
+
+// Free memory to allocator.
+void vkxAllocatorFreeMemory(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocation* pAllocation,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pMemoryAllocator);
+    if (!pAllocation || !pAllocation->pBlock) {
+        return;
+    }
+    VkxAllocatorBlock* pBlock = pAllocation->pBlock;
+
+    // Binary search for range.
+    uint32_t rangeIndexLo = 0;
+    uint32_t rangeIndexHi = pBlock->rangeCount;
+    while (rangeIndexLo + 1 < rangeIndexHi) {
+        uint32_t rangeIndex = (rangeIndexLo + rangeIndexHi) / 2;
+        if (pBlock->pRanges[rangeIndex].offset <= 
+            pAllocation->memoryView.offset) {
+            rangeIndexLo = rangeIndex;
+        }
+        else {
+            rangeIndexHi = rangeIndex;
+        }
+    }
+    uint32_t rangeIndex = rangeIndexLo;
+    assert(pBlock->pRanges[rangeIndex].offset == 
+           pAllocation->memoryView.offset);
+    assert(pBlock->pRanges[rangeIndex].allocationType != 0);
+
+    // Mark free.
+    pBlock->pRanges[rangeIndex].allocationType = 0;
+    pBlock->allocationCount--;
+    pBlock->allocatedSize -= pBlock->pRanges[rangeIndex].size;
+
+    // Merge with next range?
+    if (rangeIndex + 1 < pBlock->rangeCount &&
+        pBlock->pRanges[rangeIndex + 1].allocationType == 0) {
+        pBlock->pRanges[rangeIndex].size += 
+        pBlock->pRanges[rangeIndex + 1].size;
+        eraseRange(pBlock, rangeIndex + 1);
+    }
+
+    // Merge with previous range?
+    if (rangeIndex > 0 &&
+        pBlock->pRanges[rangeIndex - 1].allocationType == 0) {
+        pBlock->pRanges[rangeIndex - 1].size += 
+        pBlock->pRanges[rangeIndex].size;
+        eraseRange(pBlock, rangeIndex);
+    }
+
+    // Update heap statistics.
+    VkxMemoryHeapStatistics* pHeapStatistics = 
+        getHeapStatistics(pMemoryAllocator, pBlock->memoryTypeIndex);
+    pHeapStatistics->allocationCount--;
+    pHeapStatistics->allocationBytes -= pAllocation->memoryView.size;
+
+    // Nullify.
+    memset(pAllocation, 0, sizeof(VkxAllocation));
+    pAllocation->memoryTypeIndex = UINT32_MAX;
+
+    // Block empty?
+    if (pBlock->allocationCount == 0) {
+        uint32_t blockIndex = UINT32_MAX;
+        VkBool32 keepBlock = !pBlock->dedicated;
+        for (uint32_t otherBlockIndex = 0;
+                      otherBlockIndex < pMemoryAllocator->blockCount;
+                      otherBlockIndex++) {
+            VkxAllocatorBlock* pOtherBlock = 
+                pMemoryAllocator->ppBlocks[otherBlockIndex];
+            if (pOtherBlock == pBlock) {
+                blockIndex = otherBlockIndex;
+            }
+            // Another non-dedicated block of same memory type?
+            else if (pOtherBlock->memoryTypeIndex == 
+                     pBlock->memoryTypeIndex &&
+                    !pOtherBlock->dedicated) {
+                keepBlock = VK_FALSE;
+            }
+        }
+        assert(blockIndex != UINT32_MAX);
+        if (!keepBlock) {
+            // Destroy block.
+            destroyBlock(pMemoryAllocator, blockIndex, pAllocator);
+        }
+    }
+}
+
+// Map memory in allocator.
+VkResult vkxAllocatorMapMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkxAllocation* pAllocation,
+            void** ppData)
+{
+    assert(pMemoryAllocator);
+    assert(pAllocation && pAllocation->pBlock);
+    assert(ppData);
+    VkxAllocatorBlock* pBlock = pAllocation->pBlock;
+
+    // First reference? Map entire block.
+    if (pBlock->mapCount == 0) {
+        VkResult result = 
+            vkMapMemory(
+                    pMemoryAllocator->device,
+                    pBlock->memory,
+                    0, VK_WHOLE_SIZE,
+                    0, &pBlock->pMappedData);
+        if (VKX_IS_ERROR(result)) {
+            pBlock->pMappedData = NULL;
+            *ppData = NULL;
+            return result;
+        }
+    }
+    pBlock->mapCount++;
+
+    // Offset into block.
+    *ppData = 
+        (char*)pBlock->pMappedData + 
+        pAllocation->memoryView.offset;
+    return VK_SUCCESS;
+}
+
+// Unmap memory in allocator.
+void vkxAllocatorUnmapMemory(
+            VkxAllocator* pMemoryAllocator,
+            const VkxAllocation* pAllocation)
+{
+    assert(pMemoryAllocator);
+    assert(pAllocation && pAllocation->pBlock);
+    VkxAllocatorBlock* pBlock = pAllocation->pBlock;
+    assert(pBlock->mapCount > 0);
+
+    // Last reference? Unmap entire block.
+    if (--pBlock->mapCount == 0) {
+        vkUnmapMemory(pMemoryAllocator->device, pBlock->memory);
+        pBlock->pMappedData = NULL;
+    }
+}
+
+// Get memory statistics.
+void vkxGetMemoryStatistics(
+            const VkxAllocator* pMemoryAllocator,
+            VkxMemoryStatistics* pStatistics)
+{
+    assert(pMemoryAllocator);
+    assert(pStatistics);
+    memset(pStatistics, 0, sizeof(VkxMemoryStatistics));
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = 
+        &pMemoryAllocator->memoryTypeTable.memoryProperties;
+    pStatistics->memoryHeapCount = pMemoryProperties->memoryHeapCount;
+
+    // Query budget properties once for all heaps.
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties = {
+        .sType = 
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+        .pNext = NULL
+    };
+    if (pMemoryAllocator->memoryBudgetEnabled) {
+        VkPhysicalDeviceMemoryProperties2 memoryProperties2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &budgetProperties
+        };
+        vkGetPhysicalDeviceMemoryProperties2(
+                pMemoryAllocator->physicalDevice,
+                &memoryProperties2);
+    }
+
+    // Iterate heaps.
+    for (uint32_t heapIndex = 0;
+                  heapIndex < pStatistics->memoryHeapCount;
+                  heapIndex++) {
+        VkxMemoryHeapStatistics* pHeapStatistics = 
+            &pStatistics->memoryHeaps[heapIndex];
+        *pHeapStatistics = pMemoryAllocator->heapStatistics[heapIndex];
+        if (pMemoryAllocator->memoryBudgetEnabled) {
+            pHeapStatistics->budgetBytes = 
+                budgetProperties.heapBudget[heapIndex];
+            pHeapStatistics->usageBytes = 
+                budgetProperties.heapUsage[heapIndex];
+        }
+        else {
+            pHeapStatistics->budgetBytes = 
+                pMemoryProperties->memoryHeaps[heapIndex].size;
+            pHeapStatistics->usageBytes = pHeapStatistics->blockBytes;
+        }
+    }
+}
+
+// Defragmentation key.
+typedef struct DefragmentationKey_
+{
+    // Resource index.
+    uint32_t resourceIndex;
+
+    // Allocated size of source block.
+    VkDeviceSize blockAllocatedSize;
+
+    // Offset in source block.
+    VkDeviceSize offset;
+}
+DefragmentationKey;
+
+// Compare defragmentation keys, for qsort.
+//
+// Sparsest source blocks first, so that they drain, then highest 
+// offsets first, so that blocks compact towards their beginning.
+static int compareDefragmentationKeys(const void* pValue1, const void* pValue2)
+{
+    const DefragmentationKey* pKey1 = (const DefragmentationKey*)pValue1;
+    const DefragmentationKey* pKey2 = (const DefragmentationKey*)pValue2;
+    if (pKey1->blockAllocatedSize != pKey2->blockAllocatedSize) {
+        return pKey1->blockAllocatedSize < pKey2->blockAllocatedSize ? -1 : +1;
+    }
+    if (pKey1->offset != pKey2->offset) {
+        return pKey1->offset > pKey2->offset ? -1 : +1;
+    }
+    return pKey1->resourceIndex < pKey2->resourceIndex ? -1 : +1;
+}
+
+// Find block index, or UINT32_MAX.
+static uint32_t findBlockIndex(
+            const VkxAllocator* pMemoryAllocator,
+            const VkxAllocatorBlock* pBlock)
+{
+    for (uint32_t blockIndex = 0;
+                  blockIndex < pMemoryAllocator->blockCount;
+                  blockIndex++) {
+        if (pMemoryAllocator->ppBlocks[blockIndex] == pBlock) {
+            return blockIndex;
+        }
+    }
+    return UINT32_MAX;
+}
+
+// Record defragmentation copies.
+static void recordDefragmentationCopies(
+            VkCommandBuffer commandBuffer,
+            const VkxDefragmentationResource* pResources,
+            const VkxDefragmentation* pDefragmentation)
+{
+    // Allocate image memory barriers, at most two per move.
+    uint32_t imageMemoryBarrierCount = 0;
+    VkImageMemoryBarrier* pImageMemoryBarriers = 
+        (VkImageMemoryBarrier*)malloc(
+                sizeof(VkImageMemoryBarrier) * 
+                pDefragmentation->moveCount * 2);
+
+    // Image memory barrier template.
+    VkImageMemoryBarrier imageMemoryBarrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = NULL,
+        .srcAccessMask = 0,
+        .dstAccessMask = 0,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = VK_NULL_HANDLE,
+        .subresourceRange = {
+            .aspectMask = 0,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS
+        }
+    };
+
+    // Transition old images to transfer source, new images to 
+    // transfer destination.
+    for (uint32_t moveIndex = 0;
+                  moveIndex < pDefragmentation->moveCount;
+                  moveIndex++) {
+        const VkxDefragmentationMove* pMove = 
+            &pDefragmentation->pMoves[moveIndex];
+        const VkxDefragmentationResource* pResource = 
+            &pResources[pMove->resourceIndex];
+        if (pMove->newImage != VK_NULL_HANDLE) {
+            imageMemoryBarrier.subresourceRange.aspectMask = 
+                pResource->imageAspectMask;
+            imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            imageMemoryBarrier.oldLayout = pResource->imageLayout;
+            imageMemoryBarrier.newLayout = 
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            imageMemoryBarrier.image = *pMove->pImage;
+            pImageMemoryBarriers[imageMemoryBarrierCount++] = 
+                imageMemoryBarrier;
+            imageMemoryBarrier.srcAccessMask = 0;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            imageMemoryBarrier.newLayout = 
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageMemoryBarrier.image = pMove->newImage;
+            pImageMemoryBarriers[imageMemoryBarrierCount++] = 
+                imageMemoryBarrier;
+        }
+    }
+    {
+        VkMemoryBarrier memoryBarrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = NULL,
+            .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+        };
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                1, &memoryBarrier,
+                0, NULL,
+                imageMemoryBarrierCount, pImageMemoryBarriers);
+    }
+
+    // Record copies.
+    for (uint32_t moveIndex = 0;
+                  moveIndex < pDefragmentation->moveCount;
+                  moveIndex++) {
+        const VkxDefragmentationMove* pMove = 
+            &pDefragmentation->pMoves[moveIndex];
+        const VkxDefragmentationResource* pResource = 
+            &pResources[pMove->resourceIndex];
+        if (pMove->newBuffer != VK_NULL_HANDLE) {
+            // Copy buffer.
+            VkBufferCopy region = {
+                .srcOffset = 0,
+                .dstOffset = 0,
+                .size = pResource->pBufferCreateInfo->size
+            };
+            vkCmdCopyBuffer(
+                    commandBuffer,
+                    *pMove->pBuffer,
+                    pMove->newBuffer,
+                    1, &region);
+        }
+        else {
+            // Copy image, one region per mip level.
+            const VkImageCreateInfo* pImageCreateInfo = 
+                pResource->pImageCreateInfo;
+            VkImageCopy* pRegions = 
+                (VkImageCopy*)VKX_LOCAL_MALLOC(
+                        sizeof(VkImageCopy) * pImageCreateInfo->mipLevels);
+            for (uint32_t mipLevel = 0;
+                          mipLevel < pImageCreateInfo->mipLevels;
+                          mipLevel++) {
+                VkImageSubresourceLayers subresource = {
+                    .aspectMask = pResource->imageAspectMask,
+                    .mipLevel = mipLevel,
+                    .baseArrayLayer = 0,
+                    .layerCount = pImageCreateInfo->arrayLayers
+                };
+                VkExtent3D extent = pImageCreateInfo->extent;
+                extent.width = extent.width >> mipLevel;
+                extent.height = extent.height >> mipLevel;
+                extent.depth = extent.depth >> mipLevel;
+                pRegions[mipLevel].srcSubresource = subresource;
+                pRegions[mipLevel].srcOffset.x = 0;
+                pRegions[mipLevel].srcOffset.y = 0;
+                pRegions[mipLevel].srcOffset.z = 0;
+                pRegions[mipLevel].dstSubresource = subresource;
+                pRegions[mipLevel].dstOffset = pRegions[mipLevel].srcOffset;
+                pRegions[mipLevel].extent.width = 
+                    extent.width ? extent.width : 1;
+                pRegions[mipLevel].extent.height = 
+                    extent.height ? extent.height : 1;
+                pRegions[mipLevel].extent.depth = 
+                    extent.depth ? extent.depth : 1;
+            }
+            vkCmdCopyImage(
+                    commandBuffer,
+                    *pMove->pImage,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    pMove->newImage,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    pImageCreateInfo->mipLevels, pRegions);
+            VKX_LOCAL_FREE(pRegions);
+        }
+    }
+
+    // Transition images back to their layout.
+    imageMemoryBarrierCount = 0;
+    for (uint32_t moveIndex = 0;
+                  moveIndex < pDefragmentation->moveCount;
+                  moveIndex++) {
+        const VkxDefragmentationMove* pMove = 
+            &pDefragmentation->pMoves[moveIndex];
+        const VkxDefragmentationResource* pResource = 
+            &pResources[pMove->resourceIndex];
+        if (pMove->newImage != VK_NULL_HANDLE) {
+            imageMemoryBarrier.subresourceRange.aspectMask = 
+                pResource->imageAspectMask;
+            imageMemoryBarrier.srcAccessMask = 0;
+            imageMemoryBarrier.dstAccessMask = 
+                VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+            imageMemoryBarrier.oldLayout = 
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            imageMemoryBarrier.newLayout = pResource->imageLayout;
+            imageMemoryBarrier.image = *pMove->pImage;
+            pImageMemoryBarriers[imageMemoryBarrierCount++] = 
+                imageMemoryBarrier;
+            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageMemoryBarrier.oldLayout = 
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageMemoryBarrier.image = pMove->newImage;
+            pImageMemoryBarriers[imageMemoryBarrierCount++] = 
+                imageMemoryBarrier;
+        }
+    }
+    {
+        VkMemoryBarrier memoryBarrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = NULL,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = 
+                VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                1, &memoryBarrier,
+                0, NULL,
+                imageMemoryBarrierCount, pImageMemoryBarriers);
+    }
+
+    // Free image memory barriers.
+    free(pImageMemoryBarriers);
+}
+
+// Begin defragmentation.
+VkResult vkxAllocatorBeginDefragmentation(
+            VkxAllocator* pMemoryAllocator,
+            VkCommandBuffer commandBuffer,
+            uint32_t resourceCount,
+            const VkxDefragmentationResource* pResources,
+            VkDeviceSize maxMovedBytes,
+            const VkAllocationCallbacks* pAllocator,
+            VkxDefragmentation* pDefragmentation)
+{
+    assert(pMemoryAllocator);
+    assert(pResources || resourceCount == 0);
+    assert(pDefragmentation);
+    memset(pDefragmentation, 0, sizeof(VkxDefragmentation));
+    if (resourceCount == 0) {
+        return VK_SUCCESS;
+    }
+    VkDevice device = pMemoryAllocator->device;
+    VkDeviceSize granularity = 
+        pMemoryAllocator->memoryTypeTable.bufferImageGranularity;
+
+    // Allocate moves, at most one per resource.
+    pDefragmentation->pMoves = 
+        (VkxDefragmentationMove*)malloc(
+                sizeof(VkxDefragmentationMove) * resourceCount);
+
+    // Order candidates, skipping dedicated blocks.
+    uint32_t keyCount = 0;
+    DefragmentationKey* pKeys = 
+        (DefragmentationKey*)malloc(
+                sizeof(DefragmentationKey) * resourceCount);
+    for (uint32_t resourceIndex = 0;
+                  resourceIndex < resourceCount;
+                  resourceIndex++) {
+        const VkxAllocation* pAllocation = 
+            pResources[resourceIndex].pAllocation;
+        if (pAllocation->pBlock && !pAllocation->pBlock->dedicated) {
+            pKeys[keyCount].resourceIndex = resourceIndex;
+            pKeys[keyCount].blockAllocatedSize = 
+                pAllocation->pBlock->allocatedSize;
+            pKeys[keyCount].offset = pAllocation->memoryView.offset;
+            keyCount++;
+        }
+    }
+    qsort(
+        pKeys, keyCount, 
+        sizeof(DefragmentationKey), 
+        compareDefragmentationKeys);
+
+    // Iterate candidates.
+    VkResult result = VK_SUCCESS;
+    for (uint32_t keyIndex = 0; keyIndex < keyCount; keyIndex++) {
+        uint32_t resourceIndex = pKeys[keyIndex].resourceIndex;
+        const VkxDefragmentationResource* pResource = 
+            &pResources[resourceIndex];
+        const VkxAllocation* pOldAllocation = pResource->pAllocation;
+        VkxAllocatorBlock* pOldBlock = pOldAllocation->pBlock;
+        uint32_t oldBlockIndex = findBlockIndex(pMemoryAllocator, pOldBlock);
+
+        // Byte limit reached?
+        if (maxMovedBytes != VK_WHOLE_SIZE &&
+            pDefragmentation->movedBytes + 
+            pOldAllocation->memoryView.size > maxMovedBytes) {
+            result = VK_INCOMPLETE;
+            break;
+        }
+
+        // Create new resource.
+        VkBuffer newBuffer = VK_NULL_HANDLE;
+        VkImage newImage = VK_NULL_HANDLE;
+        VkMemoryRequirements memoryRequirements;
+        uint32_t allocationType = VKX_ALLOCATION_TYPE_LINEAR;
+        if (pResource->pBuffer) {
+            if (VKX_IS_ERROR(
+                    vkCreateBuffer(
+                        device,
+                        pResource->pBufferCreateInfo, pAllocator,
+                        &newBuffer))) {
+                continue;
+            }
+            vkGetBufferMemoryRequirements(
+                    device, newBuffer, &memoryRequirements);
+        }
+        else {
+            if (VKX_IS_ERROR(
+                    vkCreateImage(
+                        device,
+                        pResource->pImageCreateInfo, pAllocator,
+                        &newImage))) {
+                continue;
+            }
+            vkGetImageMemoryRequirements(
+                    device, newImage, &memoryRequirements);
+            if (pResource->pImageCreateInfo->tiling != 
+                VK_IMAGE_TILING_LINEAR) {
+                allocationType = VKX_ALLOCATION_TYPE_OPTIMAL;
+            }
+        }
+
+        // Best fit, in denser blocks of same memory type, or earlier
+        // in same block.
+        VkxAllocatorBlock* pBestBlock = NULL;
+        uint32_t bestRangeIndex = 0;
+        VkDeviceSize bestOffset = 0;
+        VkDeviceSize bestRangeSize = VK_WHOLE_SIZE;
+        if (memoryRequirements.memoryTypeBits & 
+                ((uint32_t)1 << pOldAllocation->memoryTypeIndex)) {
+            for (uint32_t blockIndex = 0;
+                          blockIndex < pMemoryAllocator->blockCount;
+                          blockIndex++) {
+                VkxAllocatorBlock* pBlock = 
+                    pMemoryAllocator->ppBlocks[blockIndex];
+                if (pBlock->memoryTypeIndex != 
+                    pOldAllocation->memoryTypeIndex ||
+                    pBlock->dedicated) {
+                    continue;
+                }
+
+                // Denser block? Break ties by index, so that moves 
+                // never cycle between blocks.
+                if (pBlock != pOldBlock &&
+                    pBlock->allocatedSize <= pOldBlock->allocatedSize &&
+                   (pBlock->allocatedSize < pOldBlock->allocatedSize ||
+                    blockIndex > oldBlockIndex)) {
+                    continue;
+                }
+
+                // Iterate free ranges.
+                for (uint32_t rangeIndex = 0;
+                              rangeIndex < pBlock->rangeCount; 
+                              rangeIndex++) {
+                    // Same block? Only earlier ranges.
+                    if (pBlock == pOldBlock &&
+                        pBlock->pRanges[rangeIndex].offset >= 
+                        pOldAllocation->memoryView.offset) {
+                        break;
+                    }
+                    VkDeviceSize offset = 0;
+                    if (pBlock->pRanges[rangeIndex].size < bestRangeSize &&
+                        findPlacement(
+                            pBlock, rangeIndex,
+                            &memoryRequirements,
+                            allocationType,
+                            granularity,
+                            &offset)) {
+                        pBestBlock = pBlock;
+                        bestRangeIndex = rangeIndex;
+                        bestOffset = offset;
+                        bestRangeSize = pBlock->pRanges[rangeIndex].size;
+                    }
+                }
+            }
+        }
+
+        // Nothing found?
+        if (!pBestBlock) {
+            vkDestroyBuffer(device, newBuffer, pAllocator);
+            vkDestroyImage(device, newImage, pAllocator);
+            continue;
+        }
+
+        // Carve range.
+        carveRange(
+            pBestBlock,
+            bestRangeIndex,
+            bestOffset,
+            memoryRequirements.size,
+            allocationType);
+
+        // Update heap statistics.
+        VkxMemoryHeapStatistics* pHeapStatistics = 
+            getHeapStatistics(
+                    pMemoryAllocator, 
+                    pOldAllocation->memoryTypeIndex);
+        pHeapStatistics->allocationCount++;
+        pHeapStatistics->allocationBytes += memoryRequirements.size;
+
+        // Initialize move.
+        VkxDefragmentationMove* pMove = 
+            &pDefragmentation->pMoves[pDefragmentation->moveCount];
+        pMove->resourceIndex = resourceIndex;
+        pMove->oldMemoryView = pOldAllocation->memoryView;
+        pMove->newMemoryView.memory = pBestBlock->memory;
+        pMove->newMemoryView.offset = bestOffset;
+        pMove->newMemoryView.size = memoryRequirements.size;
+        pMove->newBuffer = newBuffer;
+        pMove->newImage = newImage;
+        pMove->newAllocation.memoryView = pMove->newMemoryView;
+        pMove->newAllocation.memoryTypeIndex = 
+            pOldAllocation->memoryTypeIndex;
+        pMove->newAllocation.pBlock = pBestBlock;
+        pMove->pAllocation = pResource->pAllocation;
+        pMove->pBuffer = pResource->pBuffer;
+        pMove->pImage = pResource->pImage;
+
+        // Bind memory.
+        VkResult bindResult = 
+            newBuffer != VK_NULL_HANDLE ?
+            vkBindBufferMemory(
+                    device, newBuffer, 
+                    pBestBlock->memory, bestOffset) :
+            vkBindImageMemory(
+                    device, newImage, 
+                    pBestBlock->memory, bestOffset);
+        if (VKX_IS_ERROR(bindResult)) {
+            // Release.
+            vkxAllocatorFreeMemory(
+                    pMemoryAllocator, 
+                    &pMove->newAllocation, pAllocator);
+            vkDestroyBuffer(device, newBuffer, pAllocator);
+            vkDestroyImage(device, newImage, pAllocator);
+            continue;
+        }
+        pDefragmentation->moveCount++;
+        pDefragmentation->movedBytes += pOldAllocation->memoryView.size;
+    }
+
+    // Free keys.
+    free(pKeys);
+
+    // Record copies.
+    if (pDefragmentation->moveCount > 0) {
+        recordDefragmentationCopies(
+                commandBuffer, 
+                pResources, 
+                pDefragmentation);
+    }
+    return result;
+}
+
+// End defragmentation.
+void vkxAllocatorEndDefragmentation(
+            VkxAllocator* pMemoryAllocator,
+            VkxDefragmentation* pDefragmentation,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pMemoryAllocator);
+    assert(pDefragmentation);
+    VkDevice device = pMemoryAllocator->device;
+    for (uint32_t moveIndex = 0;
+                  moveIndex < pDefragmentation->moveCount;
+                  moveIndex++) {
+        VkxDefragmentationMove* pMove = &pDefragmentation->pMoves[moveIndex];
+
+        // Replace resource.
+        if (pMove->pBuffer) {
+            vkDestroyBuffer(device, *pMove->pBuffer, pAllocator);
+            *pMove->pBuffer = pMove->newBuffer;
+        }
+        else {
+            vkDestroyImage(device, *pMove->pImage, pAllocator);
+            *pMove->pImage = pMove->newImage;
+        }
+
+        // Replace allocation.
+        vkxAllocatorFreeMemory(
+                pMemoryAllocator, 
+                pMove->pAllocation, pAllocator);
+        *pMove->pAllocation = pMove->newAllocation;
+    }
+
+    // Free moves.
+    free(pDefragmentation->pMoves);
+
+    // Nullify.
+    memset(pDefragmentation, 0, sizeof(VkxDefragmentation));
+}
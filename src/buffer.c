@@ -33,9 +33,51 @@
 #include <vulkanx/result.h>
 #include <vulkanx/buffer.h>
 
+// Get buffer memory requirements, and dedicated allocate info which 
+// names the buffer if the implementation prefers or requires a dedicated 
+// allocation, or nothing otherwise.
+static void getBufferMemoryRequirements(
+            VkDevice device,
+            VkBuffer buffer,
+            VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfo)
+{
+    // Get memory requirements.
+    VkMemoryDedicatedRequirements dedicatedRequirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+        .pNext = NULL,
+        .prefersDedicatedAllocation = VK_FALSE,
+        .requiresDedicatedAllocation = VK_FALSE
+    };
+    VkMemoryRequirements2 memoryRequirements2 = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicatedRequirements
+    };
+    VkBufferMemoryRequirementsInfo2 memoryRequirementsInfo2 = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext = NULL,
+        .buffer = buffer
+    };
+    vkGetBufferMemoryRequirements2(
+            device, 
+            &memoryRequirementsInfo2, 
+            &memoryRequirements2);
+    *pMemoryRequirements = memoryRequirements2.memoryRequirements;
+
+    // Dedicated allocate info.
+    pDedicatedAllocateInfo->sType = 
+        VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    pDedicatedAllocateInfo->pNext = NULL;
+    pDedicatedAllocateInfo->image = VK_NULL_HANDLE;
+    pDedicatedAllocateInfo->buffer = 
+        dedicatedRequirements.prefersDedicatedAllocation ||
+        dedicatedRequirements.requiresDedicatedAllocation ? 
+        buffer : VK_NULL_HANDLE;
+}
+
 // Create buffer.
 VkResult vkxCreateBuffer(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             const VkBufferCreateInfo* pBufferCreateInfo,
             const VkMemoryPropertyFlags memoryPropertyFlags,
@@ -48,6 +90,7 @@ VkResult vkxCreateBuffer(
     // Nullify.
     pBuffer->buffer = VK_NULL_HANDLE;
     pBuffer->memory = VK_NULL_HANDLE;
+    pBuffer->pMappedData = NULL;
     
     {
         // Create buffer.
@@ -65,15 +108,17 @@ VkResult vkxCreateBuffer(
     {
         // Get memory requirements.
         VkMemoryRequirements memoryRequirements;
-        vkGetBufferMemoryRequirements(
+        VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo;
+        getBufferMemoryRequirements(
                 device,
                 pBuffer->buffer,
-                &memoryRequirements);
+                &memoryRequirements,
+                &dedicatedAllocateInfo);
 
         // Find memory type index.
         uint32_t memoryTypeIndex = 
-            vkxFindMemoryTypeIndex(
-                    physicalDevice,
+            vkxMemoryTypeTableFindIndex(
+                    pMemoryTypeTable,
                     memoryPropertyFlags,
                     memoryRequirements.memoryTypeBits);
         if (memoryTypeIndex == UINT32_MAX) {
@@ -82,14 +127,25 @@ VkResult vkxCreateBuffer(
             return VK_ERROR_INITIALIZATION_FAILED;
         }
 
-        // Memory allocate info.
+        // Memory allocate info, dedicated if preferred.
         VkMemoryAllocateInfo memoryAllocateInfo = {
             .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext = NULL,
+            .pNext = 
+                dedicatedAllocateInfo.buffer != VK_NULL_HANDLE ?
+                &dedicatedAllocateInfo : NULL,
             .allocationSize = memoryRequirements.size,
             .memoryTypeIndex = memoryTypeIndex
         };
 
+        // Not dedicated? Pad allocation size.
+        if (dedicatedAllocateInfo.buffer == VK_NULL_HANDLE) {
+            memoryAllocateInfo.allocationSize = 
+                vkxMemoryTypeTablePadAllocationSize(
+                        pMemoryTypeTable,
+                        memoryTypeIndex,
+                        memoryRequirements.size);
+        }
+
         // Allocate memory.
         VkResult result =
             vkAllocateMemory(
@@ -104,19 +160,37 @@ VkResult vkxCreateBuffer(
         }
     }
 
-    // Bind memory.
-    VkResult result = 
-        vkBindBufferMemory(
-                device,
-                pBuffer->buffer,
-                pBuffer->memory,
-                0);
-    if (VKX_IS_ERROR(result)) {
-        // Destroy buffer.
-        vkxDestroyBuffer(device, pBuffer, pAllocator);
-        // Fall through.
+    {
+        // Bind memory.
+        VkResult result = 
+            vkBindBufferMemory(
+                    device,
+                    pBuffer->buffer,
+                    pBuffer->memory,
+                    0);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy buffer.
+            vkxDestroyBuffer(device, pBuffer, pAllocator);
+            return result;
+        }
     }
-    return result;
+
+    // Host visible? Map persistently.
+    if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        VkResult result = 
+            vkMapMemory(
+                    device,
+                    pBuffer->memory,
+                    0, VK_WHOLE_SIZE,
+                    0, &pBuffer->pMappedData);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy buffer.
+            pBuffer->pMappedData = NULL;
+            vkxDestroyBuffer(device, pBuffer, pAllocator);
+            return result;
+        }
+    }
+    return VK_SUCCESS;
 }
 
 // Destroy buffer.
@@ -132,7 +206,7 @@ void vkxDestroyBuffer(
                 pBuffer->buffer, 
                 pAllocator);
 
-        // Free memory.
+        // Free memory, implicitly unmapped.
         vkFreeMemory(
                 device, 
                 pBuffer->memory, 
@@ -141,12 +215,879 @@ void vkxDestroyBuffer(
         // Nullify.
         pBuffer->buffer = VK_NULL_HANDLE;
         pBuffer->memory = VK_NULL_HANDLE;
+        pBuffer->pMappedData = NULL;
+    }
+}
+
+// Create staging buffer.
+VkResult vkxCreateStagingBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxBuffer* pBuffer)
+{
+    // Buffer create info.
+    VkBufferCreateInfo bufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = NULL,
+        .flags = 0,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = NULL
+    };
+
+    // Preferred memory property flags, cached for readback.
+    VkMemoryPropertyFlags memoryPropertyFlags = 
+        (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) ?
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | 
+        VK_MEMORY_PROPERTY_HOST_CACHED_BIT :
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    // Create buffer.
+    VkResult result = 
+        vkxCreateBuffer(
+                pMemoryTypeTable,
+                device,
+                &bufferCreateInfo,
+                memoryPropertyFlags,
+                pAllocator,
+                pBuffer);
+    if (result == VK_ERROR_INITIALIZATION_FAILED) {
+        // No preferred memory type, fall back to any host-visible.
+        result = 
+            vkxCreateBuffer(
+                    pMemoryTypeTable,
+                    device,
+                    &bufferCreateInfo,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                    pAllocator,
+                    pBuffer);
+    }
+    return result;
+}
+
+// Import host buffer.
+VkResult vkxImportHostBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkPhysicalDevice physicalDevice,
+            VkDevice device,
+            void* pHostPointer,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxBuffer* pBuffer)
+{
+    assert(pMemoryTypeTable);
+    assert(pHostPointer);
+    assert(pBuffer);
+    memset(pBuffer, 0, sizeof(VkxBuffer));
+
+    // Extension enabled?
+    PFN_vkGetMemoryHostPointerPropertiesEXT 
+        pfnGetMemoryHostPointerProperties = 
+            (PFN_vkGetMemoryHostPointerPropertiesEXT)
+            vkGetDeviceProcAddr(
+                    device, 
+                    "vkGetMemoryHostPointerPropertiesEXT");
+
+    // Memory host pointer properties.
+    VkMemoryHostPointerPropertiesEXT hostPointerProperties = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT,
+        .pNext = NULL,
+        .memoryTypeBits = 0
+    };
+    if (pfnGetMemoryHostPointerProperties) {
+
+        // Get minimum imported host pointer alignment.
+        VkPhysicalDeviceExternalMemoryHostPropertiesEXT 
+            externalMemoryHostProperties = {
+            .sType = 
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT,
+            .pNext = NULL,
+            .minImportedHostPointerAlignment = 0
+        };
+        VkPhysicalDeviceProperties2 properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &externalMemoryHostProperties
+        };
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+        VkDeviceSize alignment = 
+            externalMemoryHostProperties.minImportedHostPointerAlignment;
+
+        // Aligned?
+        if (alignment != 0 &&
+            (uintptr_t)pHostPointer % alignment == 0 &&
+            size % alignment == 0) {
+            // Get memory host pointer properties.
+            if (VKX_IS_ERROR(
+                    pfnGetMemoryHostPointerProperties(
+                            device,
+                            VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                            pHostPointer,
+                            &hostPointerProperties))) {
+                hostPointerProperties.memoryTypeBits = 0;
+            }
+        }
+    }
+
+    // Import.
+    if (hostPointerProperties.memoryTypeBits != 0) {
+
+        // External memory buffer create info.
+        VkExternalMemoryBufferCreateInfo externalMemoryBufferCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+            .pNext = NULL,
+            .handleTypes = 
+                VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT
+        };
+
+        // Buffer create info.
+        VkBufferCreateInfo bufferCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = &externalMemoryBufferCreateInfo,
+            .flags = 0,
+            .size = size,
+            .usage = usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 0,
+            .pQueueFamilyIndices = NULL
+        };
+
+        {
+            // Create buffer.
+            VkResult result = 
+                vkCreateBuffer(
+                        device, 
+                        &bufferCreateInfo, 
+                        pAllocator, 
+                        &pBuffer->buffer);
+            if (VKX_IS_ERROR(result)) {
+                memset(pBuffer, 0, sizeof(VkxBuffer));
+                return result;
+            }
+        }
+
+        // Find memory type index, prefer host-coherent.
+        VkMemoryRequirements memoryRequirements;
+        vkGetBufferMemoryRequirements(
+                device, 
+                pBuffer->buffer, 
+                &memoryRequirements);
+        uint32_t memoryTypeBits = 
+            memoryRequirements.memoryTypeBits &
+            hostPointerProperties.memoryTypeBits;
+        uint32_t memoryTypeIndex = 
+            vkxMemoryTypeTableFindIndex(
+                    pMemoryTypeTable,
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    memoryTypeBits);
+        if (memoryTypeIndex == UINT32_MAX) {
+            memoryTypeIndex = 
+                vkxMemoryTypeTableFindIndex(
+                        pMemoryTypeTable, 
+                        0, memoryTypeBits);
+        }
+
+        // Import covers requirements? Size is already a multiple of
+        // minimum imported host pointer alignment.
+        if (memoryTypeIndex != UINT32_MAX &&
+            memoryRequirements.size <= size) {
+            // Import memory host pointer info.
+            VkImportMemoryHostPointerInfoEXT importInfo = {
+                .sType = 
+                    VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+                .pNext = NULL,
+                .handleType = 
+                    VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+                .pHostPointer = pHostPointer
+            };
+
+            // Memory allocate info.
+            VkMemoryAllocateInfo memoryAllocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                .pNext = &importInfo,
+                .allocationSize = size,
+                .memoryTypeIndex = memoryTypeIndex
+            };
+
+            // Import memory.
+            VkResult result = 
+                vkAllocateMemory(
+                        device,
+                        &memoryAllocateInfo,
+                        pAllocator,
+                        &pBuffer->memory);
+            if (VKX_IS_ERROR(result)) {
+                pBuffer->memory = VK_NULL_HANDLE;
+            }
+            else {
+                // Bind.
+                result = 
+                    vkBindBufferMemory(
+                            device, 
+                            pBuffer->buffer, 
+                            pBuffer->memory, 0);
+                if (!VKX_IS_ERROR(result)) {
+                    pBuffer->pMappedData = pHostPointer;
+                    return result;
+                }
+            }
+        }
+
+        // Import failed, fall back.
+        vkxDestroyBuffer(device, pBuffer, pAllocator);
+    }
+
+    {
+        // Create staging buffer.
+        VkResult result = 
+            vkxCreateStagingBuffer(
+                    pMemoryTypeTable,
+                    device,
+                    size,
+                    usage,
+                    pAllocator,
+                    pBuffer);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    // Copy data.
+    memcpy(pBuffer->pMappedData, pHostPointer, size);
+
+    // Flush, in case not host-coherent.
+    VkxDeviceMemoryView memoryView = {
+        .memory = pBuffer->memory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+    VkResult result = 
+        vkxFlushMemoryViews(
+                pMemoryTypeTable,
+                device,
+                1, &memoryView);
+    if (VKX_IS_ERROR(result)) {
+        vkxDestroyBuffer(device, pBuffer, pAllocator);
+    }
+    return result;
+}
+
+// Create staging pool.
+void vkxCreateStagingPool(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkxStagingPool* pStagingPool)
+{
+    assert(pMemoryTypeTable);
+    assert(pStagingPool);
+    memset(pStagingPool, 0, sizeof(VkxStagingPool));
+    pStagingPool->device = device;
+    pStagingPool->memoryTypeTable = *pMemoryTypeTable;
+}
+
+// Destroy staging pool.
+void vkxDestroyStagingPool(
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pStagingPool) {
+        for (uint32_t blockIndex = 0;
+                      blockIndex < pStagingPool->blockCount;
+                      blockIndex++) {
+            // Destroy block.
+            VkxStagingBlock* pBlock = pStagingPool->ppBlocks[blockIndex];
+            assert(!pBlock->acquired);
+            vkxDestroyBuffer(
+                    pStagingPool->device, 
+                    &pBlock->buffer, pAllocator);
+            free(pBlock);
+        }
+        // Free blocks.
+        free(pStagingPool->ppBlocks);
+
+        // Nullify.
+        memset(pStagingPool, 0, sizeof(VkxStagingPool));
+    }
+}
+
+// Staging pool acquire.
+VkResult vkxStagingPoolAcquire(
+            VkxStagingPool* pStagingPool,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxStagingBlock** ppBlock)
+{
+    assert(pStagingPool);
+    assert(ppBlock);
+    *ppBlock = NULL;
+
+    // Round up to size class.
+    VkDeviceSize classSize = VKX_STAGING_POOL_MIN_BLOCK_SIZE;
+    while (classSize < size) {
+        classSize *= 2;
+    }
+
+    // Find free block in size class.
+    for (uint32_t blockIndex = 0;
+                  blockIndex < pStagingPool->blockCount;
+                  blockIndex++) {
+        VkxStagingBlock* pBlock = pStagingPool->ppBlocks[blockIndex];
+        if (pBlock->acquired ||
+            pBlock->size != classSize ||
+            pBlock->usage != usage) {
+            continue;
+        }
+
+        // Device still using block?
+        if (pBlock->fence != VK_NULL_HANDLE) {
+            if (vkGetFenceStatus(
+                    pStagingPool->device, 
+                    pBlock->fence) != VK_SUCCESS) {
+                continue;
+            }
+            pBlock->fence = VK_NULL_HANDLE;
+        }
+
+        // Acquire.
+        pBlock->acquired = VK_TRUE;
+        *ppBlock = pBlock;
+        return VK_SUCCESS;
+    }
+
+    // Create staging buffer.
+    VkxBuffer buffer;
+    VkResult result = 
+        vkxCreateStagingBuffer(
+                &pStagingPool->memoryTypeTable,
+                pStagingPool->device,
+                classSize,
+                usage,
+                pAllocator,
+                &buffer);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Push block.
+    if (pStagingPool->blockCount == pStagingPool->blockCapacity) {
+        pStagingPool->blockCapacity = 
+        pStagingPool->blockCapacity == 0 ? 8 :
+        pStagingPool->blockCapacity * 2;
+        pStagingPool->ppBlocks = 
+            (VkxStagingBlock**)realloc(
+                    pStagingPool->ppBlocks,
+                    sizeof(VkxStagingBlock*) * 
+                    pStagingPool->blockCapacity);
+    }
+    VkxStagingBlock* pBlock = 
+        (VkxStagingBlock*)malloc(sizeof(VkxStagingBlock));
+    pBlock->buffer = buffer;
+    pBlock->size = classSize;
+    pBlock->usage = usage;
+    pBlock->acquired = VK_TRUE;
+    pBlock->fence = VK_NULL_HANDLE;
+    pStagingPool->ppBlocks[pStagingPool->blockCount++] = pBlock;
+    *ppBlock = pBlock;
+    return VK_SUCCESS;
+}
+
+// Staging pool release.
+void vkxStagingPoolRelease(
+            VkxStagingPool* pStagingPool,
+            VkxStagingBlock* pBlock,
+            VkFence fence)
+{
+    assert(pStagingPool);
+    assert(pBlock && pBlock->acquired);
+    (void)pStagingPool;
+    pBlock->acquired = VK_FALSE;
+    pBlock->fence = fence;
+}
+
+// Acquire staging buffer.
+VkResult vkxAcquireStagingBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize size,
+            VkBufferUsageFlags usage,
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator,
+            VkxStagingBlock** ppStagingBlock,
+            VkxBuffer* pStagingBuffer)
+{
+    assert(ppStagingBlock);
+    assert(pStagingBuffer);
+    *ppStagingBlock = NULL;
+    if (pStagingPool) {
+        // Acquire from staging pool.
+        VkResult result = 
+            vkxStagingPoolAcquire(
+                    pStagingPool,
+                    size,
+                    usage,
+                    pAllocator,
+                    ppStagingBlock);
+        if (VKX_IS_ERROR(result)) {
+            memset(pStagingBuffer, 0, sizeof(VkxBuffer));
+            return result;
+        }
+        *pStagingBuffer = (*ppStagingBlock)->buffer;
+        return result;
+    }
+
+    // Create staging buffer.
+    return 
+        vkxCreateStagingBuffer(
+                pMemoryTypeTable,
+                device,
+                size,
+                usage,
+                pAllocator,
+                pStagingBuffer);
+}
+
+// Release staging buffer.
+void vkxReleaseStagingBuffer(
+            VkDevice device,
+            VkxStagingPool* pStagingPool,
+            VkxStagingBlock* pStagingBlock,
+            VkxBuffer* pStagingBuffer,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pStagingBlock) {
+        // Release to staging pool, transfer already complete.
+        vkxStagingPoolRelease(pStagingPool, pStagingBlock, VK_NULL_HANDLE);
+    }
+    else {
+        // Destroy staging buffer.
+        vkxDestroyBuffer(device, pStagingBuffer, pAllocator);
+    }
+}
+
+// Begin transfer ticket.
+VkResult vkxBeginTransferTicket(
+            VkDevice device,
+            VkCommandPool commandPool,
+            VkxTransferTicket* pTicket)
+{
+    assert(pTicket);
+    memset(pTicket, 0, sizeof(VkxTransferTicket));
+    pTicket->device = device;
+    pTicket->commandPool = commandPool;
+
+    // Command buffer allocate info.
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = NULL,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool = commandPool,
+        .commandBufferCount = 1
+    };
+
+    // Command buffer begin info.
+    VkCommandBufferBeginInfo commandBufferBeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = NULL,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = NULL
+    };
+
+    // Allocate and begin command buffer.
+    VkResult result = 
+        vkxAllocateAndBeginCommandBuffers(
+                device,
+                &commandBufferAllocateInfo,
+                &commandBufferBeginInfo,
+                &pTicket->commandBuffer);
+    // Allocate and begin command buffer error?
+    if (VKX_IS_ERROR(result)) {
+        // Nullify.
+        memset(pTicket, 0, sizeof(VkxTransferTicket));
+    }
+    return result;
+}
+
+// Submit transfer ticket.
+VkResult vkxSubmitTransferTicket(
+            VkQueue queue,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
+{
+    return vkxSubmitTransferTicketWithSemaphores(
+                queue,
+                0, NULL, NULL,
+                0, NULL,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
+}
+
+// Submit transfer ticket with semaphores.
+VkResult vkxSubmitTransferTicketWithSemaphores(
+            VkQueue queue,
+            uint32_t waitSemaphoreCount,
+            const VkSemaphore* pWaitSemaphores,
+            const VkPipelineStageFlags* pWaitDstStageMasks,
+            uint32_t signalSemaphoreCount,
+            const VkSemaphore* pSignalSemaphores,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
+{
+    assert(pTicket);
+    assert(pTicket->commandBuffer);
+    assert(pWaitSemaphores || waitSemaphoreCount == 0);
+    assert(pSignalSemaphores || signalSemaphoreCount == 0);
+
+    {
+        // End command buffer.
+        VkResult result = vkEndCommandBuffer(pTicket->commandBuffer);
+        if (VKX_IS_ERROR(result)) {
+            vkxDestroyTransferTicket(pTicket, pAllocator);
+            return result;
+        }
+    }
+
+    // Signal semaphores, with timeline semaphore last.
+    uint32_t allSignalSemaphoreCount = signalSemaphoreCount + 1;
+    VkSemaphore* pAllSignalSemaphores = 
+        (VkSemaphore*)VKX_LOCAL_MALLOC(
+                sizeof(VkSemaphore) * allSignalSemaphoreCount);
+    uint64_t* pAllSignalSemaphoreValues = 
+        (uint64_t*)VKX_LOCAL_MALLOC(
+                sizeof(uint64_t) * allSignalSemaphoreCount);
+    for (uint32_t semaphoreIndex = 0;
+                  semaphoreIndex < signalSemaphoreCount;
+                  semaphoreIndex++) {
+        // Ignored for binary semaphores.
+        pAllSignalSemaphores[semaphoreIndex] = 
+            pSignalSemaphores[semaphoreIndex];
+        pAllSignalSemaphoreValues[semaphoreIndex] = 0;
+    }
+    pAllSignalSemaphores[signalSemaphoreCount] = timelineSemaphore;
+    pAllSignalSemaphoreValues[signalSemaphoreCount] = timelineValue;
+
+    // Timeline semaphore submit info.
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreValueCount = 0,
+        .pWaitSemaphoreValues = NULL,
+        .signalSemaphoreValueCount = allSignalSemaphoreCount,
+        .pSignalSemaphoreValues = pAllSignalSemaphoreValues
+    };
+
+    // Submit info.
+    VkSubmitInfo submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreCount = waitSemaphoreCount,
+        .pWaitSemaphores = pWaitSemaphores,
+        .pWaitDstStageMask = pWaitDstStageMasks,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &pTicket->commandBuffer,
+        .signalSemaphoreCount = signalSemaphoreCount,
+        .pSignalSemaphores = pAllSignalSemaphores
+    };
+
+    VkResult result = VK_SUCCESS;
+    if (timelineSemaphore != VK_NULL_HANDLE) {
+        // Signal timeline semaphore.
+        submitInfo.pNext = &timelineSubmitInfo;
+        submitInfo.signalSemaphoreCount = allSignalSemaphoreCount;
+        pTicket->timelineSemaphore = timelineSemaphore;
+        pTicket->timelineValue = timelineValue;
+    }
+    else {
+        // Acquire or create fence.
+        result = 
+            pTicket->pFencePool ?
+            vkxFencePoolAcquire(
+                    pTicket->pFencePool,
+                    pAllocator, &pTicket->fence) :
+            vkxCreateFences(
+                    pTicket->device, 
+                    1, VK_FALSE, 
+                    pAllocator, &pTicket->fence);
+    }
+
+    if (!VKX_IS_ERROR(result)) {
+        // Submit.
+        result = 
+            vkQueueSubmit(
+                    queue, 
+                    1, &submitInfo, 
+                    pTicket->fence);
+    }
+    VKX_LOCAL_FREE(pAllSignalSemaphores);
+    VKX_LOCAL_FREE(pAllSignalSemaphoreValues);
+    if (VKX_IS_ERROR(result)) {
+        // Nothing pending, so do not wait.
+        pTicket->timelineSemaphore = VK_NULL_HANDLE;
+        if (pTicket->pFencePool) {
+            vkxFencePoolRelease(
+                    pTicket->pFencePool, 
+                    pTicket->fence, pAllocator);
+            pTicket->fence = VK_NULL_HANDLE;
+        }
+        else if (pTicket->fence) {
+            vkxDestroyFences(
+                    pTicket->device, 
+                    1, &pTicket->fence, pAllocator);
+        }
+        vkxDestroyTransferTicket(pTicket, pAllocator);
+    }
+    return result;
+}
+
+// Get transfer ticket status.
+VkResult vkxGetTransferTicketStatus(
+            const VkxTransferTicket* pTicket)
+{
+    assert(pTicket);
+    if (pTicket->fence != VK_NULL_HANDLE) {
+        // Get fence status.
+        return vkGetFenceStatus(pTicket->device, pTicket->fence);
+    }
+    if (pTicket->timelineSemaphore != VK_NULL_HANDLE) {
+        // Get semaphore counter value.
+        uint64_t value = 0;
+        VkResult result = 
+            vkGetSemaphoreCounterValue(
+                    pTicket->device, 
+                    pTicket->timelineSemaphore, &value);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+        return value >= pTicket->timelineValue ? 
+                VK_SUCCESS : VK_NOT_READY;
+    }
+
+    // Nothing pending.
+    return VK_SUCCESS;
+}
+
+// Wait for transfer ticket.
+VkResult vkxWaitTransferTicket(
+            const VkxTransferTicket* pTicket,
+            uint64_t timeout)
+{
+    assert(pTicket);
+    if (pTicket->fence != VK_NULL_HANDLE) {
+        // Wait for fence.
+        return 
+            vkWaitForFences(
+                    pTicket->device, 
+                    1, &pTicket->fence, 
+                    VK_TRUE, timeout);
+    }
+    if (pTicket->timelineSemaphore != VK_NULL_HANDLE) {
+        // Wait for semaphore.
+        VkSemaphoreWaitInfo waitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .pNext = NULL,
+            .flags = 0,
+            .semaphoreCount = 1,
+            .pSemaphores = &pTicket->timelineSemaphore,
+            .pValues = &pTicket->timelineValue
+        };
+        return vkWaitSemaphores(pTicket->device, &waitInfo, timeout);
+    }
+
+    // Nothing pending.
+    return VK_SUCCESS;
+}
+
+// Destroy transfer ticket.
+void vkxDestroyTransferTicket(
+            VkxTransferTicket* pTicket,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pTicket) {
+        // Wait, if necessary.
+        (void) vkxWaitTransferTicket(pTicket, UINT64_MAX);
+
+        if (pTicket->commandBuffer) {
+            // Free command buffer.
+            vkFreeCommandBuffers(
+                    pTicket->device,
+                    pTicket->commandPool,
+                    1, &pTicket->commandBuffer);
+        }
+
+        if (pTicket->fence) {
+            if (pTicket->pFencePool) {
+                // Release fence.
+                vkxFencePoolRelease(
+                        pTicket->pFencePool, 
+                        pTicket->fence, pAllocator);
+            }
+            else {
+                // Destroy fence.
+                vkxDestroyFences(
+                        pTicket->device, 
+                        1, &pTicket->fence, pAllocator);
+            }
+        }
+
+        if (pTicket->pStagingBlock ||
+            pTicket->stagingBuffer.buffer) {
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    pTicket->device,
+                    pTicket->pStagingPool,
+                    pTicket->pStagingBlock,
+                    &pTicket->stagingBuffer,
+                    pAllocator);
+        }
+
+        // Nullify.
+        memset(pTicket, 0, sizeof(VkxTransferTicket));
+    }
+}
+
+// Create allocated buffer.
+VkResult vkxCreateAllocatedBuffer(
+            VkxAllocator* pMemoryAllocator,
+            const VkBufferCreateInfo* pBufferCreateInfo,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocatedBuffer* pBuffer)
+{
+    assert(pMemoryAllocator);
+    assert(pBufferCreateInfo);
+    assert(pBuffer);
+
+    // Nullify.
+    memset(pBuffer, 0, sizeof(VkxAllocatedBuffer));
+    VkDevice device = pMemoryAllocator->device;
+
+    {
+        // Create buffer.
+        VkResult result = 
+            vkCreateBuffer(
+                    device,
+                    pBufferCreateInfo, pAllocator,
+                    &pBuffer->buffer);
+        if (VKX_IS_ERROR(result)) {
+            pBuffer->buffer = VK_NULL_HANDLE;
+            return result;
+        }
+    }
+
+    {
+        // Get memory requirements.
+        VkMemoryRequirements memoryRequirements;
+        VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo;
+        getBufferMemoryRequirements(
+                device,
+                pBuffer->buffer,
+                &memoryRequirements,
+                &dedicatedAllocateInfo);
+
+        // Allocate memory, dedicated if preferred.
+        VkResult result = 
+            dedicatedAllocateInfo.buffer != VK_NULL_HANDLE ?
+            vkxAllocatorAllocateDedicatedMemory(
+                    pMemoryAllocator,
+                    &memoryRequirements,
+                    memoryPropertyFlags,
+                    VKX_ALLOCATION_TYPE_LINEAR,
+                    &dedicatedAllocateInfo,
+                    pAllocator,
+                    &pBuffer->allocation) :
+            vkxAllocatorAllocateMemory(
+                    pMemoryAllocator,
+                    &memoryRequirements,
+                    memoryPropertyFlags,
+                    VKX_ALLOCATION_TYPE_LINEAR,
+                    pAllocator,
+                    &pBuffer->allocation);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy buffer.
+            vkxDestroyAllocatedBuffer(pMemoryAllocator, pBuffer, pAllocator);
+            return result;
+        }
+    }
+
+    {
+        // Bind memory.
+        VkResult result = 
+            vkBindBufferMemory(
+                    device,
+                    pBuffer->buffer,
+                    pBuffer->allocation.memoryView.memory,
+                    pBuffer->allocation.memoryView.offset);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy buffer.
+            vkxDestroyAllocatedBuffer(pMemoryAllocator, pBuffer, pAllocator);
+            return result;
+        }
+    }
+
+    // Host visible? Map persistently.
+    if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        VkResult result = 
+            vkxAllocatorMapMemory(
+                    pMemoryAllocator,
+                    &pBuffer->allocation,
+                    &pBuffer->pMappedData);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy buffer.
+            pBuffer->pMappedData = NULL;
+            vkxDestroyAllocatedBuffer(pMemoryAllocator, pBuffer, pAllocator);
+            return result;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+// Destroy allocated buffer.
+void vkxDestroyAllocatedBuffer(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedBuffer* pBuffer,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pBuffer) {
+        // Destroy buffer.
+        vkDestroyBuffer(
+                pMemoryAllocator->device,
+                pBuffer->buffer,
+                pAllocator);
+
+        // Unmap memory.
+        if (pBuffer->pMappedData) {
+            vkxAllocatorUnmapMemory(
+                    pMemoryAllocator,
+                    &pBuffer->allocation);
+        }
+
+        // Free memory.
+        vkxAllocatorFreeMemory(
+                pMemoryAllocator,
+                &pBuffer->allocation,
+                pAllocator);
+
+        // Nullify.
+        pBuffer->buffer = VK_NULL_HANDLE;
+        pBuffer->pMappedData = NULL;
     }
 }
 
 // Create buffer group.
 VkResult vkxCreateBufferGroup(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             uint32_t bufferCount,
             const VkBufferCreateInfo* pBufferCreateInfos,
@@ -174,10 +1115,13 @@ VkResult vkxCreateBufferGroup(
         pBuffers[bufferIndex] = VK_NULL_HANDLE;
     }
 
-    // Allocate memory requirements.
+    // Allocate memory requirements and dedicated allocate infos.
     VkMemoryRequirements* pMemoryRequirements = 
         (VkMemoryRequirements*)VKX_LOCAL_MALLOC(
                 sizeof(VkMemoryRequirements) * bufferCount);
+    VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos = 
+        (VkMemoryDedicatedAllocateInfo*)VKX_LOCAL_MALLOC(
+                sizeof(VkMemoryDedicatedAllocateInfo) * bufferCount);
 
     // Iterate buffers.
     for (uint32_t bufferIndex = 0; 
@@ -190,7 +1134,8 @@ VkResult vkxCreateBufferGroup(
                     &pBufferCreateInfos[bufferIndex], pAllocator,
                     &pBuffers[bufferIndex]);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy buffer group.
             pBuffers[bufferIndex] = VK_NULL_HANDLE;
@@ -199,25 +1144,29 @@ VkResult vkxCreateBufferGroup(
         }
 
         // Get buffer memory requirements.
-        vkGetBufferMemoryRequirements(
+        getBufferMemoryRequirements(
                 device, 
                 pBuffers[bufferIndex],
-                &pMemoryRequirements[bufferIndex]);
+                &pMemoryRequirements[bufferIndex],
+                &pDedicatedAllocateInfos[bufferIndex]);
     }
 
     {
-        // Allocate shared memory.
+        // Allocate packed shared memory.
         VkResult result =
-            vkxAllocateSharedMemory(
-                    physicalDevice,
+            vkxAllocatePackedSharedMemory(
+                    pMemoryTypeTable,
                     device,
                     bufferCount,
                     pMemoryRequirements,
                     pMemoryPropertyFlags,
+                    NULL,
+                    pDedicatedAllocateInfos,
                     pAllocator,
-                    &pBufferGroup->sharedMemory);
+                    &pBufferGroup->sharedMemory, NULL);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy buffer group.
             vkxDestroyBufferGroup(device, pBufferGroup, pAllocator);
@@ -238,7 +1187,8 @@ VkResult vkxCreateBufferGroup(
                     pMemoryViews[bufferIndex].memory,
                     pMemoryViews[bufferIndex].offset);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy buffer group.
             vkxDestroyBufferGroup(device, pBufferGroup, pAllocator);
@@ -246,7 +1196,8 @@ VkResult vkxCreateBufferGroup(
         }
     }
 
-    // Free memory requirements.
+    // Free memory requirements and dedicated allocate infos.
+    VKX_LOCAL_FREE(pDedicatedAllocateInfos);
     VKX_LOCAL_FREE(pMemoryRequirements);
 
     return VK_SUCCESS;
@@ -271,12 +1222,101 @@ void vkxDestroyBufferGroup(
         // Free buffers.
         free(pBufferGroup->pBuffers);
 
-        // Nullify.
-        pBufferGroup->pBuffers = NULL;
-        pBufferGroup->bufferCount = 0;
+        // Nullify.
+        pBufferGroup->pBuffers = NULL;
+        pBufferGroup->bufferCount = 0;
+
+        // Delegate.
+        vkxFreeSharedMemory(device, &pBufferGroup->sharedMemory, pAllocator);
+    }
+}
+
+// Compare buffer copies, by source offset then destination offset.
+static int compareBufferCopies(const void* pValue1, const void* pValue2)
+{
+    const VkBufferCopy* pRegion1 = (const VkBufferCopy*)pValue1;
+    const VkBufferCopy* pRegion2 = (const VkBufferCopy*)pValue2;
+    if (pRegion1->srcOffset != pRegion2->srcOffset) {
+        return pRegion1->srcOffset < pRegion2->srcOffset ? -1 : +1;
+    }
+    if (pRegion1->dstOffset != pRegion2->dstOffset) {
+        return pRegion1->dstOffset < pRegion2->dstOffset ? -1 : +1;
+    }
+    return 0;
+}
+
+// Record buffer copy, coalescing regions.
+void vkxCmdCopyBufferCoalesced(
+            VkCommandBuffer commandBuffer,
+            VkBuffer srcBuffer,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferCopy* pRegions,
+            VkDeviceSize maxWastedBytes,
+            VkxCopyCoalesceStats* pStats)
+{
+    if (regionCount == 0) {
+        return;
+    }
+    assert(pRegions);
+    if (regionCount == 1) {
+        // Nothing to coalesce.
+        vkCmdCopyBuffer(
+                commandBuffer, 
+                srcBuffer, dstBuffer, 
+                1, pRegions);
+        if (pStats) {
+            pStats->inputRegionCount++;
+            pStats->outputRegionCount++;
+        }
+        return;
+    }
+
+    // Sort by source offset then destination offset.
+    VkBufferCopy* pMergedRegions = 
+        (VkBufferCopy*)VKX_LOCAL_MALLOC(sizeof(VkBufferCopy) * regionCount);
+    memcpy(pMergedRegions, pRegions, sizeof(VkBufferCopy) * regionCount);
+    qsort(
+        pMergedRegions,
+        regionCount,
+        sizeof(VkBufferCopy),
+        compareBufferCopies);
 
-        // Delegate.
-        vkxFreeSharedMemory(device, &pBufferGroup->sharedMemory, pAllocator);
+    // Merge regions whose source and destination gaps are equal and 
+    // small enough.
+    uint32_t mergedCount = 1;
+    VkDeviceSize wastedBytes = 0;
+    for (uint32_t regionIndex = 1;
+                  regionIndex < regionCount;
+                  regionIndex++) {
+        VkBufferCopy* pMerged = &pMergedRegions[mergedCount - 1];
+        const VkBufferCopy* pRegion = &pMergedRegions[regionIndex];
+        VkDeviceSize srcEnd = pMerged->srcOffset + pMerged->size;
+        VkDeviceSize dstEnd = pMerged->dstOffset + pMerged->size;
+        if (pRegion->srcOffset >= srcEnd &&
+            pRegion->dstOffset >= dstEnd &&
+            pRegion->srcOffset - srcEnd == pRegion->dstOffset - dstEnd &&
+            pRegion->srcOffset - srcEnd <= maxWastedBytes) {
+            // Merge.
+            wastedBytes += pRegion->srcOffset - srcEnd;
+            pMerged->size = 
+                pRegion->srcOffset + pRegion->size - pMerged->srcOffset;
+        }
+        else {
+            pMergedRegions[mergedCount++] = *pRegion;
+        }
+    }
+
+    // Copy.
+    vkCmdCopyBuffer(
+            commandBuffer, 
+            srcBuffer, dstBuffer, 
+            mergedCount, pMergedRegions);
+    VKX_LOCAL_FREE(pMergedRegions);
+    if (pStats) {
+        pStats->inputRegionCount += regionCount;
+        pStats->outputRegionCount += mergedCount;
+        pStats->wastedBytes += wastedBytes;
     }
 }
 
@@ -291,71 +1331,98 @@ VkResult vkxCopyBuffer(
             const VkBufferCopy* pRegions,
             const VkAllocationCallbacks* pAllocator)
 {
+    // Copy buffer asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxCopyBufferAsync(
+                device,
+                queue,
+                commandPool,
+                srcBuffer,
+                dstBuffer,
+                regionCount,
+                pRegions,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Copy buffer asynchronously.
+VkResult vkxCopyBufferAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer srcBuffer,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
+{
+    assert(pTicket);
     if (srcBuffer == dstBuffer ||
         regionCount == 0) {
+        // Nothing to copy, so complete.
+        memset(pTicket, 0, sizeof(VkxTransferTicket));
         return VK_SUCCESS;
     }
     // Sanity check.
     assert(pRegions);
 
-    // Command buffer allocate info.
-    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .pNext = NULL,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool = commandPool,
-        .commandBufferCount = 1
-    };
-
-    // Command buffer begin info.
-    VkCommandBufferBeginInfo commandBufferBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = NULL,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = NULL
-    };
-
-    // Command buffer.
-    VkCommandBuffer commandBuffer;
     {
-        // Allocate and begin command buffer.
+        // Begin transfer ticket.
         VkResult result = 
-            vkxAllocateAndBeginCommandBuffers(
-                    device,
-                    &commandBufferAllocateInfo,
-                    &commandBufferBeginInfo,
-                    &commandBuffer);
-        // Allocate and begin command buffer error?
+            vkxBeginTransferTicket(
+                    device, 
+                    commandPool, 
+                    pTicket);
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
-    // Copy buffer.
-    vkCmdCopyBuffer(
-            commandBuffer, 
+    // Fence pool, if any, for submit.
+    pTicket->pFencePool = pFencePool;
+
+    // Copy buffer, merging contiguous regions.
+    vkxCmdCopyBufferCoalesced(
+            pTicket->commandBuffer, 
             srcBuffer, 
             dstBuffer,
             regionCount, 
-            pRegions);
+            pRegions,
+            0, NULL);
 
-    // End, flush, and free command buffers.
-    return vkxEndFlushAndFreeCommandBuffers(
-                device,
+    // Submit transfer ticket.
+    return vkxSubmitTransferTicket(
                 queue,
-                commandPool,
-                1, &commandBuffer,
-                pAllocator);
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
 }
 
 // Get buffer data.
 VkResult vkxGetBufferData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkBuffer buffer,
             const VkxBufferDataAccess* pBufferDataAccess,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator,
             void* pData)
 {
@@ -366,29 +1433,20 @@ VkResult vkxGetBufferData(
     }
 
     VkxBuffer stagingBuffer;
+    VkxStagingBlock* pStagingBlock = NULL;
     {
-        // Staging buffer create info.
-        VkBufferCreateInfo bufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = NULL,
-            .flags = 0,
-            .size = pBufferDataAccess->size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 0,
-            .pQueueFamilyIndices = NULL
-        };
-        // Create staging buffer.
+        // Acquire staging buffer.
         VkResult result = 
-            vkxCreateBuffer(
-                    physicalDevice,
+            vkxAcquireStagingBuffer(
+                    pMemoryTypeTable,
                     device,
-                    &bufferCreateInfo,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    pBufferDataAccess->size,
+                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    pStagingPool,
                     pAllocator,
+                    &pStagingBlock,
                     &stagingBuffer);
-        // Create staging buffer error?
+        // Acquire staging buffer error?
         if (VKX_IS_ERROR(result)) {
             return result;
         }
@@ -413,122 +1471,613 @@ VkResult vkxGetBufferData(
                     pAllocator);
         // Copy error?
         if (VKX_IS_ERROR(result)) {
-            // Destroy staging buffer.
-            vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    device, 
+                    pStagingPool, pStagingBlock, 
+                    &stagingBuffer, pAllocator);
             return result;
         }
     }
 
-    // Map staging buffer data.
-    void* pStagingBufferData = NULL;
+    // Invalidate staging buffer data, in case not host-coherent.
+    VkxDeviceMemoryView stagingMemoryView = {
+        .memory = stagingBuffer.memory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
     VkResult result = 
-        vkMapMemory(
+        vkxInvalidateMemoryViews(
+                pMemoryTypeTable,
                 device,
-                stagingBuffer.memory,
-                0, pBufferDataAccess->size,
-                0, &pStagingBufferData);
-    // Map staging buffer data ok?
+                1, &stagingMemoryView);
     if (VKX_IS_OK(result)) {
-        // Read staging buffer data.
-        memcpy(pData, pStagingBufferData, pBufferDataAccess->size);
-        // Unmap staging buffer data.
-        vkUnmapMemory(device, stagingBuffer.memory);
+        // Read staging buffer data, persistently mapped.
+        memcpy(pData, stagingBuffer.pMappedData, pBufferDataAccess->size);
     }
 
-    // Destroy staging buffer.
-    vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+    // Release staging buffer.
+    vkxReleaseStagingBuffer(
+            device, 
+            pStagingPool, pStagingBlock, 
+            &stagingBuffer, pAllocator);
 
     return result;
 }
 
 // Set buffer data.
 VkResult vkxSetBufferData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkBuffer buffer,
             const VkxBufferDataAccess* pBufferDataAccess, 
             const void* pData, 
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator)
+{
+    // Set buffer data asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxSetBufferDataAsync(
+                pMemoryTypeTable,
+                device,
+                queue,
+                commandPool,
+                buffer,
+                pBufferDataAccess,
+                pData,
+                pStagingPool,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Set buffer data asynchronously.
+VkResult vkxSetBufferDataAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess, 
+            const void* pData, 
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
 {
     assert(pBufferDataAccess);
     assert(pData || pBufferDataAccess->size == 0);
+    assert(pTicket);
+    memset(pTicket, 0, sizeof(VkxTransferTicket));
     if (pBufferDataAccess->size == 0) {
         return VK_SUCCESS;
     }
 
     // Staging buffer.
     VkxBuffer stagingBuffer;
+    VkxStagingBlock* pStagingBlock = NULL;
+    {
+        // Acquire staging buffer.
+        VkResult result = 
+            vkxAcquireStagingBuffer(
+                    pMemoryTypeTable,
+                    device,
+                    pBufferDataAccess->size,
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    pStagingPool,
+                    pAllocator,
+                    &pStagingBlock,
+                    &stagingBuffer);
+        // Acquire staging buffer error?
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    {
+        // Write staging buffer data, persistently mapped.
+        memcpy(stagingBuffer.pMappedData, pData, pBufferDataAccess->size);
+
+        // Flush staging buffer data, in case not host-coherent.
+        VkxDeviceMemoryView stagingMemoryView = {
+            .memory = stagingBuffer.memory,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+        VkResult result = 
+            vkxFlushMemoryViews(
+                    pMemoryTypeTable,
+                    device,
+                    1, &stagingMemoryView);
+        if (VKX_IS_ERROR(result)) {
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    device, 
+                    pStagingPool, pStagingBlock, 
+                    &stagingBuffer, pAllocator);
+            return result;
+        }
+    }
+
+    // Copy.
+    VkBufferCopy region = {
+        .srcOffset = 0,
+        .dstOffset = pBufferDataAccess->offset,
+        .size = pBufferDataAccess->size
+    };
+    VkResult result = 
+        vkxCopyBufferAsync(
+                device,
+                queue,
+                commandPool,
+                stagingBuffer.buffer,
+                buffer,
+                1, &region,
+                pFencePool,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
+    if (VKX_IS_ERROR(result)) {
+        // Release staging buffer.
+        vkxReleaseStagingBuffer(
+                device, 
+                pStagingPool, pStagingBlock, 
+                &stagingBuffer, pAllocator);
+        return result;
+    }
+
+    // Defer staging buffer release to ticket.
+    pTicket->pStagingPool = pStagingPool;
+    pTicket->pStagingBlock = pStagingBlock;
+    pTicket->stagingBuffer = stagingBuffer;
+    return result;
+}
+
+// Create frame allocator.
+VkResult vkxCreateFrameAllocator(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize frameSize,
+            uint32_t frameCount,
+            VkBufferUsageFlags usage,
+            const VkAllocationCallbacks* pAllocator,
+            VkxFrameAllocator* pFrameAllocator)
+{
+    assert(frameCount > 0);
+    assert(pFrameAllocator);
+    memset(pFrameAllocator, 0, sizeof(VkxFrameAllocator));
+
+    // Round frame size up to multiple of 256.
+    if (frameSize % 256) {
+        frameSize = frameSize - frameSize % 256 + 256;
+    }
+
     {
-        // Staging buffer create info.
+        // Buffer create info.
         VkBufferCreateInfo bufferCreateInfo = {
             .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
             .pNext = NULL,
             .flags = 0,
-            .size = pBufferDataAccess->size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .size = frameSize * frameCount,
+            .usage = usage,
             .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
             .queueFamilyIndexCount = 0,
             .pQueueFamilyIndices = NULL
         };
-        // Create staging buffer.
+        // Create buffer.
         VkResult result = 
             vkxCreateBuffer(
-                    physicalDevice,
+                    pMemoryTypeTable,
                     device,
                     &bufferCreateInfo,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                     VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                     pAllocator,
-                    &stagingBuffer);
-        // Create staging buffer error?
+                    &pFrameAllocator->buffer);
+        // Create buffer error?
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
+    // Initialize.
+    pFrameAllocator->device = device;
+    pFrameAllocator->pMappedData = pFrameAllocator->buffer.pMappedData;
+    pFrameAllocator->frameSize = frameSize;
+    pFrameAllocator->frameCount = frameCount;
+    pFrameAllocator->frameIndex = 0;
+    pFrameAllocator->frameOffset = 0;
+    pFrameAllocator->pFences = 
+        (VkFence*)calloc(frameCount, sizeof(VkFence));
+    return VK_SUCCESS;
+}
+
+// Destroy frame allocator.
+void vkxDestroyFrameAllocator(
+            VkxFrameAllocator* pFrameAllocator,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pFrameAllocator) {
+        // Destroy buffer, implicitly unmapped.
+        vkxDestroyBuffer(
+                pFrameAllocator->device, 
+                &pFrameAllocator->buffer, pAllocator);
+
+        // Free fences.
+        free(pFrameAllocator->pFences);
+
+        // Nullify.
+        memset(pFrameAllocator, 0, sizeof(VkxFrameAllocator));
+    }
+}
+
+// Frame allocator begin frame.
+VkResult vkxFrameAllocatorBeginFrame(
+            VkxFrameAllocator* pFrameAllocator,
+            uint64_t timeout)
+{
+    assert(pFrameAllocator);
+    uint32_t nextFrameIndex = 
+        (pFrameAllocator->frameIndex + 1) % pFrameAllocator->frameCount;
+
+    // Wait for next frame slice to be released by the device.
+    VkFence fence = pFrameAllocator->pFences[nextFrameIndex];
+    if (fence != VK_NULL_HANDLE) {
+        VkResult result = 
+            vkWaitForFences(
+                    pFrameAllocator->device,
+                    1, &fence, VK_TRUE, timeout);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        pFrameAllocator->pFences[nextFrameIndex] = VK_NULL_HANDLE;
+    }
+
+    // Recycle.
+    pFrameAllocator->frameIndex = nextFrameIndex;
+    pFrameAllocator->frameOffset = 0;
+    return VK_SUCCESS;
+}
+
+// Frame allocator end frame.
+void vkxFrameAllocatorEndFrame(
+            VkxFrameAllocator* pFrameAllocator,
+            VkFence fence)
+{
+    assert(pFrameAllocator);
+    pFrameAllocator->pFences[pFrameAllocator->frameIndex] = fence;
+}
+
+// Frame allocator allocate.
+VkResult vkxFrameAllocatorAllocate(
+            VkxFrameAllocator* pFrameAllocator,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            VkxFrameAllocation* pAllocation)
+{
+    assert(pFrameAllocator);
+    assert(pAllocation);
+    assert((alignment & (alignment - 1)) == 0 && alignment <= 256);
+
+    // Bump offset.
+    VkDeviceSize offset = pFrameAllocator->frameOffset;
+    if (alignment > 1) {
+        offset = (offset + alignment - 1) & ~(alignment - 1);
+    }
+    if (offset + size > pFrameAllocator->frameSize) {
+        // Nullify.
+        memset(pAllocation, 0, sizeof(VkxFrameAllocation));
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    pFrameAllocator->frameOffset = offset + size;
+
+    // Offset relative to buffer.
+    offset += pFrameAllocator->frameSize * pFrameAllocator->frameIndex;
+    pAllocation->buffer = pFrameAllocator->buffer.buffer;
+    pAllocation->offset = offset;
+    pAllocation->size = size;
+    pAllocation->pData = (char*)pFrameAllocator->pMappedData + offset;
+    return VK_SUCCESS;
+}
+
+// Create readback ring.
+VkResult vkxCreateReadbackRing(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkDeviceSize frameSize,
+            uint32_t frameCount,
+            const VkAllocationCallbacks* pAllocator,
+            VkxReadbackRing* pReadbackRing)
+{
+    assert(pMemoryTypeTable);
+    assert(frameCount > 0);
+    assert(pReadbackRing);
+    memset(pReadbackRing, 0, sizeof(VkxReadbackRing));
+
+    // Round frame size up to multiple of 256, so frames never share a
+    // non-coherent atom. Region offsets are aligned separately.
+    if (frameSize % 256) {
+        frameSize = frameSize - frameSize % 256 + 256;
+    }
+
     {
-        // Map staging buffer data.
-        void* pStagingBufferData = NULL;
+        // Create buffer, preferably host-cached.
         VkResult result = 
-            vkMapMemory(
+            vkxCreateStagingBuffer(
+                    pMemoryTypeTable,
                     device,
-                    stagingBuffer.memory,
-                    0, pBufferDataAccess->size,
-                    0, &pStagingBufferData);
-        // Map staging buffer data error?
+                    frameSize * frameCount,
+                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    pAllocator,
+                    &pReadbackRing->buffer);
+        // Create buffer error?
         if (VKX_IS_ERROR(result)) {
-            // Destroy staging buffer.
-            vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
             return result;
         }
+    }
+
+    // Initialize.
+    pReadbackRing->memoryTypeTable = *pMemoryTypeTable;
+    pReadbackRing->device = device;
+    pReadbackRing->frameSize = frameSize;
+    pReadbackRing->frameCount = frameCount;
+    pReadbackRing->frameIndex = 0;
+    pReadbackRing->frameNumber = 0;
+    pReadbackRing->frameOffset = 0;
+    pReadbackRing->pFences = 
+        (VkFence*)calloc(frameCount, sizeof(VkFence));
+    return VK_SUCCESS;
+}
+
+// Destroy readback ring.
+void vkxDestroyReadbackRing(
+            VkxReadbackRing* pReadbackRing,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pReadbackRing) {
+        // Destroy buffer, implicitly unmapped.
+        vkxDestroyBuffer(
+                pReadbackRing->device, 
+                &pReadbackRing->buffer, pAllocator);
+
+        // Free fences.
+        free(pReadbackRing->pFences);
+
+        // Nullify.
+        memset(pReadbackRing, 0, sizeof(VkxReadbackRing));
+    }
+}
+
+// Readback ring begin frame.
+VkResult vkxReadbackRingBeginFrame(
+            VkxReadbackRing* pReadbackRing,
+            uint64_t timeout)
+{
+    assert(pReadbackRing);
+    uint32_t nextFrameIndex = 
+        (pReadbackRing->frameIndex + 1) % pReadbackRing->frameCount;
+
+    // Wait for next frame slice to be released by the device.
+    VkFence fence = pReadbackRing->pFences[nextFrameIndex];
+    if (fence != VK_NULL_HANDLE) {
+        VkResult result = 
+            vkWaitForFences(
+                    pReadbackRing->device,
+                    1, &fence, VK_TRUE, timeout);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+        pReadbackRing->pFences[nextFrameIndex] = VK_NULL_HANDLE;
+    }
+
+    // Recycle.
+    pReadbackRing->frameIndex = nextFrameIndex;
+    pReadbackRing->frameNumber++;
+    pReadbackRing->frameOffset = 0;
+    return VK_SUCCESS;
+}
+
+// Readback ring end frame.
+void vkxReadbackRingEndFrame(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkFence fence)
+{
+    assert(pReadbackRing);
+    if (pReadbackRing->frameOffset > 0) {
+        // Make copies visible to host.
+        VkMemoryBarrier memoryBarrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = NULL,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+        };
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_HOST_BIT,
+                0,
+                1, &memoryBarrier,
+                0, NULL,
+                0, NULL);
+    }
+    pReadbackRing->pFences[pReadbackRing->frameIndex] = fence;
+}
 
-        // Write staging buffer data.
-        memcpy(pStagingBufferData, pData, pBufferDataAccess->size);
+// Allocate readback region from current frame.
+static VkResult allocateReadbackRegion(
+            VkxReadbackRing* pReadbackRing,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            VkxReadbackRegion* pRegion)
+{
+    // Bump offset, aligned relative to buffer, since the frame size 
+    // need not be a multiple of the alignment.
+    VkDeviceSize frameBase = 
+        pReadbackRing->frameSize * pReadbackRing->frameIndex;
+    VkDeviceSize offset = frameBase + pReadbackRing->frameOffset;
+    offset = (offset + alignment - 1) / alignment * alignment;
+    if (offset + size > frameBase + pReadbackRing->frameSize) {
+        // Nullify.
+        memset(pRegion, 0, sizeof(VkxReadbackRegion));
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    pReadbackRing->frameOffset = offset + size - frameBase;
+    pRegion->frameNumber = pReadbackRing->frameNumber;
+    pRegion->offset = offset;
+    pRegion->size = size;
+    return VK_SUCCESS;
+}
+
+// Readback ring record buffer copy.
+VkResult vkxReadbackRingCmdCopyBuffer(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            VkxReadbackRegion* pRegion)
+{
+    assert(pReadbackRing);
+    assert(pBufferDataAccess);
+    assert(pRegion);
 
-        // Unmap staging buffer data.
-        vkUnmapMemory(device, stagingBuffer.memory);
+    // Allocate region.
+    VkResult result = 
+        allocateReadbackRegion(
+                pReadbackRing, 
+                pBufferDataAccess->size, 
+                16,
+                pRegion);
+    if (VKX_IS_ERROR(result)) {
+        return result;
     }
 
     // Copy.
     VkBufferCopy region = {
-        .srcOffset = 0,
-        .dstOffset = pBufferDataAccess->offset,
+        .srcOffset = pBufferDataAccess->offset,
+        .dstOffset = pRegion->offset,
         .size = pBufferDataAccess->size
     };
+    vkCmdCopyBuffer(
+            commandBuffer,
+            buffer,
+            pReadbackRing->buffer.buffer,
+            1, &region);
+    return VK_SUCCESS;
+}
+
+// Readback ring record image copy.
+VkResult vkxReadbackRingCmdCopyImage(
+            VkxReadbackRing* pReadbackRing,
+            VkCommandBuffer commandBuffer,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            VkImageSubresourceLayers subresourceLayers,
+            VkOffset3D offset,
+            VkExtent3D extent,
+            VkDeviceSize size,
+            VkxReadbackRegion* pRegion)
+{
+    assert(pReadbackRing);
+    assert(pRegion);
+    assert(
+        imageLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL ||
+        imageLayout == VK_IMAGE_LAYOUT_GENERAL ||
+        imageLayout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
+    assert(texelSize > 0);
+
+    // Region offset alignment, the least common multiple of the texel
+    // size and 4.
+    VkDeviceSize alignment = 
+        texelSize % 4 == 0 ? texelSize : 
+        texelSize % 2 == 0 ? texelSize * 2 : texelSize * 4;
+
+    // Allocate region.
     VkResult result = 
-        vkxCopyBuffer(
-                device,
-                queue,
-                commandPool,
-                stagingBuffer.buffer,
-                buffer,
-                1, &region,
-                pAllocator);
+        allocateReadbackRegion(
+                pReadbackRing, 
+                size, 
+                alignment,
+                pRegion);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Copy.
+    VkBufferImageCopy region = {
+        .bufferOffset = pRegion->offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = subresourceLayers,
+        .imageOffset = offset,
+        .imageExtent = extent
+    };
+    vkCmdCopyImageToBuffer(
+            commandBuffer,
+            image,
+            imageLayout,
+            pReadbackRing->buffer.buffer,
+            1, &region);
+    return VK_SUCCESS;
+}
+
+// Readback ring get data.
+VkResult vkxReadbackRingGetData(
+            const VkxReadbackRing* pReadbackRing,
+            const VkxReadbackRegion* pRegion,
+            const void** ppData)
+{
+    assert(pReadbackRing);
+    assert(pRegion);
+    assert(ppData);
+    assert(pRegion->frameNumber <= pReadbackRing->frameNumber);
+    assert(pRegion->frameNumber + 
+           pReadbackRing->frameCount > pReadbackRing->frameNumber);
+    *ppData = NULL;
 
-    // Destroy staging buffer.
-    vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+    // Frame ended and fence signaled?
+    uint32_t frameIndex = 
+        (uint32_t)(pRegion->offset / pReadbackRing->frameSize);
+    VkFence fence = pReadbackRing->pFences[frameIndex];
+    if (fence == VK_NULL_HANDLE ||
+        vkGetFenceStatus(pReadbackRing->device, fence) != VK_SUCCESS) {
+        return VK_NOT_READY;
+    }
 
-    return result;
+    {
+        // Invalidate, in case not host-coherent.
+        VkxDeviceMemoryView memoryView = {
+            .memory = pReadbackRing->buffer.memory,
+            .offset = pRegion->offset,
+            .size = pRegion->size
+        };
+        VkResult result = 
+            vkxInvalidateMemoryViews(
+                    &pReadbackRing->memoryTypeTable,
+                    pReadbackRing->device,
+                    1, &memoryView);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    *ppData = (const char*)pReadbackRing->buffer.pMappedData + 
+                           pRegion->offset;
+    return VK_SUCCESS;
 }
@@ -26,10 +26,18 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 /*-*-*-*-*-*-*/
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#endif // #if defined(__unix__) || defined(__APPLE__)
 #include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
+#include <vulkanx/memory.h>
 #include <vulkanx/result.h>
 #include <vulkanx/command_buffer.h>
+#include "thread.h"
 
 VkResult vkxCreateFences(
                 VkDevice device,
@@ -145,6 +153,940 @@ void vkxDestroySemaphores(
     }
 }
 
+// Create pool mutex, if thread-safe.
+static VkResult createPoolMutex(VkBool32 threadSafe, void** ppMutex)
+{
+    *ppMutex = NULL;
+    if (threadSafe) {
+        Mutex* pMutex = (Mutex*)malloc(sizeof(Mutex));
+        if (!pMutex) {
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        if (!mutexInit(pMutex)) {
+            free(pMutex);
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        *ppMutex = pMutex;
+    }
+    return VK_SUCCESS;
+}
+
+// Destroy pool mutex.
+static void destroyPoolMutex(void* pMutex)
+{
+    if (pMutex) {
+        mutexDestroy((Mutex*)pMutex);
+        free(pMutex);
+    }
+}
+
+// Lock pool mutex, if any.
+static void lockPoolMutex(void* pMutex)
+{
+    if (pMutex) {
+        mutexLock((Mutex*)pMutex);
+    }
+}
+
+// Unlock pool mutex, if any.
+static void unlockPoolMutex(void* pMutex)
+{
+    if (pMutex) {
+        mutexUnlock((Mutex*)pMutex);
+    }
+}
+
+VkResult vkxCreateFencePool(
+            VkDevice device,
+            VkBool32 threadSafe,
+            VkxFencePool* pFencePool)
+{
+    assert(pFencePool);
+    memset(pFencePool, 0, sizeof(VkxFencePool));
+    VkResult result = createPoolMutex(threadSafe, &pFencePool->pMutex);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+    pFencePool->device = device;
+    return VK_SUCCESS;
+}
+
+void vkxDestroyFencePool(
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pFencePool) {
+        // Destroy free fences.
+        vkxDestroyFences(
+                pFencePool->device,
+                pFencePool->fenceCount,
+                pFencePool->pFences,
+                pAllocator);
+        free(pFencePool->pFences);
+
+        // Destroy mutex.
+        destroyPoolMutex(pFencePool->pMutex);
+
+        // Nullify.
+        memset(pFencePool, 0, sizeof(VkxFencePool));
+    }
+}
+
+VkResult vkxFencePoolAcquire(
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator,
+            VkFence* pFence)
+{
+    assert(pFencePool);
+    assert(pFence);
+    *pFence = VK_NULL_HANDLE;
+    lockPoolMutex(pFencePool->pMutex);
+
+    if (pFencePool->fenceCount == 0) {
+        // Ensure capacity.
+        if (pFencePool->fenceCapacity < VKX_SYNC_POOL_CHUNK_SIZE) {
+            pFencePool->fenceCapacity = VKX_SYNC_POOL_CHUNK_SIZE;
+            pFencePool->pFences = 
+                (VkFence*)realloc(
+                        pFencePool->pFences,
+                        sizeof(VkFence) * pFencePool->fenceCapacity);
+        }
+
+        // Grow by chunk.
+        VkResult result = 
+            vkxCreateFences(
+                    pFencePool->device,
+                    VKX_SYNC_POOL_CHUNK_SIZE, VK_FALSE,
+                    pAllocator,
+                    pFencePool->pFences);
+        if (VKX_IS_ERROR(result)) {
+            unlockPoolMutex(pFencePool->pMutex);
+            return result;
+        }
+        pFencePool->fenceCount = VKX_SYNC_POOL_CHUNK_SIZE;
+    }
+
+    // Pop.
+    *pFence = pFencePool->pFences[--pFencePool->fenceCount];
+    unlockPoolMutex(pFencePool->pMutex);
+    return VK_SUCCESS;
+}
+
+void vkxFencePoolRelease(
+            VkxFencePool* pFencePool,
+            VkFence fence,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pFencePool);
+    if (fence == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // Reset.
+    VkResult result = vkResetFences(pFencePool->device, 1, &fence);
+    if (VKX_IS_ERROR(result)) {
+        vkDestroyFence(pFencePool->device, fence, pAllocator);
+        return;
+    }
+
+    // Push.
+    lockPoolMutex(pFencePool->pMutex);
+    if (pFencePool->fenceCount == pFencePool->fenceCapacity) {
+        pFencePool->fenceCapacity *= 2;
+        if (pFencePool->fenceCapacity < VKX_SYNC_POOL_CHUNK_SIZE) {
+            pFencePool->fenceCapacity = VKX_SYNC_POOL_CHUNK_SIZE;
+        }
+        pFencePool->pFences = 
+            (VkFence*)realloc(
+                    pFencePool->pFences,
+                    sizeof(VkFence) * pFencePool->fenceCapacity);
+    }
+    pFencePool->pFences[pFencePool->fenceCount++] = fence;
+    unlockPoolMutex(pFencePool->pMutex);
+}
+
+VkResult vkxCreateSemaphorePool(
+            VkDevice device,
+            VkBool32 threadSafe,
+            VkxSemaphorePool* pSemaphorePool)
+{
+    assert(pSemaphorePool);
+    memset(pSemaphorePool, 0, sizeof(VkxSemaphorePool));
+    VkResult result = 
+        createPoolMutex(threadSafe, &pSemaphorePool->pMutex);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+    pSemaphorePool->device = device;
+    return VK_SUCCESS;
+}
+
+void vkxDestroySemaphorePool(
+            VkxSemaphorePool* pSemaphorePool,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pSemaphorePool) {
+        // Destroy free semaphores.
+        vkxDestroySemaphores(
+                pSemaphorePool->device,
+                pSemaphorePool->semaphoreCount,
+                pSemaphorePool->pSemaphores,
+                pAllocator);
+        free(pSemaphorePool->pSemaphores);
+
+        // Destroy mutex.
+        destroyPoolMutex(pSemaphorePool->pMutex);
+
+        // Nullify.
+        memset(pSemaphorePool, 0, sizeof(VkxSemaphorePool));
+    }
+}
+
+VkResult vkxSemaphorePoolAcquire(
+            VkxSemaphorePool* pSemaphorePool,
+            const VkAllocationCallbacks* pAllocator,
+            VkSemaphore* pSemaphore)
+{
+    assert(pSemaphorePool);
+    assert(pSemaphore);
+    *pSemaphore = VK_NULL_HANDLE;
+    lockPoolMutex(pSemaphorePool->pMutex);
+
+    if (pSemaphorePool->semaphoreCount == 0) {
+        // Ensure capacity.
+        if (pSemaphorePool->semaphoreCapacity < VKX_SYNC_POOL_CHUNK_SIZE) {
+            pSemaphorePool->semaphoreCapacity = VKX_SYNC_POOL_CHUNK_SIZE;
+            pSemaphorePool->pSemaphores = 
+                (VkSemaphore*)realloc(
+                        pSemaphorePool->pSemaphores,
+                        sizeof(VkSemaphore) * 
+                        pSemaphorePool->semaphoreCapacity);
+        }
+
+        // Grow by chunk.
+        VkResult result = 
+            vkxCreateSemaphores(
+                    pSemaphorePool->device,
+                    VKX_SYNC_POOL_CHUNK_SIZE,
+                    pAllocator,
+                    pSemaphorePool->pSemaphores);
+        if (VKX_IS_ERROR(result)) {
+            unlockPoolMutex(pSemaphorePool->pMutex);
+            return result;
+        }
+        pSemaphorePool->semaphoreCount = VKX_SYNC_POOL_CHUNK_SIZE;
+    }
+
+    // Pop.
+    *pSemaphore = 
+        pSemaphorePool->pSemaphores[--pSemaphorePool->semaphoreCount];
+    unlockPoolMutex(pSemaphorePool->pMutex);
+    return VK_SUCCESS;
+}
+
+void vkxSemaphorePoolRelease(
+            VkxSemaphorePool* pSemaphorePool,
+            VkSemaphore semaphore)
+{
+    assert(pSemaphorePool);
+    if (semaphore == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // Push.
+    lockPoolMutex(pSemaphorePool->pMutex);
+    if (pSemaphorePool->semaphoreCount == 
+        pSemaphorePool->semaphoreCapacity) {
+        pSemaphorePool->semaphoreCapacity *= 2;
+        if (pSemaphorePool->semaphoreCapacity < VKX_SYNC_POOL_CHUNK_SIZE) {
+            pSemaphorePool->semaphoreCapacity = VKX_SYNC_POOL_CHUNK_SIZE;
+        }
+        pSemaphorePool->pSemaphores = 
+            (VkSemaphore*)realloc(
+                    pSemaphorePool->pSemaphores,
+                    sizeof(VkSemaphore) * 
+                    pSemaphorePool->semaphoreCapacity);
+    }
+    pSemaphorePool->pSemaphores[pSemaphorePool->semaphoreCount++] = semaphore;
+    unlockPoolMutex(pSemaphorePool->pMutex);
+}
+
+VkResult vkxCreateQueueTimeline(
+            VkDevice device,
+            VkQueue queue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxQueueTimeline* pTimeline)
+{
+    assert(pTimeline);
+    memset(pTimeline, 0, sizeof(VkxQueueTimeline));
+
+    // Semaphore create info, timeline starting at 0.
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = NULL,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &semaphoreTypeCreateInfo,
+        .flags = 0
+    };
+
+    // Create semaphore.
+    VkResult result = 
+        vkCreateSemaphore(
+                device,
+                &semaphoreCreateInfo, pAllocator,
+                &pTimeline->semaphore);
+    if (VKX_IS_ERROR(result)) {
+        pTimeline->semaphore = VK_NULL_HANDLE;
+        return result;
+    }
+    pTimeline->device = device;
+    pTimeline->queue = queue;
+    return VK_SUCCESS;
+}
+
+void vkxDestroyQueueTimeline(
+            VkxQueueTimeline* pTimeline,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pTimeline) {
+        if (pTimeline->semaphore) {
+            // Wait for last value.
+            (void) vkxTimelineWait(
+                    pTimeline, 
+                    pTimeline->lastValue, UINT64_MAX);
+
+            // Destroy semaphore.
+            vkDestroySemaphore(
+                    pTimeline->device, 
+                    pTimeline->semaphore, pAllocator);
+        }
+
+        // Nullify.
+        memset(pTimeline, 0, sizeof(VkxQueueTimeline));
+    }
+}
+
+uint64_t vkxTimelineAdvance(
+            VkxQueueTimeline* pTimeline)
+{
+    assert(pTimeline);
+    return ++pTimeline->lastValue;
+}
+
+VkResult vkxTimelineSubmit(
+            VkxQueueTimeline* pTimeline,
+            uint32_t waitSemaphoreCount,
+            const VkSemaphore* pWaitSemaphores,
+            const VkPipelineStageFlags* pWaitDstStageMasks,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            uint32_t signalSemaphoreCount,
+            const VkSemaphore* pSignalSemaphores,
+            VkFence fence,
+            uint64_t* pValue)
+{
+    assert(pTimeline);
+    assert(pWaitSemaphores || waitSemaphoreCount == 0);
+    assert(pCommandBuffers || commandBufferCount == 0);
+    assert(pSignalSemaphores || signalSemaphoreCount == 0);
+    uint64_t value = pTimeline->lastValue + 1;
+
+    // Signal semaphores, with timeline semaphore last.
+    uint32_t allSignalSemaphoreCount = signalSemaphoreCount + 1;
+    VkSemaphore* pAllSignalSemaphores = 
+        (VkSemaphore*)VKX_LOCAL_MALLOC(
+                sizeof(VkSemaphore) * allSignalSemaphoreCount);
+    uint64_t* pAllSignalSemaphoreValues = 
+        (uint64_t*)VKX_LOCAL_MALLOC(
+                sizeof(uint64_t) * allSignalSemaphoreCount);
+    for (uint32_t semaphoreIndex = 0;
+                  semaphoreIndex < signalSemaphoreCount;
+                  semaphoreIndex++) {
+        // Ignored for binary semaphores.
+        pAllSignalSemaphores[semaphoreIndex] = 
+            pSignalSemaphores[semaphoreIndex];
+        pAllSignalSemaphoreValues[semaphoreIndex] = 0;
+    }
+    pAllSignalSemaphores[signalSemaphoreCount] = pTimeline->semaphore;
+    pAllSignalSemaphoreValues[signalSemaphoreCount] = value;
+
+    // Timeline semaphore submit info.
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreValueCount = 0,
+        .pWaitSemaphoreValues = NULL,
+        .signalSemaphoreValueCount = allSignalSemaphoreCount,
+        .pSignalSemaphoreValues = pAllSignalSemaphoreValues
+    };
+
+    // Submit.
+    VkSubmitInfo submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineSubmitInfo,
+        .waitSemaphoreCount = waitSemaphoreCount,
+        .pWaitSemaphores = pWaitSemaphores,
+        .pWaitDstStageMask = pWaitDstStageMasks,
+        .commandBufferCount = commandBufferCount,
+        .pCommandBuffers = pCommandBuffers,
+        .signalSemaphoreCount = allSignalSemaphoreCount,
+        .pSignalSemaphores = pAllSignalSemaphores
+    };
+    VkResult result = 
+        vkQueueSubmit(
+                pTimeline->queue, 
+                1, &submitInfo, 
+                fence);
+    VKX_LOCAL_FREE(pAllSignalSemaphores);
+    VKX_LOCAL_FREE(pAllSignalSemaphoreValues);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Hand out.
+    pTimeline->lastValue = value;
+    if (pValue) {
+        *pValue = value;
+    }
+    return VK_SUCCESS;
+}
+
+VkResult vkxTimelineWait(
+            VkxQueueTimeline* pTimeline,
+            uint64_t value,
+            uint64_t timeout)
+{
+    assert(pTimeline);
+    assert(value <= pTimeline->lastValue);
+    if (value <= pTimeline->completedValue) {
+        return VK_SUCCESS;
+    }
+
+    // Wait.
+    VkSemaphoreWaitInfo waitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext = NULL,
+        .flags = 0,
+        .semaphoreCount = 1,
+        .pSemaphores = &pTimeline->semaphore,
+        .pValues = &value
+    };
+    VkResult result = 
+        vkWaitSemaphores(
+                pTimeline->device, 
+                &waitInfo, timeout);
+    if (result == VK_SUCCESS) {
+        pTimeline->completedValue = value;
+    }
+    return result;
+}
+
+VkResult vkxTimelineIsComplete(
+            VkxQueueTimeline* pTimeline,
+            uint64_t value)
+{
+    assert(pTimeline);
+    if (value <= pTimeline->completedValue) {
+        return VK_SUCCESS;
+    }
+
+    // Query counter.
+    uint64_t completedValue = 0;
+    VkResult result = 
+        vkGetSemaphoreCounterValue(
+                pTimeline->device,
+                pTimeline->semaphore, &completedValue);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+    if (pTimeline->completedValue < completedValue) {
+        pTimeline->completedValue = completedValue;
+    }
+    return value <= completedValue ? VK_SUCCESS : VK_NOT_READY;
+}
+
+VkResult vkxCreateCommandPoolSet(
+            VkDevice device,
+            uint32_t threadCount,
+            uint32_t queueFamilyCount,
+            const uint32_t* pQueueFamilyIndices,
+            uint32_t frameCount,
+            VkxCommandPoolSet* pCommandPoolSet)
+{
+    assert(threadCount > 0);
+    assert(queueFamilyCount > 0);
+    assert(pQueueFamilyIndices);
+    assert(frameCount > 0);
+    assert(pCommandPoolSet);
+    memset(pCommandPoolSet, 0, sizeof(VkxCommandPoolSet));
+
+    // Allocate.
+    uint32_t slotCount = threadCount * queueFamilyCount * frameCount;
+    VkxCommandPoolSlot* pSlots = 
+        (VkxCommandPoolSlot*)calloc(slotCount, sizeof(VkxCommandPoolSlot));
+    uint32_t* pQueueFamilyIndicesCopy = 
+        (uint32_t*)malloc(sizeof(uint32_t) * queueFamilyCount);
+    if (!pSlots || !pQueueFamilyIndicesCopy) {
+        free(pSlots);
+        free(pQueueFamilyIndicesCopy);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    memcpy(
+        pQueueFamilyIndicesCopy, 
+        pQueueFamilyIndices, 
+        sizeof(uint32_t) * queueFamilyCount);
+
+    // Initialize.
+    pCommandPoolSet->device = device;
+    pCommandPoolSet->threadCount = threadCount;
+    pCommandPoolSet->queueFamilyCount = queueFamilyCount;
+    pCommandPoolSet->pQueueFamilyIndices = pQueueFamilyIndicesCopy;
+    pCommandPoolSet->frameCount = frameCount;
+    pCommandPoolSet->frameIndex = 0;
+    pCommandPoolSet->pSlots = pSlots;
+    return VK_SUCCESS;
+}
+
+void vkxDestroyCommandPoolSet(
+            VkxCommandPoolSet* pCommandPoolSet,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pCommandPoolSet) {
+        uint32_t slotCount = 
+            pCommandPoolSet->threadCount *
+            pCommandPoolSet->queueFamilyCount *
+            pCommandPoolSet->frameCount;
+        for (uint32_t slotIndex = 0; slotIndex < slotCount; slotIndex++) {
+            VkxCommandPoolSlot* pSlot = &pCommandPoolSet->pSlots[slotIndex];
+            if (pSlot->commandPool) {
+                // Destroy command pool, implicitly freeing command buffers.
+                vkDestroyCommandPool(
+                        pCommandPoolSet->device,
+                        pSlot->commandPool,
+                        pAllocator);
+            }
+            free(pSlot->pCommandBuffers[0]);
+            free(pSlot->pCommandBuffers[1]);
+        }
+
+        // Free.
+        free(pCommandPoolSet->pSlots);
+        free(pCommandPoolSet->pQueueFamilyIndices);
+
+        // Nullify.
+        memset(pCommandPoolSet, 0, sizeof(VkxCommandPoolSet));
+    }
+}
+
+VkResult vkxCommandPoolSetBeginFrame(
+            VkxCommandPoolSet* pCommandPoolSet)
+{
+    assert(pCommandPoolSet);
+    pCommandPoolSet->frameIndex = 
+        (pCommandPoolSet->frameIndex + 1) % pCommandPoolSet->frameCount;
+
+    // Reset command pools of frame.
+    uint32_t slotCount = 
+        pCommandPoolSet->threadCount * 
+        pCommandPoolSet->queueFamilyCount;
+    VkxCommandPoolSlot* pSlots = 
+        pCommandPoolSet->pSlots + slotCount * pCommandPoolSet->frameIndex;
+    for (uint32_t slotIndex = 0; slotIndex < slotCount; slotIndex++) {
+        VkxCommandPoolSlot* pSlot = &pSlots[slotIndex];
+        if (pSlot->commandPool &&
+            (pSlot->commandBufferUsedCounts[0] > 0 ||
+             pSlot->commandBufferUsedCounts[1] > 0)) {
+            VkResult result = 
+                vkResetCommandPool(
+                        pCommandPoolSet->device,
+                        pSlot->commandPool, 0);
+            if (VKX_IS_ERROR(result)) {
+                return result;
+            }
+            pSlot->commandBufferUsedCounts[0] = 0;
+            pSlot->commandBufferUsedCounts[1] = 0;
+        }
+    }
+    return VK_SUCCESS;
+}
+
+VkResult vkxCommandPoolSetAllocate(
+            VkxCommandPoolSet* pCommandPoolSet,
+            uint32_t threadIndex,
+            uint32_t queueFamily,
+            VkCommandBufferLevel level,
+            const VkAllocationCallbacks* pAllocator,
+            VkCommandBuffer* pCommandBuffer)
+{
+    assert(pCommandPoolSet);
+    assert(threadIndex < pCommandPoolSet->threadCount);
+    assert(queueFamily < pCommandPoolSet->queueFamilyCount);
+    assert(
+        level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ||
+        level == VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    assert(pCommandBuffer);
+    *pCommandBuffer = VK_NULL_HANDLE;
+
+    // Slot.
+    VkxCommandPoolSlot* pSlot = 
+        &pCommandPoolSet->pSlots[
+            (pCommandPoolSet->frameIndex * 
+             pCommandPoolSet->queueFamilyCount + queueFamily) * 
+             pCommandPoolSet->threadCount + threadIndex];
+
+    if (pSlot->commandPool == VK_NULL_HANDLE) {
+        // Create command pool.
+        VkCommandPoolCreateInfo commandPoolCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = NULL,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = 
+                pCommandPoolSet->pQueueFamilyIndices[queueFamily]
+        };
+        VkResult result = 
+            vkCreateCommandPool(
+                    pCommandPoolSet->device,
+                    &commandPoolCreateInfo, pAllocator,
+                    &pSlot->commandPool);
+        if (VKX_IS_ERROR(result)) {
+            pSlot->commandPool = VK_NULL_HANDLE;
+            return result;
+        }
+    }
+
+    uint32_t levelIndex = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? 0 : 1;
+    if (pSlot->commandBufferUsedCounts[levelIndex] == 
+        pSlot->commandBufferCounts[levelIndex]) {
+        // Grow.
+        uint32_t commandBufferCapacity = 
+            pSlot->commandBufferCapacities[levelIndex] * 2;
+        if (commandBufferCapacity < 8) {
+            commandBufferCapacity = 8;
+        }
+        pSlot->pCommandBuffers[levelIndex] = 
+            (VkCommandBuffer*)realloc(
+                    pSlot->pCommandBuffers[levelIndex],
+                    sizeof(VkCommandBuffer) * commandBufferCapacity);
+        pSlot->commandBufferCapacities[levelIndex] = commandBufferCapacity;
+
+        // Allocate command buffers to fill capacity.
+        uint32_t commandBufferCount = pSlot->commandBufferCounts[levelIndex];
+        VkCommandBufferAllocateInfo allocateInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = NULL,
+            .commandPool = pSlot->commandPool,
+            .level = level,
+            .commandBufferCount = commandBufferCapacity - commandBufferCount
+        };
+        VkResult result = 
+            vkAllocateCommandBuffers(
+                    pCommandPoolSet->device,
+                    &allocateInfo,
+                    pSlot->pCommandBuffers[levelIndex] + commandBufferCount);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+        pSlot->commandBufferCounts[levelIndex] = commandBufferCapacity;
+    }
+
+    // Hand out next.
+    *pCommandBuffer = 
+        pSlot->pCommandBuffers[levelIndex][
+        pSlot->commandBufferUsedCounts[levelIndex]++];
+    return VK_SUCCESS;
+}
+
+// Record batch, shared by worker threads.
+typedef struct RecordBatch_
+{
+    VkxCommandPoolSet* pCommandPoolSet;
+    uint32_t queueFamily;
+    VkCommandBufferInheritanceInfo inheritanceInfo;
+    uint32_t jobCount;
+    const VkxRecordJob* pJobs;
+    const VkAllocationCallbacks* pAllocator;
+    VkCommandBuffer* pCommandBuffers;
+    atomic_uint nextJobIndex;
+    atomic_int result;
+}
+RecordBatch;
+
+// Record worker, one per thread.
+typedef struct RecordWorker_
+{
+    VkxRecordThreadPoolState* pState;
+    uint32_t threadIndex;
+    Thread thread;
+}
+RecordWorker;
+
+struct VkxRecordThreadPoolState_
+{
+    // Workers.
+    uint32_t workerCount;
+    RecordWorker* pWorkers;
+
+    // Batch, and generation to tell batches apart.
+    RecordBatch* pBatch;
+    uint64_t generation;
+    uint32_t doneCount;
+    bool stopping;
+
+    // Synchronization.
+    Mutex mutex;
+    Condition workCondition;
+    Condition doneCondition;
+};
+
+// Record jobs of batch until none remain.
+static void recordBatchJobs(RecordBatch* pBatch, uint32_t threadIndex)
+{
+    for (;;) {
+        uint32_t jobIndex = atomic_fetch_add(&pBatch->nextJobIndex, 1);
+        if (jobIndex >= pBatch->jobCount) {
+            break;
+        }
+        if (atomic_load(&pBatch->result) != VK_SUCCESS) {
+            // Give up.
+            break;
+        }
+
+        // Allocate secondary command buffer from own thread slot.
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkResult result = 
+            vkxCommandPoolSetAllocate(
+                    pBatch->pCommandPoolSet,
+                    threadIndex,
+                    pBatch->queueFamily,
+                    VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                    pBatch->pAllocator,
+                    &commandBuffer);
+        if (!VKX_IS_ERROR(result)) {
+            // Begin.
+            VkCommandBufferBeginInfo beginInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .pNext = NULL,
+                .flags = 
+                    VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                    VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+                .pInheritanceInfo = &pBatch->inheritanceInfo
+            };
+            result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        }
+        if (!VKX_IS_ERROR(result)) {
+            // Record, then end.
+            const VkxRecordJob* pJob = &pBatch->pJobs[jobIndex];
+            pJob->pfnRecord(pJob->pUserData, commandBuffer, jobIndex);
+            result = vkEndCommandBuffer(commandBuffer);
+        }
+        if (VKX_IS_ERROR(result)) {
+            // Keep first error.
+            int expected = VK_SUCCESS;
+            atomic_compare_exchange_strong(
+                    &pBatch->result, &expected, (int)result);
+            break;
+        }
+        pBatch->pCommandBuffers[jobIndex] = commandBuffer;
+    }
+}
+
+// Record worker main.
+static int recordWorkerMain(void* pArg)
+{
+    RecordWorker* pWorker = (RecordWorker*)pArg;
+    VkxRecordThreadPoolState* pState = pWorker->pState;
+    uint64_t generation = 0;
+    for (;;) {
+        // Wait for next batch.
+        mutexLock(&pState->mutex);
+        while (!pState->stopping && pState->generation == generation) {
+            conditionWait(&pState->workCondition, &pState->mutex);
+        }
+        if (pState->stopping) {
+            mutexUnlock(&pState->mutex);
+            break;
+        }
+        generation = pState->generation;
+        RecordBatch* pBatch = pState->pBatch;
+        mutexUnlock(&pState->mutex);
+
+        // Record.
+        recordBatchJobs(pBatch, pWorker->threadIndex);
+
+        // Done.
+        mutexLock(&pState->mutex);
+        if (++pState->doneCount == pState->workerCount) {
+            conditionSignal(&pState->doneCondition);
+        }
+        mutexUnlock(&pState->mutex);
+    }
+    return 0;
+}
+
+VkResult vkxCreateRecordThreadPool(
+            uint32_t threadCount,
+            VkxRecordThreadPool* pThreadPool)
+{
+    assert(threadCount > 0);
+    assert(pThreadPool);
+    memset(pThreadPool, 0, sizeof(VkxRecordThreadPool));
+
+    // Allocate state.
+    VkxRecordThreadPoolState* pState = 
+        (VkxRecordThreadPoolState*)calloc(
+                1, sizeof(VkxRecordThreadPoolState));
+    if (!pState) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    pState->pWorkers = 
+        (RecordWorker*)calloc(threadCount, sizeof(RecordWorker));
+    if (!pState->pWorkers) {
+        free(pState);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    // Create mutex and conditions.
+    if (!mutexInit(&pState->mutex)) {
+        free(pState->pWorkers);
+        free(pState);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (!conditionInit(&pState->workCondition)) {
+        mutexDestroy(&pState->mutex);
+        free(pState->pWorkers);
+        free(pState);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (!conditionInit(&pState->doneCondition)) {
+        conditionDestroy(&pState->workCondition);
+        mutexDestroy(&pState->mutex);
+        free(pState->pWorkers);
+        free(pState);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    pThreadPool->pState = pState;
+
+    // Start worker threads.
+    for (uint32_t threadIndex = 0; 
+                  threadIndex < threadCount; threadIndex++) {
+        RecordWorker* pWorker = &pState->pWorkers[threadIndex];
+        pWorker->pState = pState;
+        pWorker->threadIndex = threadIndex;
+        if (!threadCreate(
+                &pWorker->thread, 
+                recordWorkerMain, pWorker)) {
+            vkxDestroyRecordThreadPool(pThreadPool);
+            return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        pState->workerCount++;
+    }
+    pThreadPool->threadCount = threadCount;
+    return VK_SUCCESS;
+}
+
+void vkxDestroyRecordThreadPool(
+            VkxRecordThreadPool* pThreadPool)
+{
+    if (pThreadPool && pThreadPool->pState) {
+        VkxRecordThreadPoolState* pState = pThreadPool->pState;
+
+        // Stop worker threads.
+        mutexLock(&pState->mutex);
+        pState->stopping = true;
+        conditionBroadcast(&pState->workCondition);
+        mutexUnlock(&pState->mutex);
+        for (uint32_t threadIndex = 0; 
+                      threadIndex < pState->workerCount; threadIndex++) {
+            threadJoin(&pState->pWorkers[threadIndex].thread);
+        }
+
+        // Free state.
+        conditionDestroy(&pState->doneCondition);
+        conditionDestroy(&pState->workCondition);
+        mutexDestroy(&pState->mutex);
+        free(pState->pWorkers);
+        free(pState);
+    }
+    if (pThreadPool) {
+        // Nullify.
+        memset(pThreadPool, 0, sizeof(VkxRecordThreadPool));
+    }
+}
+
+VkResult vkxRecordSecondaryCommandBuffers(
+            VkxRecordThreadPool* pThreadPool,
+            VkxCommandPoolSet* pCommandPoolSet,
+            uint32_t queueFamily,
+            VkCommandBuffer primaryCommandBuffer,
+            VkRenderPass renderPass,
+            uint32_t subpass,
+            VkFramebuffer framebuffer,
+            uint32_t jobCount,
+            const VkxRecordJob* pJobs,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pThreadPool && pThreadPool->pState);
+    assert(pCommandPoolSet);
+    assert(pCommandPoolSet->threadCount >= pThreadPool->threadCount);
+    assert(pJobs || jobCount == 0);
+    if (jobCount == 0) {
+        return VK_SUCCESS;
+    }
+    VkxRecordThreadPoolState* pState = pThreadPool->pState;
+
+    // Batch.
+    RecordBatch batch = {
+        .pCommandPoolSet = pCommandPoolSet,
+        .queueFamily = queueFamily,
+        .inheritanceInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .pNext = NULL,
+            .renderPass = renderPass,
+            .subpass = subpass,
+            .framebuffer = framebuffer,
+            .occlusionQueryEnable = VK_FALSE,
+            .queryFlags = 0,
+            .pipelineStatistics = 0
+        },
+        .jobCount = jobCount,
+        .pJobs = pJobs,
+        .pAllocator = pAllocator,
+        .pCommandBuffers = 
+            (VkCommandBuffer*)malloc(sizeof(VkCommandBuffer) * jobCount)
+    };
+    atomic_init(&batch.nextJobIndex, 0);
+    atomic_init(&batch.result, VK_SUCCESS);
+    if (!batch.pCommandBuffers) {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    // Fan out, then wait for every worker.
+    mutexLock(&pState->mutex);
+    pState->pBatch = &batch;
+    pState->doneCount = 0;
+    pState->generation++;
+    conditionBroadcast(&pState->workCondition);
+    while (pState->doneCount < pState->workerCount) {
+        conditionWait(&pState->doneCondition, &pState->mutex);
+    }
+    pState->pBatch = NULL;
+    mutexUnlock(&pState->mutex);
+
+    // Stitch into primary command buffer.
+    VkResult result = (VkResult)atomic_load(&batch.result);
+    if (!VKX_IS_ERROR(result)) {
+        vkCmdExecuteCommands(
+                primaryCommandBuffer, 
+                jobCount, batch.pCommandBuffers);
+    }
+    free(batch.pCommandBuffers);
+    return result;
+}
+
 VkResult vkxAllocateAndBeginCommandBuffers(
             VkDevice device,
             const VkCommandBufferAllocateInfo* pAllocateInfo,
@@ -213,52 +1155,63 @@ VkResult vkxFlushCommandBuffers(
             uint32_t commandBufferCount,
             const VkCommandBuffer* pCommandBuffers,
             const VkAllocationCallbacks* pAllocator)
+{
+    return 
+        vkxFlushCommandBuffersWithFencePool(
+                device,
+                queue,
+                commandBufferCount,
+                pCommandBuffers,
+                NULL,
+                pAllocator);
+}
+
+VkResult vkxFlushCommandBuffersWithFencePool(
+            VkDevice device,
+            VkQueue queue,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator)
 {
     VkFence fence = VK_NULL_HANDLE;
 
     {
-        // Create fence.
-        VkFenceCreateInfo fenceCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-            .pNext = NULL,
-            .flags = 0
-        };
+        // Acquire or create fence.
         VkResult result = 
-            vkCreateFence(
-                    device,
-                    &fenceCreateInfo, pAllocator,
-                    &fence);
+            pFencePool ?
+            vkxFencePoolAcquire(pFencePool, pAllocator, &fence) :
+            vkxCreateFences(device, 1, VK_FALSE, pAllocator, &fence);
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
-    {
-        // Submit.
-        VkSubmitInfo submitInfo = {
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .pNext = NULL,
-            .waitSemaphoreCount = 0,
-            .pWaitSemaphores = NULL,
-            .pWaitDstStageMask = NULL,
-            .commandBufferCount = commandBufferCount,
-            .pCommandBuffers = pCommandBuffers,
-            .signalSemaphoreCount = 0,
-            .pSignalSemaphores = NULL
-        };
-        VkResult result = vkQueueSubmit(queue, 1, &submitInfo, fence);
-        if (VKX_IS_ERROR(result)) {
-            // Destroy fence.
-            vkDestroyFence(device, fence, pAllocator);
-            return result;
-        }
+    // Submit.
+    VkSubmitInfo submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = NULL,
+        .pWaitDstStageMask = NULL,
+        .commandBufferCount = commandBufferCount,
+        .pCommandBuffers = pCommandBuffers,
+        .signalSemaphoreCount = 0,
+        .pSignalSemaphores = NULL
+    };
+    VkResult result = vkQueueSubmit(queue, 1, &submitInfo, fence);
+    if (!VKX_IS_ERROR(result)) {
+        // Wait.
+        result = vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
     }
 
-    // Wait.
-    VkResult result = vkWaitForFences(device, 1,  &fence, VK_TRUE, UINT64_MAX);
-
-    // Destroy fence.
-    vkDestroyFence(device, fence, pAllocator);
+    // Release or destroy fence.
+    if (pFencePool) {
+        vkxFencePoolRelease(pFencePool, fence, pAllocator);
+    }
+    else {
+        vkDestroyFence(device, fence, pAllocator);
+    }
 
     return result;
 }
@@ -270,6 +1223,26 @@ VkResult vkxEndFlushAndFreeCommandBuffers(
             uint32_t commandBufferCount,
             const VkCommandBuffer* pCommandBuffers,
             const VkAllocationCallbacks* pAllocator)
+{
+    return 
+        vkxEndFlushAndFreeCommandBuffersWithFencePool(
+                device,
+                queue,
+                commandPool,
+                commandBufferCount,
+                pCommandBuffers,
+                NULL,
+                pAllocator);
+}
+
+VkResult vkxEndFlushAndFreeCommandBuffersWithFencePool(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            uint32_t commandBufferCount,
+            const VkCommandBuffer* pCommandBuffers,
+            VkxFencePool* pFencePool,
+            const VkAllocationCallbacks* pAllocator)
 {
     if (commandBufferCount == 0)
         return VK_SUCCESS;
@@ -284,11 +1257,12 @@ VkResult vkxEndFlushAndFreeCommandBuffers(
 
     // Flush.
     VkResult result =
-        vkxFlushCommandBuffers(
+        vkxFlushCommandBuffersWithFencePool(
                 device,
                 queue,
                 commandBufferCount,
                 pCommandBuffers,
+                pFencePool,
                 pAllocator);
 
     // Free.
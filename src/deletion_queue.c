@@ -0,0 +1,340 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkanx/result.h>
+#include <vulkanx/deletion_queue.h>
+
+// Create deletion queue.
+void vkxCreateDeletionQueue(
+            VkDevice device,
+            VkxDeletionQueue* pDeletionQueue)
+{
+    assert(pDeletionQueue);
+    memset(pDeletionQueue, 0, sizeof(VkxDeletionQueue));
+    pDeletionQueue->device = device;
+}
+
+// Retire deletion, destroying its object.
+static void retireDeletion(
+            VkDevice device,
+            VkxDeletion* pDeletion,
+            const VkAllocationCallbacks* pAllocator)
+{
+    switch (pDeletion->type) {
+        case VKX_DELETION_TYPE_BUFFER:
+            vkxDestroyBuffer(
+                    device, 
+                    &pDeletion->buffer, pAllocator);
+            break;
+        case VKX_DELETION_TYPE_IMAGE:
+            vkxDestroyImage(
+                    device, 
+                    &pDeletion->image, pAllocator);
+            break;
+        case VKX_DELETION_TYPE_ALLOCATED_BUFFER:
+            vkxDestroyAllocatedBuffer(
+                    pDeletion->allocatedBuffer.pMemoryAllocator,
+                    &pDeletion->allocatedBuffer.buffer, pAllocator);
+            break;
+        case VKX_DELETION_TYPE_ALLOCATED_IMAGE:
+            vkxDestroyAllocatedImage(
+                    pDeletion->allocatedImage.pMemoryAllocator,
+                    &pDeletion->allocatedImage.image, pAllocator);
+            break;
+        case VKX_DELETION_TYPE_DYNAMIC_DESCRIPTOR_SET:
+            (void) vkxFreeDynamicDescriptorSets(
+                    device,
+                    pDeletion->dynamicDescriptorSet.pDynamicPool,
+                    1, &pDeletion->dynamicDescriptorSet.set);
+            break;
+        case VKX_DELETION_TYPE_CALLBACK:
+            pDeletion->callback.pfnCallback(
+                    pDeletion->callback.pUserData);
+            break;
+        default:
+            assert(!"invalid deletion type");
+            break;
+    }
+}
+
+// Destroy deletion queue.
+void vkxDestroyDeletionQueue(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pDeletionQueue) {
+        VkDevice device = pDeletionQueue->device;
+        for (uint32_t deletionIndex = 0; 
+                      deletionIndex < pDeletionQueue->deletionCount;
+                      deletionIndex++) {
+            VkxDeletion* pDeletion = 
+                &pDeletionQueue->pDeletions[deletionIndex];
+
+            // Wait for key.
+            if (pDeletion->key.fence != VK_NULL_HANDLE) {
+                (void) vkWaitForFences(
+                        device,
+                        1, &pDeletion->key.fence, 
+                        VK_TRUE, UINT64_MAX);
+            }
+            else {
+                VkSemaphoreWaitInfo waitInfo = {
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                    .pNext = NULL,
+                    .flags = 0,
+                    .semaphoreCount = 1,
+                    .pSemaphores = &pDeletion->key.timelineSemaphore,
+                    .pValues = &pDeletion->key.timelineValue
+                };
+                (void) vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+            }
+
+            // Retire.
+            retireDeletion(device, pDeletion, pAllocator);
+        }
+
+        // Free.
+        free(pDeletionQueue->pDeletions);
+
+        // Nullify.
+        memset(pDeletionQueue, 0, sizeof(VkxDeletionQueue));
+    }
+}
+
+// Deletion queue push.
+void vkxDeletionQueuePush(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletion* pDeletion)
+{
+    assert(pDeletionQueue);
+    assert(pDeletion);
+    assert(
+        (pDeletion->key.fence != VK_NULL_HANDLE) !=
+        (pDeletion->key.timelineSemaphore != VK_NULL_HANDLE));
+    if (pDeletionQueue->deletionCount == 
+        pDeletionQueue->deletionCapacity) {
+        pDeletionQueue->deletionCapacity *= 2;
+        if (pDeletionQueue->deletionCapacity < 16) {
+            pDeletionQueue->deletionCapacity = 16;
+        }
+        pDeletionQueue->pDeletions = 
+            (VkxDeletion*)realloc(
+                    pDeletionQueue->pDeletions,
+                    sizeof(VkxDeletion) * pDeletionQueue->deletionCapacity);
+    }
+    pDeletionQueue->pDeletions[pDeletionQueue->deletionCount++] = *pDeletion;
+}
+
+// Defer destroy buffer.
+void vkxDeferDestroyBuffer(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxBuffer* pBuffer)
+{
+    assert(pKey);
+    assert(pBuffer);
+    VkxDeletion deletion = {
+        .key = *pKey,
+        .type = VKX_DELETION_TYPE_BUFFER,
+        .buffer = *pBuffer
+    };
+    vkxDeletionQueuePush(pDeletionQueue, &deletion);
+    memset(pBuffer, 0, sizeof(VkxBuffer));
+}
+
+// Defer destroy image.
+void vkxDeferDestroyImage(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxImage* pImage)
+{
+    assert(pKey);
+    assert(pImage);
+    VkxDeletion deletion = {
+        .key = *pKey,
+        .type = VKX_DELETION_TYPE_IMAGE,
+        .image = *pImage
+    };
+    vkxDeletionQueuePush(pDeletionQueue, &deletion);
+    memset(pImage, 0, sizeof(VkxImage));
+}
+
+// Defer destroy allocated buffer.
+void vkxDeferDestroyAllocatedBuffer(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedBuffer* pBuffer)
+{
+    assert(pKey);
+    assert(pMemoryAllocator);
+    assert(pBuffer);
+    VkxDeletion deletion = {
+        .key = *pKey,
+        .type = VKX_DELETION_TYPE_ALLOCATED_BUFFER,
+        .allocatedBuffer = {
+            .pMemoryAllocator = pMemoryAllocator,
+            .buffer = *pBuffer
+        }
+    };
+    vkxDeletionQueuePush(pDeletionQueue, &deletion);
+    memset(pBuffer, 0, sizeof(VkxAllocatedBuffer));
+}
+
+// Defer destroy allocated image.
+void vkxDeferDestroyAllocatedImage(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedImage* pImage)
+{
+    assert(pKey);
+    assert(pMemoryAllocator);
+    assert(pImage);
+    VkxDeletion deletion = {
+        .key = *pKey,
+        .type = VKX_DELETION_TYPE_ALLOCATED_IMAGE,
+        .allocatedImage = {
+            .pMemoryAllocator = pMemoryAllocator,
+            .image = *pImage
+        }
+    };
+    vkxDeletionQueuePush(pDeletionQueue, &deletion);
+    memset(pImage, 0, sizeof(VkxAllocatedImage));
+}
+
+// Defer free dynamic descriptor sets.
+void vkxDeferFreeDynamicDescriptorSets(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            VkxDynamicDescriptorPool* pDynamicPool,
+            uint32_t setCount,
+            VkxDynamicDescriptorSet* pDynamicSets)
+{
+    assert(pKey);
+    assert(pDynamicPool);
+    assert(pDynamicSets || setCount == 0);
+    for (uint32_t setIndex = 0; setIndex < setCount; setIndex++) {
+        VkxDeletion deletion = {
+            .key = *pKey,
+            .type = VKX_DELETION_TYPE_DYNAMIC_DESCRIPTOR_SET,
+            .dynamicDescriptorSet = {
+                .pDynamicPool = pDynamicPool,
+                .set = pDynamicSets[setIndex]
+            }
+        };
+        vkxDeletionQueuePush(pDeletionQueue, &deletion);
+        memset(&pDynamicSets[setIndex], 0, sizeof(VkxDynamicDescriptorSet));
+    }
+}
+
+// Defer callback.
+void vkxDeferCallback(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkxDeletionKey* pKey,
+            PFN_vkxDeletionCallback pfnCallback,
+            void* pUserData)
+{
+    assert(pKey);
+    assert(pfnCallback);
+    VkxDeletion deletion = {
+        .key = *pKey,
+        .type = VKX_DELETION_TYPE_CALLBACK,
+        .callback = {
+            .pfnCallback = pfnCallback,
+            .pUserData = pUserData
+        }
+    };
+    vkxDeletionQueuePush(pDeletionQueue, &deletion);
+}
+
+// Deletion queue retire.
+VkResult vkxDeletionQueueRetire(
+            VkxDeletionQueue* pDeletionQueue,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pDeletionQueue);
+    VkDevice device = pDeletionQueue->device;
+
+    // Last fence and timeline semaphore queried, since deletions 
+    // enqueued together usually share keys.
+    VkFence lastFence = VK_NULL_HANDLE;
+    VkResult lastFenceStatus = VK_NOT_READY;
+    VkSemaphore lastSemaphore = VK_NULL_HANDLE;
+    VkResult lastSemaphoreStatus = VK_NOT_READY;
+    uint64_t lastSemaphoreValue = 0;
+
+    VkResult result = VK_SUCCESS;
+    uint32_t keptCount = 0;
+    for (uint32_t deletionIndex = 0; 
+                  deletionIndex < pDeletionQueue->deletionCount;
+                  deletionIndex++) {
+        VkxDeletion* pDeletion = &pDeletionQueue->pDeletions[deletionIndex];
+        VkResult status = VK_NOT_READY;
+        if (pDeletion->key.fence != VK_NULL_HANDLE) {
+            // Query fence, if not queried already.
+            if (lastFence != pDeletion->key.fence) {
+                lastFence = pDeletion->key.fence;
+                lastFenceStatus = vkGetFenceStatus(device, lastFence);
+            }
+            status = lastFenceStatus;
+        }
+        else {
+            // Query semaphore counter, if not queried already.
+            if (lastSemaphore != pDeletion->key.timelineSemaphore) {
+                lastSemaphore = pDeletion->key.timelineSemaphore;
+                lastSemaphoreStatus = 
+                    vkGetSemaphoreCounterValue(
+                            device, 
+                            lastSemaphore, &lastSemaphoreValue);
+            }
+            status = lastSemaphoreStatus;
+            if (status == VK_SUCCESS &&
+                lastSemaphoreValue < pDeletion->key.timelineValue) {
+                status = VK_NOT_READY;
+            }
+        }
+
+        if (status == VK_SUCCESS) {
+            // Retire.
+            retireDeletion(device, pDeletion, pAllocator);
+        }
+        else {
+            // Keep, in order.
+            if (VKX_IS_ERROR(status) && !VKX_IS_ERROR(result)) {
+                result = status;
+            }
+            pDeletionQueue->pDeletions[keptCount++] = *pDeletion;
+        }
+    }
+    pDeletionQueue->deletionCount = keptCount;
+    return result;
+}
@@ -34,8 +34,50 @@
 #include <vulkanx/buffer.h>
 #include <vulkanx/image.h>
 
+// Get image memory requirements, and dedicated allocate info which 
+// names the image if the implementation prefers or requires a dedicated 
+// allocation, or nothing otherwise.
+static void getImageMemoryRequirements(
+            VkDevice device,
+            VkImage image,
+            VkMemoryRequirements* pMemoryRequirements,
+            VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfo)
+{
+    // Get memory requirements.
+    VkMemoryDedicatedRequirements dedicatedRequirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+        .pNext = NULL,
+        .prefersDedicatedAllocation = VK_FALSE,
+        .requiresDedicatedAllocation = VK_FALSE
+    };
+    VkMemoryRequirements2 memoryRequirements2 = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicatedRequirements
+    };
+    VkImageMemoryRequirementsInfo2 memoryRequirementsInfo2 = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext = NULL,
+        .image = image
+    };
+    vkGetImageMemoryRequirements2(
+            device, 
+            &memoryRequirementsInfo2, 
+            &memoryRequirements2);
+    *pMemoryRequirements = memoryRequirements2.memoryRequirements;
+
+    // Dedicated allocate info.
+    pDedicatedAllocateInfo->sType = 
+        VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+    pDedicatedAllocateInfo->pNext = NULL;
+    pDedicatedAllocateInfo->image = 
+        dedicatedRequirements.prefersDedicatedAllocation ||
+        dedicatedRequirements.requiresDedicatedAllocation ? 
+        image : VK_NULL_HANDLE;
+    pDedicatedAllocateInfo->buffer = VK_NULL_HANDLE;
+}
+
 VkResult vkxCreateImage(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             const VkImageCreateInfo* pImageCreateInfo,
             const VkMemoryPropertyFlags memoryPropertyFlags,
@@ -65,15 +107,17 @@ VkResult vkxCreateImage(
     {
         // Get memory requirements.
         VkMemoryRequirements memoryRequirements;
-        vkGetImageMemoryRequirements(
+        VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo;
+        getImageMemoryRequirements(
                 device,
                 pImage->image,
-                &memoryRequirements);
+                &memoryRequirements,
+                &dedicatedAllocateInfo);
 
         // Find memory type index.
         uint32_t memoryTypeIndex = 
-            vkxFindMemoryTypeIndex(
-                    physicalDevice,
+            vkxMemoryTypeTableFindIndex(
+                    pMemoryTypeTable,
                     memoryPropertyFlags,
                     memoryRequirements.memoryTypeBits);
         if (memoryTypeIndex == UINT32_MAX) {
@@ -82,14 +126,25 @@ VkResult vkxCreateImage(
             return VK_ERROR_INITIALIZATION_FAILED;
         }
 
-        // Memory allocate info.
+        // Memory allocate info, dedicated if preferred.
         VkMemoryAllocateInfo memoryAllocateInfo = {
             .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .pNext = NULL,
+            .pNext = 
+                dedicatedAllocateInfo.image != VK_NULL_HANDLE ?
+                &dedicatedAllocateInfo : NULL,
             .allocationSize = memoryRequirements.size,
             .memoryTypeIndex = memoryTypeIndex
         };
 
+        // Not dedicated? Pad allocation size.
+        if (dedicatedAllocateInfo.image == VK_NULL_HANDLE) {
+            memoryAllocateInfo.allocationSize = 
+                vkxMemoryTypeTablePadAllocationSize(
+                        pMemoryTypeTable,
+                        memoryTypeIndex,
+                        memoryRequirements.size);
+        }
+
         // Allocate memory.
         VkResult result = 
             vkAllocateMemory(
@@ -143,12 +198,295 @@ void vkxDestroyImage(
     }
 }
 
-VkResult vkxCreateImageGroup(
-            VkPhysicalDevice physicalDevice,
+VkResult vkxCreateAllocatedImage(
+            VkxAllocator* pMemoryAllocator,
+            const VkImageCreateInfo* pImageCreateInfo,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxAllocatedImage* pImage)
+{
+    assert(pMemoryAllocator);
+    assert(pImageCreateInfo);
+    assert(pImage);
+
+    // Nullify.
+    memset(pImage, 0, sizeof(VkxAllocatedImage));
+    VkDevice device = pMemoryAllocator->device;
+
+    {
+        // Create image.
+        VkResult result = 
+            vkCreateImage(
+                    device,
+                    pImageCreateInfo, pAllocator,
+                    &pImage->image);
+        if (VKX_IS_ERROR(result)) {
+            pImage->image = VK_NULL_HANDLE;
+            return result;
+        }
+    }
+
+    {
+        // Get memory requirements.
+        VkMemoryRequirements memoryRequirements;
+        VkMemoryDedicatedAllocateInfo dedicatedAllocateInfo;
+        getImageMemoryRequirements(
+                device,
+                pImage->image,
+                &memoryRequirements,
+                &dedicatedAllocateInfo);
+
+        // Allocate memory, dedicated if preferred.
+        VkxAllocationType allocationType = 
+            pImageCreateInfo->tiling == VK_IMAGE_TILING_LINEAR ?
+            VKX_ALLOCATION_TYPE_LINEAR :
+            VKX_ALLOCATION_TYPE_OPTIMAL;
+        VkResult result = 
+            dedicatedAllocateInfo.image != VK_NULL_HANDLE ?
+            vkxAllocatorAllocateDedicatedMemory(
+                    pMemoryAllocator,
+                    &memoryRequirements,
+                    memoryPropertyFlags,
+                    allocationType,
+                    &dedicatedAllocateInfo,
+                    pAllocator,
+                    &pImage->allocation) :
+            vkxAllocatorAllocateMemory(
+                    pMemoryAllocator,
+                    &memoryRequirements,
+                    memoryPropertyFlags,
+                    allocationType,
+                    pAllocator,
+                    &pImage->allocation);
+        if (VKX_IS_ERROR(result)) {
+            // Destroy image.
+            vkxDestroyAllocatedImage(pMemoryAllocator, pImage, pAllocator);
+            return result;
+        }
+    }
+
+    // Bind memory.
+    VkResult result = 
+        vkBindImageMemory(
+                device,
+                pImage->image,
+                pImage->allocation.memoryView.memory,
+                pImage->allocation.memoryView.offset);
+    if (VKX_IS_ERROR(result)) {
+        // Destroy image.
+        vkxDestroyAllocatedImage(pMemoryAllocator, pImage, pAllocator);
+        // Fall through.
+    }
+    return result;
+}
+
+void vkxDestroyAllocatedImage(
+            VkxAllocator* pMemoryAllocator,
+            VkxAllocatedImage* pImage,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pImage) {
+        // Destroy image.
+        vkDestroyImage(
+                pMemoryAllocator->device,
+                pImage->image,
+                pAllocator);
+
+        // Free memory.
+        vkxAllocatorFreeMemory(
+                pMemoryAllocator,
+                &pImage->allocation,
+                pAllocator);
+
+        // Nullify.
+        pImage->image = VK_NULL_HANDLE;
+    }
+}
+
+// Allocate aliased shared memory.
+//
+// Colors the interval graph of image lifetimes greedily in order of 
+// first use, allocates one memory range per color, then expands memory
+// views so that there is one memory view per image as usual.
+static VkResult allocateAliasedSharedMemory(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t imageCount,
+            const VkMemoryRequirements* pMemoryRequirements,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxAllocationType* pAllocationTypes,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos,
+            const VkxImageLifetime* pImageLifetimes,
+            const VkAllocationCallbacks* pAllocator,
+            VkxSharedDeviceMemory* pSharedMemory)
+{
+    // Order images by first use, insertion sort.
+    uint32_t* pImageOrder = 
+        (uint32_t*)VKX_LOCAL_MALLOC(sizeof(uint32_t) * imageCount);
+    for (uint32_t orderIndex = 0;
+                  orderIndex < imageCount;
+                  orderIndex++) {
+        uint32_t insertIndex = orderIndex;
+        while (insertIndex > 0 &&
+               pImageLifetimes[orderIndex].firstUse <
+               pImageLifetimes[pImageOrder[insertIndex - 1]].firstUse) {
+            pImageOrder[insertIndex] = pImageOrder[insertIndex - 1];
+            insertIndex--;
+        }
+        pImageOrder[insertIndex] = orderIndex;
+    }
+
+    // Slots, at most one per image.
+    uint32_t slotCount = 0;
+    VkMemoryRequirements* pSlotMemoryRequirements = 
+        (VkMemoryRequirements*)VKX_LOCAL_MALLOC(
+                sizeof(VkMemoryRequirements) * imageCount);
+    VkMemoryPropertyFlags* pSlotMemoryPropertyFlags = 
+        (VkMemoryPropertyFlags*)VKX_LOCAL_MALLOC(
+                sizeof(VkMemoryPropertyFlags) * imageCount);
+    VkxAllocationType* pSlotAllocationTypes = 
+        (VkxAllocationType*)VKX_LOCAL_MALLOC(
+                sizeof(VkxAllocationType) * imageCount);
+    VkMemoryDedicatedAllocateInfo* pSlotDedicatedAllocateInfos = 
+        (VkMemoryDedicatedAllocateInfo*)VKX_LOCAL_MALLOC(
+                sizeof(VkMemoryDedicatedAllocateInfo) * imageCount);
+    uint32_t* pSlotLastUses = 
+        (uint32_t*)VKX_LOCAL_MALLOC(sizeof(uint32_t) * imageCount);
+    uint32_t* pImageSlotIndices = 
+        (uint32_t*)VKX_LOCAL_MALLOC(sizeof(uint32_t) * imageCount);
+
+    // Iterate images by first use.
+    for (uint32_t orderIndex = 0;
+                  orderIndex < imageCount;
+                  orderIndex++) {
+        uint32_t imageIndex = pImageOrder[orderIndex];
+        const VkMemoryRequirements* pImageMemoryRequirements = 
+            &pMemoryRequirements[imageIndex];
+
+        // Dedicated? Never aliased.
+        VkBool32 dedicated = 
+            pDedicatedAllocateInfos[imageIndex].image != VK_NULL_HANDLE;
+
+        // Find compatible free slot which grows least.
+        uint32_t bestSlotIndex = UINT32_MAX;
+        VkDeviceSize bestGrowth = VK_WHOLE_SIZE;
+        for (uint32_t slotIndex = 0;
+                      slotIndex < slotCount && !dedicated;
+                      slotIndex++) {
+            // Slot still live?
+            if (pSlotLastUses[slotIndex] >= 
+                pImageLifetimes[imageIndex].firstUse) {
+                continue;
+            }
+
+            // Slot incompatible?
+            if (pSlotDedicatedAllocateInfos[slotIndex].image != 
+                VK_NULL_HANDLE ||
+                pSlotMemoryPropertyFlags[slotIndex] != 
+                pMemoryPropertyFlags[imageIndex] ||
+                pSlotAllocationTypes[slotIndex] != 
+                pAllocationTypes[imageIndex] ||
+                (pSlotMemoryRequirements[slotIndex].memoryTypeBits &
+                 pImageMemoryRequirements->memoryTypeBits) == 0) {
+                continue;
+            }
+
+            // Growth.
+            VkDeviceSize slotSize = pSlotMemoryRequirements[slotIndex].size;
+            VkDeviceSize growth = 
+                pImageMemoryRequirements->size > slotSize ?
+                pImageMemoryRequirements->size - slotSize : 0;
+            if (growth < bestGrowth ||
+                (growth == bestGrowth &&
+                 slotSize < pSlotMemoryRequirements[bestSlotIndex].size)) {
+                bestSlotIndex = slotIndex;
+                bestGrowth = growth;
+            }
+        }
+
+        if (bestSlotIndex == UINT32_MAX) {
+            // New slot.
+            bestSlotIndex = slotCount++;
+            pSlotMemoryRequirements[bestSlotIndex] = 
+                *pImageMemoryRequirements;
+            pSlotMemoryPropertyFlags[bestSlotIndex] = 
+                pMemoryPropertyFlags[imageIndex];
+            pSlotAllocationTypes[bestSlotIndex] = 
+                pAllocationTypes[imageIndex];
+            pSlotDedicatedAllocateInfos[bestSlotIndex] = 
+                pDedicatedAllocateInfos[imageIndex];
+        }
+        else {
+            // Merge into slot.
+            VkMemoryRequirements* pSlotMemoryRequirement = 
+                &pSlotMemoryRequirements[bestSlotIndex];
+            if (pSlotMemoryRequirement->size < 
+                pImageMemoryRequirements->size) {
+                pSlotMemoryRequirement->size = 
+                    pImageMemoryRequirements->size;
+            }
+            if (pSlotMemoryRequirement->alignment < 
+                pImageMemoryRequirements->alignment) {
+                pSlotMemoryRequirement->alignment = 
+                    pImageMemoryRequirements->alignment;
+            }
+            pSlotMemoryRequirement->memoryTypeBits &= 
+                pImageMemoryRequirements->memoryTypeBits;
+        }
+        pSlotLastUses[bestSlotIndex] = 
+            pImageLifetimes[imageIndex].lastUse;
+        pImageSlotIndices[imageIndex] = bestSlotIndex;
+    }
+
+    // Allocate packed shared memory for slots.
+    VkResult result = 
+        vkxAllocatePackedSharedMemory(
+                pMemoryTypeTable,
+                device,
+                slotCount,
+                pSlotMemoryRequirements,
+                pSlotMemoryPropertyFlags,
+                pSlotAllocationTypes,
+                pSlotDedicatedAllocateInfos,
+                pAllocator,
+                pSharedMemory, NULL);
+    if (!VKX_IS_ERROR(result)) {
+        // Expand memory views, one per image.
+        VkxDeviceMemoryView* pMemoryViews = 
+            (VkxDeviceMemoryView*)malloc(
+                    sizeof(VkxDeviceMemoryView) * imageCount);
+        for (uint32_t imageIndex = 0;
+                      imageIndex < imageCount;
+                      imageIndex++) {
+            pMemoryViews[imageIndex] = 
+                pSharedMemory->pMemoryViews[pImageSlotIndices[imageIndex]];
+            pMemoryViews[imageIndex].size = 
+                pMemoryRequirements[imageIndex].size;
+        }
+        free(pSharedMemory->pMemoryViews);
+        pSharedMemory->pMemoryViews = pMemoryViews;
+        pSharedMemory->memoryViewCount = imageCount;
+    }
+
+    // Free.
+    VKX_LOCAL_FREE(pImageSlotIndices);
+    VKX_LOCAL_FREE(pSlotLastUses);
+    VKX_LOCAL_FREE(pSlotDedicatedAllocateInfos);
+    VKX_LOCAL_FREE(pSlotAllocationTypes);
+    VKX_LOCAL_FREE(pSlotMemoryPropertyFlags);
+    VKX_LOCAL_FREE(pSlotMemoryRequirements);
+    VKX_LOCAL_FREE(pImageOrder);
+    return result;
+}
+
+// Create image group, aliased if image lifetimes are non-NULL.
+static VkResult createImageGroup(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             uint32_t imageCount,
             const VkImageCreateInfo* pImageCreateInfos,
             const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxImageLifetime* pImageLifetimes,
             const VkAllocationCallbacks* pAllocator,
             VkxImageGroup* pImageGroup)
 {
@@ -172,10 +510,13 @@ VkResult vkxCreateImageGroup(
         pImages[imageIndex] = VK_NULL_HANDLE;
     }
 
-    // Allocate memory requirements.
+    // Allocate memory requirements and dedicated allocate infos.
     VkMemoryRequirements* pMemoryRequirements = 
         (VkMemoryRequirements*)VKX_LOCAL_MALLOC(
                 sizeof(VkMemoryRequirements) * imageCount);
+    VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos = 
+        (VkMemoryDedicatedAllocateInfo*)VKX_LOCAL_MALLOC(
+                sizeof(VkMemoryDedicatedAllocateInfo) * imageCount);
 
     // Iterate images.
     for (uint32_t imageIndex = 0; 
@@ -188,7 +529,8 @@ VkResult vkxCreateImageGroup(
                     &pImageCreateInfos[imageIndex], pAllocator,
                     &pImages[imageIndex]);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy image group.
             pImages[imageIndex] = VK_NULL_HANDLE;
@@ -197,25 +539,59 @@ VkResult vkxCreateImageGroup(
         }
 
         // Get image memory requirements.
-        vkGetImageMemoryRequirements(
+        getImageMemoryRequirements(
                 device, 
                 pImages[imageIndex],
-                &pMemoryRequirements[imageIndex]);
+                &pMemoryRequirements[imageIndex],
+                &pDedicatedAllocateInfos[imageIndex]);
     }
 
     {
-        // Allocate shared memory.
+        // Allocation types, so linear and optimal images are
+        // separated by buffer image granularity.
+        VkxAllocationType* pAllocationTypes = 
+            (VkxAllocationType*)VKX_LOCAL_MALLOC(
+                    sizeof(VkxAllocationType) * imageCount);
+        for (uint32_t imageIndex = 0;
+                      imageIndex < imageCount;
+                      imageIndex++) {
+            pAllocationTypes[imageIndex] = 
+                pImageCreateInfos[imageIndex].tiling == 
+                VK_IMAGE_TILING_LINEAR ?
+                VKX_ALLOCATION_TYPE_LINEAR :
+                VKX_ALLOCATION_TYPE_OPTIMAL;
+        }
+
+        // Allocate packed or aliased shared memory.
         VkResult result = 
-            vkxAllocateSharedMemory(
-                    physicalDevice,
+            pImageLifetimes ?
+            allocateAliasedSharedMemory(
+                    pMemoryTypeTable,
                     device,
                     imageCount,
                     pMemoryRequirements,
                     pMemoryPropertyFlags,
+                    pAllocationTypes,
+                    pDedicatedAllocateInfos,
+                    pImageLifetimes,
                     pAllocator,
-                    &pImageGroup->sharedMemory);
+                    &pImageGroup->sharedMemory) :
+            vkxAllocatePackedSharedMemory(
+                    pMemoryTypeTable,
+                    device,
+                    imageCount,
+                    pMemoryRequirements,
+                    pMemoryPropertyFlags,
+                    pAllocationTypes,
+                    pDedicatedAllocateInfos,
+                    pAllocator,
+                    &pImageGroup->sharedMemory, NULL);
+
+        // Free allocation types.
+        VKX_LOCAL_FREE(pAllocationTypes);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy image group.
             vkxDestroyImageGroup(device, pImageGroup, pAllocator);
@@ -236,7 +612,8 @@ VkResult vkxCreateImageGroup(
                     pMemoryViews[imageIndex].memory,
                     pMemoryViews[imageIndex].offset);
         if (VKX_IS_ERROR(result)) {
-            // Free memory requirements.
+            // Free memory requirements and dedicated allocate infos.
+            VKX_LOCAL_FREE(pDedicatedAllocateInfos);
             VKX_LOCAL_FREE(pMemoryRequirements);
             // Destroy image group.
             vkxDestroyImageGroup(device, pImageGroup, pAllocator);
@@ -244,12 +621,57 @@ VkResult vkxCreateImageGroup(
         }
     }
 
-    // Free memory requirements.
+    // Free memory requirements and dedicated allocate infos.
+    VKX_LOCAL_FREE(pDedicatedAllocateInfos);
     VKX_LOCAL_FREE(pMemoryRequirements);
 
     return VK_SUCCESS;
 }
 
+VkResult vkxCreateImageGroup(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t imageCount,
+            const VkImageCreateInfo* pImageCreateInfos,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxImageGroup* pImageGroup)
+{
+    return 
+        createImageGroup(
+                pMemoryTypeTable,
+                device,
+                imageCount,
+                pImageCreateInfos,
+                pMemoryPropertyFlags,
+                NULL,
+                pAllocator,
+                pImageGroup);
+}
+
+VkResult vkxCreateAliasedImageGroup(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t imageCount,
+            const VkImageCreateInfo* pImageCreateInfos,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxImageLifetime* pImageLifetimes,
+            const VkAllocationCallbacks* pAllocator,
+            VkxImageGroup* pImageGroup)
+{
+    assert(pImageLifetimes || imageCount == 0);
+    return 
+        createImageGroup(
+                pMemoryTypeTable,
+                device,
+                imageCount,
+                pImageCreateInfos,
+                pMemoryPropertyFlags,
+                pImageLifetimes,
+                pAllocator,
+                pImageGroup);
+}
+
 void vkxDestroyImageGroup(
             VkDevice device,
             VkxImageGroup* pImageGroup,
@@ -420,16 +842,16 @@ void vkxDestroyImageViews(
     }
 }
 
-// Transition image layout.
-VkResult vkxCmdTransitionImageLayout(
-            VkCommandBuffer commandBuffer,
+// Get transition image layout barrier.
+VkResult vkxGetTransitionImageLayoutBarrier(
             VkImage image,
             VkImageLayout oldLayout,
             VkImageLayout newLayout,
             VkImageSubresourceRange subresourceRange,
-            VkPipelineStageFlags srcStageMask,
-            VkPipelineStageFlags dstStageMask)
+            VkImageMemoryBarrier* pMemoryBarrier)
 {
+    assert(pMemoryBarrier);
+
     // Image memory barrier.
     VkImageMemoryBarrier memoryBarrier = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -527,6 +949,33 @@ VkResult vkxCmdTransitionImageLayout(
             break;
     }
 
+    *pMemoryBarrier = memoryBarrier;
+    return VK_SUCCESS;
+}
+
+// Transition image layout command.
+VkResult vkxCmdTransitionImageLayout(
+            VkCommandBuffer commandBuffer,
+            VkImage image,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkImageSubresourceRange subresourceRange,
+            VkPipelineStageFlags srcStageMask,
+            VkPipelineStageFlags dstStageMask)
+{
+    // Image memory barrier.
+    VkImageMemoryBarrier memoryBarrier;
+    VkResult result = 
+        vkxGetTransitionImageLayoutBarrier(
+                image,
+                oldLayout,
+                newLayout,
+                subresourceRange,
+                &memoryBarrier);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
     // Record barrier.
     vkCmdPipelineBarrier(
             commandBuffer,
@@ -550,43 +999,66 @@ VkResult vkxTransitionImageLayout(
             VkImageSubresourceRange subresourceRange,
             const VkAllocationCallbacks* pAllocator)
 {
-    // Command buffer allocate info.
-    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .pNext = NULL,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool = commandPool,
-        .commandBufferCount = 1
-    };
+    // Transition image layout asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxTransitionImageLayoutAsync(
+                device,
+                queue,
+                commandPool,
+                image,
+                oldLayout,
+                newLayout,
+                subresourceRange,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
 
-    // Command buffer begin info.
-    VkCommandBufferBeginInfo commandBufferBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = NULL,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = NULL
-    };
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
 
-    // Command buffer.
-    VkCommandBuffer commandBuffer;
+// Transition image layout asynchronously.
+VkResult vkxTransitionImageLayoutAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkImageSubresourceRange subresourceRange,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
+{
+    assert(pTicket);
     {
-        // Allocate and begin command buffer.
+        // Begin transfer ticket.
         VkResult result = 
-            vkxAllocateAndBeginCommandBuffers(
-                    device,
-                    &commandBufferAllocateInfo,
-                    &commandBufferBeginInfo,
-                    &commandBuffer);
-        // Allocate and begin command buffer error?
+            vkxBeginTransferTicket(
+                    device, 
+                    commandPool, 
+                    pTicket);
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
+    // Fence pool, if any, for submit.
+    pTicket->pFencePool = pFencePool;
+
     // Transition image layout.
     VkResult result =
         vkxCmdTransitionImageLayout(
-                commandBuffer,
+                pTicket->commandBuffer,
                 image,
                 oldLayout,
                 newLayout,
@@ -597,23 +1069,19 @@ VkResult vkxTransitionImageLayout(
     // Transition image layout error?
     if (VKX_IS_ERROR(result)) {
         // End command buffer.
-        vkEndCommandBuffer(commandBuffer);
-        // Free command buffer.
-        vkFreeCommandBuffers(
-                device,
-                commandPool,
-                1, &commandBuffer);
+        vkEndCommandBuffer(pTicket->commandBuffer);
+        // Destroy transfer ticket.
+        vkxDestroyTransferTicket(pTicket, pAllocator);
         return result;
     }
 
-
-    // End, flush, and free command buffer.
-    return vkxEndFlushAndFreeCommandBuffers(
-                device,
+    // Submit transfer ticket.
+    return vkxSubmitTransferTicket(
                 queue,
-                commandPool,
-                1, &commandBuffer,
-                pAllocator);
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
 }
 
 // Copy image to buffer.
@@ -627,67 +1095,94 @@ VkResult vkxCopyImageToBuffer(
             uint32_t regionCount,
             const VkBufferImageCopy* pRegions,
             const VkAllocationCallbacks* pAllocator)
+{
+    // Copy image to buffer asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxCopyImageToBufferAsync(
+                device,
+                queue,
+                commandPool,
+                srcImage,
+                srcImageLayout,
+                dstBuffer,
+                regionCount,
+                pRegions,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Copy image to buffer asynchronously.
+VkResult vkxCopyImageToBufferAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage srcImage,
+            VkImageLayout srcImageLayout,
+            VkBuffer dstBuffer,
+            uint32_t regionCount,
+            const VkBufferImageCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
 {
     assert(
         srcImageLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL ||
         srcImageLayout == VK_IMAGE_LAYOUT_GENERAL ||
         srcImageLayout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
+    assert(pTicket);
     if (regionCount == 0) {
+        // Nothing to copy, so complete.
+        memset(pTicket, 0, sizeof(VkxTransferTicket));
         return VK_SUCCESS;
     }
 
     // Sanity check.
     assert(pRegions);
 
-    // Command buffer allocate info.
-    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .pNext = NULL,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool = commandPool,
-        .commandBufferCount = 1
-    };
-
-    // Command buffer begin info.
-    VkCommandBufferBeginInfo commandBufferBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = NULL,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = NULL
-    };
-
-    // Command buffer.
-    VkCommandBuffer commandBuffer;
     {
-        // Allocate and begin command buffer.
+        // Begin transfer ticket.
         VkResult result = 
-            vkxAllocateAndBeginCommandBuffers(
-                    device,
-                    &commandBufferAllocateInfo,
-                    &commandBufferBeginInfo,
-                    &commandBuffer);
-        // Allocate and begin command buffer error?
+            vkxBeginTransferTicket(
+                    device, 
+                    commandPool, 
+                    pTicket);
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
+    // Fence pool, if any, for submit.
+    pTicket->pFencePool = pFencePool;
+
     // Copy image to buffer.
     vkCmdCopyImageToBuffer(
-            commandBuffer,
+            pTicket->commandBuffer,
             srcImage,
             srcImageLayout,
             dstBuffer,
             regionCount,
             pRegions);
 
-    // End, flush, and free command buffer.
-    return vkxEndFlushAndFreeCommandBuffers(
-                device,
+    // Submit transfer ticket.
+    return vkxSubmitTransferTicket(
                 queue,
-                commandPool,
-                1, &commandBuffer,
-                pAllocator);
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
 }
 
 // Copy buffer to image.
@@ -701,77 +1196,105 @@ VkResult vkxCopyBufferToImage(
             uint32_t regionCount,
             const VkBufferImageCopy* pRegions,
             const VkAllocationCallbacks* pAllocator)
+{
+    // Copy buffer to image asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxCopyBufferToImageAsync(
+                device,
+                queue,
+                commandPool,
+                srcBuffer,
+                dstImage,
+                dstImageLayout,
+                regionCount,
+                pRegions,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Copy buffer to image asynchronously.
+VkResult vkxCopyBufferToImageAsync(
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkBuffer srcBuffer,
+            VkImage dstImage,
+            VkImageLayout dstImageLayout,
+            uint32_t regionCount,
+            const VkBufferImageCopy* pRegions,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
 {
     assert(
         dstImageLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL ||
         dstImageLayout == VK_IMAGE_LAYOUT_GENERAL ||
         dstImageLayout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
+    assert(pTicket);
     if (regionCount == 0) {
+        // Nothing to copy, so complete.
+        memset(pTicket, 0, sizeof(VkxTransferTicket));
         return VK_SUCCESS;
     }
 
     // Sanity check.
     assert(pRegions);
 
-    // Command buffer allocate info.
-    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .pNext = NULL,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandPool = commandPool,
-        .commandBufferCount = 1
-    };
-
-    // Command buffer begin info.
-    VkCommandBufferBeginInfo commandBufferBeginInfo = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = NULL,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = NULL
-    };
-
-    // Command buffer.
-    VkCommandBuffer commandBuffer;
     {
-        // Allocate and begin command buffer.
+        // Begin transfer ticket.
         VkResult result = 
-            vkxAllocateAndBeginCommandBuffers(
-                    device,
-                    &commandBufferAllocateInfo,
-                    &commandBufferBeginInfo,
-                    &commandBuffer);
-        // Allocate and begin command buffer error?
+            vkxBeginTransferTicket(
+                    device, 
+                    commandPool, 
+                    pTicket);
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
+    // Fence pool, if any, for submit.
+    pTicket->pFencePool = pFencePool;
+
     // Copy buffer to image.
     vkCmdCopyBufferToImage(
-            commandBuffer,
+            pTicket->commandBuffer,
             srcBuffer,
             dstImage,
             dstImageLayout,
             regionCount,
             pRegions);
 
-    // End, flush, and free command buffer.
-    return vkxEndFlushAndFreeCommandBuffers(
-                device,
+    // Submit transfer ticket.
+    return vkxSubmitTransferTicket(
                 queue,
-                commandPool,
-                1, &commandBuffer,
-                pAllocator);
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
 }
 
 // Get image data.
 VkResult vkxGetImageData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkImage image,
             const VkxImageDataAccess* pImageDataAccess,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator,
             void* pData)
 {
@@ -787,29 +1310,20 @@ VkResult vkxGetImageData(
 
     // Staging buffer.
     VkxBuffer stagingBuffer;
+    VkxStagingBlock* pStagingBlock = NULL;
     {
-        // Staging buffer create info.
-        VkBufferCreateInfo bufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = NULL,
-            .flags = 0,
-            .size = pImageDataAccess->size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 0,
-            .pQueueFamilyIndices = NULL
-        };
-        // Create staging buffer.
+        // Acquire staging buffer.
         VkResult result = 
-            vkxCreateBuffer(
-                    physicalDevice,
+            vkxAcquireStagingBuffer(
+                    pMemoryTypeTable,
                     device,
-                    &bufferCreateInfo,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    pImageDataAccess->size,
+                    VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    pStagingPool,
                     pAllocator,
+                    &pStagingBlock,
                     &stagingBuffer);
-        // Create staging buffer error?
+        // Acquire staging buffer error?
         if (VKX_IS_ERROR(result)) {
             return result;
         }
@@ -836,44 +1350,93 @@ VkResult vkxGetImageData(
                     pAllocator);
         // Copy image to buffer error?
         if (VKX_IS_ERROR(result)) {
-            // Destroy staging buffer.
-            vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    device, 
+                    pStagingPool, pStagingBlock, 
+                    &stagingBuffer, pAllocator);
             return result;
         }
     }
 
-    // Map staging buffer data.
-    void* pStagingBufferData = NULL;
+    // Invalidate staging buffer data, in case not host-coherent.
+    VkxDeviceMemoryView stagingMemoryView = {
+        .memory = stagingBuffer.memory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
     VkResult result = 
-        vkMapMemory(
+        vkxInvalidateMemoryViews(
+                pMemoryTypeTable,
                 device,
-                stagingBuffer.memory,
-                0, pImageDataAccess->size,
-                0, &pStagingBufferData);
-    // Map staging buffer data ok?
+                1, &stagingMemoryView);
     if (VKX_IS_OK(result)) {
-        // Read staging buffer data.
-        memcpy(pData, pStagingBufferData, pImageDataAccess->size);
-        // Unmap staging buffer data.
-        vkUnmapMemory(device, stagingBuffer.memory);
+        // Read staging buffer data, persistently mapped.
+        memcpy(pData, stagingBuffer.pMappedData, pImageDataAccess->size);
     }
 
-    // Destroy staging buffer.
-    vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+    // Release staging buffer.
+    vkxReleaseStagingBuffer(
+            device, 
+            pStagingPool, pStagingBlock, 
+            &stagingBuffer, pAllocator);
 
     return result;
 }
 
 // Set image data.
 VkResult vkxSetImageData(
-            VkPhysicalDevice physicalDevice,
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             VkQueue queue,
             VkCommandPool commandPool,
             VkImage image,
             const VkxImageDataAccess* pImageDataAccess,
             const void* pData,
+            VkxStagingPool* pStagingPool,
             const VkAllocationCallbacks* pAllocator)
+{
+    // Set image data asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxSetImageDataAsync(
+                pMemoryTypeTable,
+                device,
+                queue,
+                commandPool,
+                image,
+                pImageDataAccess,
+                pData,
+                pStagingPool,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Set image data asynchronously.
+VkResult vkxSetImageDataAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            const void* pData,
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
 {
     assert(pImageDataAccess);
     assert(
@@ -881,61 +1444,56 @@ VkResult vkxSetImageData(
         pImageDataAccess->layout == VK_IMAGE_LAYOUT_GENERAL ||
         pImageDataAccess->layout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
     assert(pData || pImageDataAccess->size == 0);
+    assert(pTicket);
+    memset(pTicket, 0, sizeof(VkxTransferTicket));
     if (pImageDataAccess->size == 0) {
         return VK_SUCCESS;
     }
 
     // Staging buffer.
     VkxBuffer stagingBuffer;
+    VkxStagingBlock* pStagingBlock = NULL;
     {
-        // Staging buffer create info.
-        VkBufferCreateInfo bufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = NULL,
-            .flags = 0,
-            .size = pImageDataAccess->size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 0,
-            .pQueueFamilyIndices = NULL
-        };
-        // Create staging buffer.
+        // Acquire staging buffer.
         VkResult result = 
-            vkxCreateBuffer(
-                    physicalDevice,
+            vkxAcquireStagingBuffer(
+                    pMemoryTypeTable,
                     device,
-                    &bufferCreateInfo,
-                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                    pImageDataAccess->size,
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    pStagingPool,
                     pAllocator,
+                    &pStagingBlock,
                     &stagingBuffer);
-        // Create staging buffer error?
+        // Acquire staging buffer error?
         if (VKX_IS_ERROR(result)) {
             return result;
         }
     }
 
     {
-        // Map staging buffer data.
-        void* pStagingBufferData = NULL;
+        // Write staging buffer data, persistently mapped.
+        memcpy(stagingBuffer.pMappedData, pData, pImageDataAccess->size);
+
+        // Flush staging buffer data, in case not host-coherent.
+        VkxDeviceMemoryView stagingMemoryView = {
+            .memory = stagingBuffer.memory,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
         VkResult result = 
-            vkMapMemory(
+            vkxFlushMemoryViews(
+                    pMemoryTypeTable,
                     device,
-                    stagingBuffer.memory,
-                    0, pImageDataAccess->size,
-                    0, &pStagingBufferData);
-        // Map staging buffer data error?
+                    1, &stagingMemoryView);
         if (VKX_IS_ERROR(result)) {
-            // Destroy staging buffer.
-            vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    device, 
+                    pStagingPool, pStagingBlock, 
+                    &stagingBuffer, pAllocator);
             return result;
         }
-
-        // Write staging buffer data.
-        memcpy(pStagingBufferData, pData, pImageDataAccess->size);
-
-        // Unmap staging buffer data.
-        vkUnmapMemory(device, stagingBuffer.memory);
     }
 
     // Copy buffer to image.
@@ -948,17 +1506,242 @@ VkResult vkxSetImageData(
         .imageExtent = pImageDataAccess->extent
     };
     VkResult result = 
-        vkxCopyBufferToImage(
+        vkxCopyBufferToImageAsync(
                 device,
                 queue,
                 commandPool,
                 stagingBuffer.buffer,
                 image, pImageDataAccess->layout,
                 1, &region,
-                pAllocator);
+                pFencePool,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
+    if (VKX_IS_ERROR(result)) {
+        // Release staging buffer.
+        vkxReleaseStagingBuffer(
+                device, 
+                pStagingPool, pStagingBlock, 
+                &stagingBuffer, pAllocator);
+        return result;
+    }
 
-    // Destroy staging buffer.
-    vkxDestroyBuffer(device, &stagingBuffer, pAllocator);
+    // Defer staging buffer release to ticket.
+    pTicket->pStagingPool = pStagingPool;
+    pTicket->pStagingBlock = pStagingBlock;
+    pTicket->stagingBuffer = stagingBuffer;
+    return result;
+}
+
+// Set image regions.
+VkResult vkxSetImageRegions(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            uint32_t regionCount,
+            const VkxImageRegionData* pRegions,
+            VkxStagingPool* pStagingPool,
+            const VkAllocationCallbacks* pAllocator)
+{
+    // Set image regions asynchronously.
+    VkxTransferTicket ticket;
+    VkResult result = 
+        vkxSetImageRegionsAsync(
+                pMemoryTypeTable,
+                device,
+                queue,
+                commandPool,
+                image,
+                imageLayout,
+                texelSize,
+                regionCount,
+                pRegions,
+                pStagingPool,
+                NULL,
+                VK_NULL_HANDLE, 0,
+                pAllocator,
+                &ticket);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Wait for and destroy ticket.
+    result = vkxWaitTransferTicket(&ticket, UINT64_MAX);
+    vkxDestroyTransferTicket(&ticket, pAllocator);
+    return result;
+}
+
+// Set image regions asynchronously.
+VkResult vkxSetImageRegionsAsync(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkImage image,
+            VkImageLayout imageLayout,
+            VkDeviceSize texelSize,
+            uint32_t regionCount,
+            const VkxImageRegionData* pRegions,
+            VkxStagingPool* pStagingPool,
+            VkxFencePool* pFencePool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferTicket* pTicket)
+{
+    assert(
+        imageLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL ||
+        imageLayout == VK_IMAGE_LAYOUT_GENERAL ||
+        imageLayout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
+    assert(texelSize > 0);
+    assert(pRegions || regionCount == 0);
+    assert(pTicket);
+    memset(pTicket, 0, sizeof(VkxTransferTicket));
+    if (regionCount == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Region offset alignment, the least common multiple of the texel
+    // size and 4.
+    VkDeviceSize alignment = 
+        texelSize % 4 == 0 ? texelSize : 
+        texelSize % 2 == 0 ? texelSize * 2 : texelSize * 4;
+
+    // Copy regions, packed tightly, one after the other.
+    VkBufferImageCopy* pCopyRegions = 
+        (VkBufferImageCopy*)VKX_LOCAL_MALLOC(
+                sizeof(VkBufferImageCopy) * regionCount);
+    VkDeviceSize size = 0;
+    for (uint32_t regionIndex = 0; 
+                  regionIndex < regionCount; regionIndex++) {
+        const VkxImageRegionData* pRegion = &pRegions[regionIndex];
+        VkDeviceSize offset = (size + alignment - 1) / alignment * alignment;
+        VkBufferImageCopy* pCopyRegion = &pCopyRegions[regionIndex];
+        pCopyRegion->bufferOffset = offset;
+        pCopyRegion->bufferRowLength = 0;
+        pCopyRegion->bufferImageHeight = 0;
+        pCopyRegion->imageSubresource = pRegion->subresourceLayers;
+        pCopyRegion->imageOffset = pRegion->offset;
+        pCopyRegion->imageExtent = pRegion->extent;
+        size = offset + 
+            texelSize * 
+            pRegion->extent.width * 
+            pRegion->extent.height * 
+            pRegion->extent.depth * 
+            pRegion->subresourceLayers.layerCount;
+    }
+
+    // Staging buffer.
+    VkxBuffer stagingBuffer;
+    VkxStagingBlock* pStagingBlock = NULL;
+    {
+        // Acquire staging buffer.
+        VkResult result = 
+            vkxAcquireStagingBuffer(
+                    pMemoryTypeTable,
+                    device,
+                    size,
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    pStagingPool,
+                    pAllocator,
+                    &pStagingBlock,
+                    &stagingBuffer);
+        // Acquire staging buffer error?
+        if (VKX_IS_ERROR(result)) {
+            VKX_LOCAL_FREE(pCopyRegions);
+            return result;
+        }
+    }
+
+    // Write staging buffer data, persistently mapped, row by row.
+    for (uint32_t regionIndex = 0; 
+                  regionIndex < regionCount; regionIndex++) {
+        const VkxImageRegionData* pRegion = &pRegions[regionIndex];
+        VkDeviceSize rowSize = texelSize * pRegion->extent.width;
+        VkDeviceSize rowPitch = 
+            pRegion->rowPitch ? pRegion->rowPitch : rowSize;
+        VkDeviceSize slicePitch = 
+            pRegion->slicePitch ? 
+            pRegion->slicePitch : rowPitch * pRegion->extent.height;
+        uint32_t sliceCount = 
+            pRegion->extent.depth * pRegion->subresourceLayers.layerCount;
+        const char* pSrc = (const char*)pRegion->pData;
+        char* pDst = 
+            (char*)stagingBuffer.pMappedData + 
+                   pCopyRegions[regionIndex].bufferOffset;
+        assert(pSrc);
+        assert(rowPitch >= rowSize);
+        if (rowPitch == rowSize && 
+            slicePitch == rowSize * pRegion->extent.height) {
+            // Tightly packed, copy at once.
+            memcpy(pDst, pSrc, rowSize * pRegion->extent.height * sliceCount);
+            continue;
+        }
+        for (uint32_t slice = 0; slice < sliceCount; slice++) {
+            const char* pSrcRow = pSrc + slicePitch * slice;
+            for (uint32_t row = 0; row < pRegion->extent.height; row++) {
+                memcpy(pDst, pSrcRow, rowSize);
+                pDst += rowSize;
+                pSrcRow += rowPitch;
+            }
+        }
+    }
+
+    {
+        // Flush staging buffer data, in case not host-coherent.
+        VkxDeviceMemoryView stagingMemoryView = {
+            .memory = stagingBuffer.memory,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+        VkResult result = 
+            vkxFlushMemoryViews(
+                    pMemoryTypeTable,
+                    device,
+                    1, &stagingMemoryView);
+        if (VKX_IS_ERROR(result)) {
+            // Release staging buffer.
+            vkxReleaseStagingBuffer(
+                    device, 
+                    pStagingPool, pStagingBlock, 
+                    &stagingBuffer, pAllocator);
+            VKX_LOCAL_FREE(pCopyRegions);
+            return result;
+        }
+    }
+
+    // Copy buffer to image, all regions at once.
+    VkResult result = 
+        vkxCopyBufferToImageAsync(
+                device,
+                queue,
+                commandPool,
+                stagingBuffer.buffer,
+                image, imageLayout,
+                regionCount, pCopyRegions,
+                pFencePool,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                pTicket);
+    VKX_LOCAL_FREE(pCopyRegions);
+    if (VKX_IS_ERROR(result)) {
+        // Release staging buffer.
+        vkxReleaseStagingBuffer(
+                device, 
+                pStagingPool, pStagingBlock, 
+                &stagingBuffer, pAllocator);
+        return result;
+    }
 
+    // Defer staging buffer release to ticket.
+    pTicket->pStagingPool = pStagingPool;
+    pTicket->pStagingBlock = pStagingBlock;
+    pTicket->stagingBuffer = stagingBuffer;
     return result;
 }
@@ -32,26 +32,150 @@
 #include <vulkanx/result.h>
 #include <vulkanx/memory.h>
 
-// Find memory type index.
-uint32_t vkxFindMemoryTypeIndex(
+// Is memory type ranked before other memory type?
+static VkBool32 isMemoryTypeRankedBefore(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkBool32 preferDeviceLocal,
+            uint32_t memoryTypeIndex1,
+            uint32_t memoryTypeIndex2)
+{
+    const VkPhysicalDeviceMemoryProperties* pMemoryProperties = 
+        &pMemoryTypeTable->memoryProperties;
+    const VkMemoryType* pMemoryType1 = 
+        &pMemoryProperties->memoryTypes[memoryTypeIndex1];
+    const VkMemoryType* pMemoryType2 = 
+        &pMemoryProperties->memoryTypes[memoryTypeIndex2];
+
+    // Device-local preference.
+    VkBool32 isDeviceLocal1 = 
+        (pMemoryType1->propertyFlags & 
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+    VkBool32 isDeviceLocal2 = 
+        (pMemoryType2->propertyFlags & 
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+    if (isDeviceLocal1 != isDeviceLocal2) {
+        return isDeviceLocal1 == preferDeviceLocal;
+    }
+
+    // Heap size, largest first.
+    VkDeviceSize heapSize1 = 
+        pMemoryProperties->memoryHeaps[pMemoryType1->heapIndex].size;
+    VkDeviceSize heapSize2 = 
+        pMemoryProperties->memoryHeaps[pMemoryType2->heapIndex].size;
+    if (heapSize1 != heapSize2) {
+        return heapSize1 > heapSize2;
+    }
+
+    // Otherwise, preserve implementation order.
+    return memoryTypeIndex1 < memoryTypeIndex2;
+}
+
+// Rank memory types.
+static void rankMemoryTypes(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkBool32 preferDeviceLocal,
+            uint32_t* pRankedIndices)
+{
+    uint32_t memoryTypeCount = 
+        pMemoryTypeTable->memoryProperties.memoryTypeCount;
+
+    // Insertion sort, there are at most 32 memory types.
+    for (uint32_t rankIndex = 0;
+                  rankIndex < memoryTypeCount;
+                  rankIndex++) {
+        uint32_t memoryTypeIndex = rankIndex;
+        uint32_t insertIndex = rankIndex;
+        while (insertIndex > 0 &&
+               isMemoryTypeRankedBefore(
+                    pMemoryTypeTable,
+                    preferDeviceLocal,
+                    memoryTypeIndex,
+                    pRankedIndices[insertIndex - 1])) {
+            pRankedIndices[insertIndex] = pRankedIndices[insertIndex - 1];
+            insertIndex--;
+        }
+        pRankedIndices[insertIndex] = memoryTypeIndex;
+    }
+}
+
+// Get memory type table.
+void vkxGetMemoryTypeTable(
             VkPhysicalDevice physicalDevice,
-            VkMemoryPropertyFlags memoryPropertyFlags,
-                         uint32_t memoryTypeBits)
+            VkxMemoryTypeTable* pMemoryTypeTable)
 {
-    // Memory properties.
-    VkPhysicalDeviceMemoryProperties memoryProperties;
-    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    assert(pMemoryTypeTable);
+    memset(pMemoryTypeTable, 0, sizeof(VkxMemoryTypeTable));
+
+    // Get memory properties.
+    vkGetPhysicalDeviceMemoryProperties(
+            physicalDevice, 
+            &pMemoryTypeTable->memoryProperties);
 
-    // Memory types.
+    // Get buffer image granularity.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    pMemoryTypeTable->bufferImageGranularity = 
+        properties.limits.bufferImageGranularity;
+    pMemoryTypeTable->nonCoherentAtomSize = 
+        properties.limits.nonCoherentAtomSize;
+
+    // Memory type bits per flag bit.
     for (uint32_t memoryTypeIndex = 0;
                   memoryTypeIndex < 
-                  memoryProperties.memoryTypeCount;
+                  pMemoryTypeTable->memoryProperties.memoryTypeCount;
                   memoryTypeIndex++) {
-        if ((memoryTypeBits & (1 << memoryTypeIndex)) &&
-            (memoryProperties.memoryTypes[
-             memoryTypeIndex].propertyFlags & 
-                    memoryPropertyFlags) ==
-                    memoryPropertyFlags) {
+        VkMemoryPropertyFlags propertyFlags = 
+            pMemoryTypeTable->memoryProperties.
+                memoryTypes[memoryTypeIndex].propertyFlags;
+        for (uint32_t flagBitIndex = 0;
+                      flagBitIndex < 32;
+                      flagBitIndex++) {
+            if (propertyFlags & ((uint32_t)1 << flagBitIndex)) {
+                pMemoryTypeTable->memoryTypeBitsPerFlagBit[flagBitIndex] |=
+                    (uint32_t)1 << memoryTypeIndex;
+            }
+        }
+    }
+
+    // Rank memory types.
+    rankMemoryTypes(
+            pMemoryTypeTable, VK_TRUE,
+            pMemoryTypeTable->deviceLocalRankedIndices);
+    rankMemoryTypes(
+            pMemoryTypeTable, VK_FALSE,
+            pMemoryTypeTable->hostRankedIndices);
+}
+
+// Find memory type index in memory type table.
+uint32_t vkxMemoryTypeTableFindIndex(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+                         uint32_t memoryTypeBits)
+{
+    // Supported memory type bits.
+    memoryTypeBits = 
+        vkxMemoryTypeTableFilterBits(
+                pMemoryTypeTable,
+                memoryPropertyFlags,
+                memoryTypeBits);
+    if (memoryTypeBits == 0) {
+        // Not found.
+        return UINT32_MAX;
+    }
+
+    // Ranked indices.
+    const uint32_t* pRankedIndices = 
+        (memoryPropertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ?
+            pMemoryTypeTable->deviceLocalRankedIndices :
+            pMemoryTypeTable->hostRankedIndices;
+
+    // Highest ranked supported memory type.
+    for (uint32_t rankIndex = 0;
+                  rankIndex < 
+                  pMemoryTypeTable->memoryProperties.memoryTypeCount;
+                  rankIndex++) {
+        uint32_t memoryTypeIndex = pRankedIndices[rankIndex];
+        if (memoryTypeBits & ((uint32_t)1 << memoryTypeIndex)) {
             // Found.
             return memoryTypeIndex;
         }
@@ -61,44 +185,175 @@ uint32_t vkxFindMemoryTypeIndex(
     return UINT32_MAX;
 }
 
-// Allocate shared memory.
-VkResult vkxAllocateSharedMemory(
+// Filter memory type bits in memory type table.
+uint32_t vkxMemoryTypeTableFilterBits(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+                         uint32_t memoryTypeBits)
+{
+    assert(pMemoryTypeTable);
+
+    // Mask valid memory types.
+    uint32_t memoryTypeCount = 
+        pMemoryTypeTable->memoryProperties.memoryTypeCount;
+    if (memoryTypeCount < 32) {
+        memoryTypeBits &= ((uint32_t)1 << memoryTypeCount) - 1;
+    }
+
+    // Mask memory types supporting each flag bit.
+    for (uint32_t flagBitIndex = 0;
+                  memoryPropertyFlags != 0 && memoryTypeBits != 0;
+                  flagBitIndex++) {
+        if (memoryPropertyFlags & 1) {
+            memoryTypeBits &= 
+                pMemoryTypeTable->memoryTypeBitsPerFlagBit[flagBitIndex];
+        }
+        memoryPropertyFlags >>= 1;
+    }
+    return memoryTypeBits;
+}
+
+// Pad allocation size in memory type table.
+VkDeviceSize vkxMemoryTypeTablePadAllocationSize(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            uint32_t memoryTypeIndex,
+            VkDeviceSize allocationSize)
+{
+    assert(pMemoryTypeTable);
+    assert(memoryTypeIndex < 
+           pMemoryTypeTable->memoryProperties.memoryTypeCount);
+
+    // Host-visible but not host-coherent?
+    VkMemoryPropertyFlags propertyFlags = 
+        pMemoryTypeTable->memoryProperties.
+            memoryTypes[memoryTypeIndex].propertyFlags;
+    VkDeviceSize atomSize = pMemoryTypeTable->nonCoherentAtomSize;
+    if ((propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+       !(propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) &&
+        atomSize > 1 && allocationSize % atomSize) {
+        // Round up to multiple of non-coherent atom size.
+        allocationSize = 
+        allocationSize - allocationSize % atomSize + atomSize;
+    }
+    return allocationSize;
+}
+
+// Find memory type index.
+uint32_t vkxFindMemoryTypeIndex(
             VkPhysicalDevice physicalDevice,
+            VkMemoryPropertyFlags memoryPropertyFlags,
+                         uint32_t memoryTypeBits)
+{
+    // Get memory type table.
+    VkxMemoryTypeTable memoryTypeTable;
+    vkxGetMemoryTypeTable(physicalDevice, &memoryTypeTable);
+
+    // Find.
+    return 
+        vkxMemoryTypeTableFindIndex(
+                &memoryTypeTable,
+                memoryPropertyFlags,
+                memoryTypeBits);
+}
+
+// Packing order key.
+typedef struct PackingOrderKey_
+{
+    // Memory requirement index.
+    uint32_t memoryRequirementIndex;
+
+    // Allocation type.
+    VkxAllocationType allocationType;
+
+    // Alignment.
+    VkDeviceSize alignment;
+
+    // Size.
+    VkDeviceSize size;
+}
+PackingOrderKey;
+
+// Compare packing order keys, for qsort.
+//
+// Groups allocation types together so that at most one granularity 
+// page boundary separates linear and optimal resources, then sorts by 
+// decreasing alignment and decreasing size, so that each offset is
+// already aligned for the next requirement as often as possible.
+static int comparePackingOrderKeys(const void* pValue1, const void* pValue2)
+{
+    const PackingOrderKey* pKey1 = (const PackingOrderKey*)pValue1;
+    const PackingOrderKey* pKey2 = (const PackingOrderKey*)pValue2;
+    if (pKey1->allocationType != pKey2->allocationType) {
+        return pKey1->allocationType < pKey2->allocationType ? -1 : +1;
+    }
+    if (pKey1->alignment != pKey2->alignment) {
+        return pKey1->alignment > pKey2->alignment ? -1 : +1;
+    }
+    if (pKey1->size != pKey2->size) {
+        return pKey1->size > pKey2->size ? -1 : +1;
+    }
+    return pKey1->memoryRequirementIndex < 
+           pKey2->memoryRequirementIndex ? -1 : +1;
+}
+
+// Is requirement dedicated?
+static VkBool32 isDedicated(
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos,
+            uint32_t memoryRequirementIndex)
+{
+    return pDedicatedAllocateInfos &&
+          (pDedicatedAllocateInfos[memoryRequirementIndex].image != 
+                VK_NULL_HANDLE ||
+           pDedicatedAllocateInfos[memoryRequirementIndex].buffer != 
+                VK_NULL_HANDLE);
+}
+
+// Allocate shared memory, in order or packed, with dedicated 
+// requirements in unique memories of their own.
+static VkResult allocateSharedMemory(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
             VkDevice device,
             uint32_t memoryRequirementCount,
             const VkMemoryRequirements* pMemoryRequirements,
             const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            VkBool32 packed,
+            const VkxAllocationType* pAllocationTypes,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos,
             const VkAllocationCallbacks* pAllocator,
-            VkxSharedDeviceMemory* pSharedMemory)
+            VkxSharedDeviceMemory* pSharedMemory,
+            VkDeviceSize* pWastedSize)
 {
     assert(pMemoryRequirements || memoryRequirementCount == 0);
     assert(pSharedMemory);
     memset(pSharedMemory, 0, sizeof(VkxSharedDeviceMemory));
+    if (pWastedSize) {
+        *pWastedSize = 0;
+    }
     if (memoryRequirementCount == 0) {
         return VK_SUCCESS;
     }
 
+    assert(pMemoryTypeTable);
+
     // Memory type count.
-    uint32_t memoryTypeCount;
-    VkMemoryPropertyFlags memoryTypePropertyFlags[VK_MAX_MEMORY_TYPES];
-    {
-        // Get memory properties.
-        VkPhysicalDeviceMemoryProperties memoryProperties;
-        vkGetPhysicalDeviceMemoryProperties(
-                physicalDevice, 
-                &memoryProperties);
-
-        // Get memory type count.
-        memoryTypeCount = 
-        memoryProperties.memoryTypeCount;
-
-        // Get memory type property flags.
-        for (uint32_t memoryTypeIndex = 0;
-                      memoryTypeIndex < memoryTypeCount;
-                      memoryTypeIndex++) {
-            memoryTypePropertyFlags[memoryTypeIndex] = 
-            memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
-        }
+    uint32_t memoryTypeCount = 
+        pMemoryTypeTable->memoryProperties.memoryTypeCount;
+
+    // Allocate memory requirement type indices.
+    uint32_t* pMemoryRequirementTypeIndices = 
+        VKX_LOCAL_MALLOC(sizeof(uint32_t) * memoryRequirementCount);
+
+    // Iterate requirements, initially hold supported memory type bits 
+    // in memory requirement type indices.
+    for (uint32_t memoryRequirementIndex = 0;
+                  memoryRequirementIndex < memoryRequirementCount;
+                  memoryRequirementIndex++) {
+        pMemoryRequirementTypeIndices[memoryRequirementIndex] = 
+            vkxMemoryTypeTableFilterBits(
+                    pMemoryTypeTable,
+                    pMemoryPropertyFlags[memoryRequirementIndex],
+                    pMemoryRequirements[
+                     memoryRequirementIndex].memoryTypeBits);
     }
 
     // Memory type info.
@@ -111,6 +366,9 @@ VkResult vkxAllocateSharedMemory(
         // UINT32_MAX if unused.
         uint32_t uniqueMemoryIndex;
 
+        // Allocation type of last requirement, or 0 if none.
+        VkxAllocationType lastAllocationType;
+
         // Allocate info.
         VkMemoryAllocateInfo allocateInfo;
     }
@@ -125,6 +383,7 @@ VkResult vkxAllocateSharedMemory(
         MemoryTypeInfo* pMemoryTypeInfo = &memoryTypeInfos[memoryTypeIndex];
         pMemoryTypeInfo->supportedRequirementCount = 0;
         pMemoryTypeInfo->uniqueMemoryIndex = UINT32_MAX;
+        pMemoryTypeInfo->lastAllocationType = (VkxAllocationType)0;
         pMemoryTypeInfo->allocateInfo.sType = 
             VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         pMemoryTypeInfo->allocateInfo.pNext = NULL;
@@ -136,12 +395,8 @@ VkResult vkxAllocateSharedMemory(
                       memoryRequirementIndex < memoryRequirementCount;
                       memoryRequirementIndex++) {
             // Memory type supports requirement?
-            if ((((uint32_t)1 << memoryTypeIndex) &
-                 pMemoryRequirements[
-                  memoryRequirementIndex].memoryTypeBits) &&
-                (memoryTypePropertyFlags[memoryTypeIndex] &
-                 pMemoryPropertyFlags[memoryRequirementIndex]) ==
-                 pMemoryPropertyFlags[memoryRequirementIndex]) {
+            if (pMemoryRequirementTypeIndices[memoryRequirementIndex] &
+                ((uint32_t)1 << memoryTypeIndex)) {
 
                 // Increment supported requirement count.
                 pMemoryTypeInfo->supportedRequirementCount++;
@@ -149,31 +404,33 @@ VkResult vkxAllocateSharedMemory(
         } 
     }
 
-    // Allocate memory requirement type indices.
-    uint32_t* pMemoryRequirementTypeIndices = 
-        VKX_LOCAL_MALLOC(sizeof(uint32_t) * memoryRequirementCount);
-
     // Iterate requirements, select memory type index for
-    // each requirement which supports the most other requirements.
+    // each requirement which supports the most other requirements,
+    // breaking ties by rank.
     for (uint32_t memoryRequirementIndex = 0;
                   memoryRequirementIndex < memoryRequirementCount;
                   memoryRequirementIndex++) {
 
+        uint32_t supportedMemoryTypeBits = 
+            pMemoryRequirementTypeIndices[memoryRequirementIndex];
         uint32_t maxSupportedRequirementCount = 0;
         uint32_t maxSupportedRequirementCountIndex = UINT32_MAX;
 
-        // Iterate memory types.
-        for (uint32_t memoryTypeIndex = 0;
-                      memoryTypeIndex < memoryTypeCount; 
-                      memoryTypeIndex++) {
+        // Ranked indices.
+        const uint32_t* pRankedIndices = 
+            (pMemoryPropertyFlags[memoryRequirementIndex] & 
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) ?
+                pMemoryTypeTable->deviceLocalRankedIndices :
+                pMemoryTypeTable->hostRankedIndices;
+
+        // Iterate memory types in rank order.
+        for (uint32_t rankIndex = 0;
+                      rankIndex < memoryTypeCount; 
+                      rankIndex++) {
+            uint32_t memoryTypeIndex = pRankedIndices[rankIndex];
 
             // Memory type supports requirement?
-            if ((((uint32_t)1 << memoryTypeIndex) &
-                 pMemoryRequirements[
-                  memoryRequirementIndex].memoryTypeBits) &&
-                (memoryTypePropertyFlags[memoryTypeIndex] &
-                 pMemoryPropertyFlags[memoryRequirementIndex]) ==
-                 pMemoryPropertyFlags[memoryRequirementIndex])  {
+            if (supportedMemoryTypeBits & ((uint32_t)1 << memoryTypeIndex)) {
 
                 // Memory type supported requirement count.
                 uint32_t supportedRequirementCount =
@@ -205,15 +462,67 @@ VkResult vkxAllocateSharedMemory(
     // Initialize unique memory count.
     pSharedMemory->uniqueMemoryCount = 0;
 
-    // Iterate memory requirements.
+    // Allocate unique memory index for each requirement.
+    uint32_t* pUniqueMemoryIndices = 
+        VKX_LOCAL_MALLOC(sizeof(uint32_t) * memoryRequirementCount);
+
+    // Allocate packing order keys.
+    PackingOrderKey* pOrderKeys = 
+        VKX_LOCAL_MALLOC(sizeof(PackingOrderKey) * memoryRequirementCount);
     for (uint32_t memoryRequirementIndex = 0;
                   memoryRequirementIndex < memoryRequirementCount;
                   memoryRequirementIndex++) {
+        PackingOrderKey* pOrderKey = &pOrderKeys[memoryRequirementIndex];
+        pOrderKey->memoryRequirementIndex = memoryRequirementIndex;
+        pOrderKey->allocationType = 
+            pAllocationTypes ? 
+            pAllocationTypes[memoryRequirementIndex] : 
+            VKX_ALLOCATION_TYPE_LINEAR;
+        pOrderKey->alignment = 
+            pMemoryRequirements[memoryRequirementIndex].alignment;
+        pOrderKey->size = 
+            pMemoryRequirements[memoryRequirementIndex].size;
+    }
+
+    // Packed? Sort, otherwise keep input order.
+    if (packed) {
+        qsort(
+            pOrderKeys, 
+            memoryRequirementCount, 
+            sizeof(PackingOrderKey), 
+            comparePackingOrderKeys);
+    }
+
+    // Granularity, only honored if packed with allocation types.
+    VkDeviceSize granularity = 
+        packed && pAllocationTypes ? 
+        pMemoryTypeTable->bufferImageGranularity : 1;
+
+    // Iterate memory requirements in order.
+    for (uint32_t orderIndex = 0;
+                  orderIndex < memoryRequirementCount;
+                  orderIndex++) {
+
+        // Memory requirement index.
+        uint32_t memoryRequirementIndex = 
+            pOrderKeys[orderIndex].memoryRequirementIndex;
+        VkxAllocationType allocationType = 
+            pOrderKeys[orderIndex].allocationType;
 
         // Memory type index for this requirement.
         uint32_t memoryTypeIndex = 
             pMemoryRequirementTypeIndices[memoryRequirementIndex];
 
+        // Dedicated? Unique memory of its own.
+        if (isDedicated(pDedicatedAllocateInfos, memoryRequirementIndex)) {
+            pUniqueMemoryIndices[memoryRequirementIndex] = 
+                pSharedMemory->uniqueMemoryCount++;
+            pSharedMemory->pMemoryViews[memoryRequirementIndex].offset = 0;
+            pSharedMemory->pMemoryViews[memoryRequirementIndex].size = 
+                pMemoryRequirements[memoryRequirementIndex].size;
+            continue;
+        }
+
         // Memory type info.
         MemoryTypeInfo* pMemoryTypeInfo = 
             &memoryTypeInfos[memoryTypeIndex];
@@ -223,21 +532,37 @@ VkResult vkxAllocateSharedMemory(
             pMemoryTypeInfo->uniqueMemoryIndex =
                 pSharedMemory->uniqueMemoryCount++;
         }
+        pUniqueMemoryIndices[memoryRequirementIndex] = 
+            pMemoryTypeInfo->uniqueMemoryIndex;
+
+        // Required alignment.
+        VkDeviceSize alignment = 
+            pMemoryRequirements[memoryRequirementIndex].alignment;
+
+        // Different allocation type than last requirement? Must not
+        // share a granularity page.
+        if (pMemoryTypeInfo->lastAllocationType != 0 &&
+            pMemoryTypeInfo->lastAllocationType != allocationType &&
+            alignment < granularity) {
+            alignment = granularity;
+        }
+        pMemoryTypeInfo->lastAllocationType = allocationType;
 
         // Round memory type allocation size up to required alignment.
-        if (pMemoryTypeInfo->allocateInfo.allocationSize %
-            pMemoryRequirements[memoryRequirementIndex].alignment) {
-            pMemoryTypeInfo->allocateInfo.allocationSize =
-                pMemoryTypeInfo->allocateInfo.allocationSize -
-                pMemoryTypeInfo->allocateInfo.allocationSize %
-                pMemoryRequirements[memoryRequirementIndex].alignment +
-                pMemoryRequirements[memoryRequirementIndex].alignment;
+        VkDeviceSize offset = pMemoryTypeInfo->allocateInfo.allocationSize;
+        if (offset % alignment) {
+            offset = offset - offset % alignment + alignment;
+        }
+
+        // Accumulate wasted size.
+        if (pWastedSize) {
+            *pWastedSize += 
+                offset - pMemoryTypeInfo->allocateInfo.allocationSize;
         }
 
         // Initialize memory view offset.
         pSharedMemory->
-            pMemoryViews[memoryRequirementIndex].offset = 
-            pMemoryTypeInfo->allocateInfo.allocationSize;
+            pMemoryViews[memoryRequirementIndex].offset = offset;
 
         // Initialize memory view size.
         pSharedMemory->
@@ -245,10 +570,13 @@ VkResult vkxAllocateSharedMemory(
             pMemoryRequirements[memoryRequirementIndex].size;
 
         // Increment memory type allocation size.
-        pMemoryTypeInfo->allocateInfo.allocationSize +=
+        pMemoryTypeInfo->allocateInfo.allocationSize = offset +
             pMemoryRequirements[memoryRequirementIndex].size;
     }
 
+    // Free packing order keys.
+    VKX_LOCAL_FREE(pOrderKeys);
+
     // Allocate unique memories array.
     pSharedMemory->pUniqueMemories = 
         malloc(sizeof(VkDeviceMemory) * pSharedMemory->uniqueMemoryCount);
@@ -270,6 +598,13 @@ VkResult vkxAllocateSharedMemory(
         // Memory type used?
         uint32_t uniqueMemoryIndex = pMemoryTypeInfo->uniqueMemoryIndex;
         if (uniqueMemoryIndex != UINT32_MAX) {
+            // Pad allocation size.
+            pMemoryTypeInfo->allocateInfo.allocationSize = 
+                vkxMemoryTypeTablePadAllocationSize(
+                        pMemoryTypeTable,
+                        memoryTypeIndex,
+                        pMemoryTypeInfo->allocateInfo.allocationSize);
+
             // Allocate memory.
             VkResult result = 
                 vkAllocateMemory(
@@ -278,7 +613,8 @@ VkResult vkxAllocateSharedMemory(
                         &pSharedMemory->pUniqueMemories[uniqueMemoryIndex]);
             // Error?
             if (VKX_IS_ERROR(result)) {
-                // Free memory requirement type indices.
+                // Free memory requirement type and unique indices.
+                VKX_LOCAL_FREE(pUniqueMemoryIndices);
                 VKX_LOCAL_FREE(pMemoryRequirementTypeIndices);
                 // Free shared memory.
                 pSharedMemory->pUniqueMemories[
@@ -289,30 +625,107 @@ VkResult vkxAllocateSharedMemory(
         }
     }
 
-    // Iterate memory requirements.
+    // Iterate dedicated memory requirements.
     for (uint32_t memoryRequirementIndex = 0;
                   memoryRequirementIndex < memoryRequirementCount;
                   memoryRequirementIndex++) {
- 
-        // Memory type index for this requirement.
-        uint32_t memoryTypeIndex = 
-            pMemoryRequirementTypeIndices[memoryRequirementIndex];
+        if (!isDedicated(pDedicatedAllocateInfos, memoryRequirementIndex)) {
+            continue;
+        }
 
-        // Memory type info.
-        MemoryTypeInfo* pMemoryTypeInfo = 
-            &memoryTypeInfos[memoryTypeIndex];
+        // Allocate dedicated memory.
+        uint32_t uniqueMemoryIndex = 
+            pUniqueMemoryIndices[memoryRequirementIndex];
+        VkMemoryAllocateInfo allocateInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = &pDedicatedAllocateInfos[memoryRequirementIndex],
+            .allocationSize = 
+                pMemoryRequirements[memoryRequirementIndex].size,
+            .memoryTypeIndex = 
+                pMemoryRequirementTypeIndices[memoryRequirementIndex]
+        };
+        VkResult result = 
+            vkAllocateMemory(
+                    device,
+                    &allocateInfo, pAllocator,
+                    &pSharedMemory->pUniqueMemories[uniqueMemoryIndex]);
+        // Error?
+        if (VKX_IS_ERROR(result)) {
+            // Free memory requirement type and unique indices.
+            VKX_LOCAL_FREE(pUniqueMemoryIndices);
+            VKX_LOCAL_FREE(pMemoryRequirementTypeIndices);
+            // Free shared memory.
+            pSharedMemory->pUniqueMemories[
+                uniqueMemoryIndex] = VK_NULL_HANDLE;
+            vkxFreeSharedMemory(device, pSharedMemory, pAllocator);
+            return result;
+        }
+    }
 
+    // Iterate memory requirements.
+    for (uint32_t memoryRequirementIndex = 0;
+                  memoryRequirementIndex < memoryRequirementCount;
+                  memoryRequirementIndex++) {
         // Initialize memory view unique memory handle.
         pSharedMemory->pMemoryViews[memoryRequirementIndex].memory =
-            pSharedMemory->pUniqueMemories[pMemoryTypeInfo->uniqueMemoryIndex];
+            pSharedMemory->pUniqueMemories[
+                pUniqueMemoryIndices[memoryRequirementIndex]];
     }
 
-    // Free memory requirement type indices.
+    // Free memory requirement type and unique indices.
+    VKX_LOCAL_FREE(pUniqueMemoryIndices);
     VKX_LOCAL_FREE(pMemoryRequirementTypeIndices);
 
     return VK_SUCCESS;
 }
 
+// Allocate shared memory.
+VkResult vkxAllocateSharedMemory(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryRequirementCount,
+            const VkMemoryRequirements* pMemoryRequirements,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkAllocationCallbacks* pAllocator,
+            VkxSharedDeviceMemory* pSharedMemory)
+{
+    return 
+        allocateSharedMemory(
+                pMemoryTypeTable,
+                device,
+                memoryRequirementCount,
+                pMemoryRequirements,
+                pMemoryPropertyFlags,
+                VK_FALSE, NULL, NULL,
+                pAllocator,
+                pSharedMemory, NULL);
+}
+
+// Allocate packed shared memory.
+VkResult vkxAllocatePackedSharedMemory(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryRequirementCount,
+            const VkMemoryRequirements* pMemoryRequirements,
+            const VkMemoryPropertyFlags* pMemoryPropertyFlags,
+            const VkxAllocationType* pAllocationTypes,
+            const VkMemoryDedicatedAllocateInfo* pDedicatedAllocateInfos,
+            const VkAllocationCallbacks* pAllocator,
+            VkxSharedDeviceMemory* pSharedMemory,
+            VkDeviceSize* pWastedSize)
+{
+    return 
+        allocateSharedMemory(
+                pMemoryTypeTable,
+                device,
+                memoryRequirementCount,
+                pMemoryRequirements,
+                pMemoryPropertyFlags,
+                VK_TRUE, pAllocationTypes, pDedicatedAllocateInfos,
+                pAllocator,
+                pSharedMemory, pWastedSize);
+}
+
 // Free shared memory.
 void vkxFreeSharedMemory(
             VkDevice device,
@@ -337,3 +750,286 @@ void vkxFreeSharedMemory(
         memset(pSharedMemory, 0, sizeof(VkxSharedDeviceMemory));
     }
 }
+
+// Get mapped memory range, rounded out to non-coherent atom size.
+static void getMappedMemoryRange(
+            VkDeviceSize atomSize,
+            const VkxDeviceMemoryView* pMemoryView,
+            VkMappedMemoryRange* pMappedMemoryRange)
+{
+    if (atomSize == 0) {
+        atomSize = 1;
+    }
+
+    // Round offset down.
+    VkDeviceSize offset = pMemoryView->offset;
+    offset -= offset % atomSize;
+
+    // Round end up, unless whole size.
+    VkDeviceSize size = VK_WHOLE_SIZE;
+    if (pMemoryView->size != VK_WHOLE_SIZE) {
+        VkDeviceSize end = pMemoryView->offset + pMemoryView->size;
+        if (end % atomSize) {
+            end = end - end % atomSize + atomSize;
+        }
+        size = end - offset;
+    }
+
+    // Mapped memory range.
+    pMappedMemoryRange->sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    pMappedMemoryRange->pNext = NULL;
+    pMappedMemoryRange->memory = pMemoryView->memory;
+    pMappedMemoryRange->offset = offset;
+    pMappedMemoryRange->size = size;
+}
+
+// Get mapped memory ranges, rounded out to non-coherent atom size.
+static void getMappedMemoryRanges(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            uint32_t memoryViewCount,
+            const VkxDeviceMemoryView* pMemoryViews,
+            VkMappedMemoryRange* pMappedMemoryRanges)
+{
+    for (uint32_t memoryViewIndex = 0;
+                  memoryViewIndex < memoryViewCount;
+                  memoryViewIndex++) {
+        getMappedMemoryRange(
+                pMemoryTypeTable->nonCoherentAtomSize,
+                &pMemoryViews[memoryViewIndex],
+                &pMappedMemoryRanges[memoryViewIndex]);
+    }
+}
+
+// Flush memory views.
+VkResult vkxFlushMemoryViews(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryViewCount,
+            const VkxDeviceMemoryView* pMemoryViews)
+{
+    assert(pMemoryTypeTable);
+    if (memoryViewCount == 0) {
+        return VK_SUCCESS;
+    }
+    assert(pMemoryViews);
+
+    // Get mapped memory ranges.
+    VkMappedMemoryRange* pMappedMemoryRanges = 
+        (VkMappedMemoryRange*)VKX_LOCAL_MALLOC(
+                sizeof(VkMappedMemoryRange) * memoryViewCount);
+    getMappedMemoryRanges(
+            pMemoryTypeTable,
+            memoryViewCount, pMemoryViews,
+            pMappedMemoryRanges);
+
+    // Flush.
+    VkResult result = 
+        vkFlushMappedMemoryRanges(
+                device,
+                memoryViewCount, pMappedMemoryRanges);
+
+    // Free mapped memory ranges.
+    VKX_LOCAL_FREE(pMappedMemoryRanges);
+    return result;
+}
+
+// Invalidate memory views.
+VkResult vkxInvalidateMemoryViews(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            uint32_t memoryViewCount,
+            const VkxDeviceMemoryView* pMemoryViews)
+{
+    assert(pMemoryTypeTable);
+    if (memoryViewCount == 0) {
+        return VK_SUCCESS;
+    }
+    assert(pMemoryViews);
+
+    // Get mapped memory ranges.
+    VkMappedMemoryRange* pMappedMemoryRanges = 
+        (VkMappedMemoryRange*)VKX_LOCAL_MALLOC(
+                sizeof(VkMappedMemoryRange) * memoryViewCount);
+    getMappedMemoryRanges(
+            pMemoryTypeTable,
+            memoryViewCount, pMemoryViews,
+            pMappedMemoryRanges);
+
+    // Invalidate.
+    VkResult result = 
+        vkInvalidateMappedMemoryRanges(
+                device,
+                memoryViewCount, pMappedMemoryRanges);
+
+    // Free mapped memory ranges.
+    VKX_LOCAL_FREE(pMappedMemoryRanges);
+    return result;
+}
+
+// Create mapped memory range batch.
+void vkxCreateMappedMemoryRangeBatch(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkxMappedMemoryRangeBatch* pBatch)
+{
+    assert(pMemoryTypeTable);
+    assert(pBatch);
+    memset(pBatch, 0, sizeof(VkxMappedMemoryRangeBatch));
+    pBatch->device = device;
+    pBatch->nonCoherentAtomSize = pMemoryTypeTable->nonCoherentAtomSize;
+}
+
+// Destroy mapped memory range batch.
+void vkxDestroyMappedMemoryRangeBatch(
+            VkxMappedMemoryRangeBatch* pBatch)
+{
+    if (pBatch) {
+        // Free ranges.
+        free(pBatch->pRanges);
+
+        // Nullify.
+        memset(pBatch, 0, sizeof(VkxMappedMemoryRangeBatch));
+    }
+}
+
+// Mapped memory range batch add.
+void vkxMappedMemoryRangeBatchAdd(
+            VkxMappedMemoryRangeBatch* pBatch,
+            const VkxDeviceMemoryView* pMemoryView)
+{
+    assert(pBatch);
+    assert(pMemoryView);
+    if (pMemoryView->size == 0) {
+        return;
+    }
+
+    // Round out.
+    VkMappedMemoryRange range;
+    getMappedMemoryRange(pBatch->nonCoherentAtomSize, pMemoryView, &range);
+
+    // Extends last range? Common for sequential writes.
+    if (pBatch->rangeCount > 0) {
+        VkMappedMemoryRange* pLastRange = 
+            &pBatch->pRanges[pBatch->rangeCount - 1];
+        if (pLastRange->memory == range.memory &&
+            pLastRange->size != VK_WHOLE_SIZE &&
+            range.size != VK_WHOLE_SIZE &&
+            pLastRange->offset <= range.offset &&
+            pLastRange->offset + pLastRange->size >= range.offset) {
+            VkDeviceSize end = range.offset + range.size;
+            if (pLastRange->offset + pLastRange->size < end) {
+                pLastRange->size = end - pLastRange->offset;
+            }
+            return;
+        }
+    }
+
+    // Push range.
+    if (pBatch->rangeCount == pBatch->rangeCapacity) {
+        pBatch->rangeCapacity = 
+        pBatch->rangeCapacity == 0 ? 16 :
+        pBatch->rangeCapacity * 2;
+        pBatch->pRanges = 
+            (VkMappedMemoryRange*)realloc(
+                    pBatch->pRanges,
+                    sizeof(VkMappedMemoryRange) * pBatch->rangeCapacity);
+    }
+    pBatch->pRanges[pBatch->rangeCount++] = range;
+}
+
+// Compare mapped memory ranges, by memory then offset.
+static int compareMappedMemoryRanges(const void* pValue1, const void* pValue2)
+{
+    const VkMappedMemoryRange* pRange1 = 
+        (const VkMappedMemoryRange*)pValue1;
+    const VkMappedMemoryRange* pRange2 = 
+        (const VkMappedMemoryRange*)pValue2;
+    int memoryOrder = 
+        memcmp(&pRange1->memory, &pRange2->memory, sizeof(VkDeviceMemory));
+    if (memoryOrder != 0) {
+        return memoryOrder;
+    }
+    if (pRange1->offset != pRange2->offset) {
+        return pRange1->offset < pRange2->offset ? -1 : +1;
+    }
+    return 0;
+}
+
+// Coalesce mapped memory range batch, return range count.
+static uint32_t coalesceMappedMemoryRanges(VkxMappedMemoryRangeBatch* pBatch)
+{
+    if (pBatch->rangeCount < 2) {
+        return pBatch->rangeCount;
+    }
+
+    // Sort by memory then offset.
+    qsort(
+        pBatch->pRanges,
+        pBatch->rangeCount,
+        sizeof(VkMappedMemoryRange),
+        compareMappedMemoryRanges);
+
+    // Merge overlapping or adjacent ranges of the same memory.
+    uint32_t mergedCount = 1;
+    for (uint32_t rangeIndex = 1;
+                  rangeIndex < pBatch->rangeCount;
+                  rangeIndex++) {
+        VkMappedMemoryRange* pMerged = &pBatch->pRanges[mergedCount - 1];
+        const VkMappedMemoryRange* pRange = &pBatch->pRanges[rangeIndex];
+        if (pMerged->memory == pRange->memory &&
+            (pMerged->size == VK_WHOLE_SIZE ||
+             pMerged->offset + pMerged->size >= pRange->offset)) {
+            // Merge.
+            if (pMerged->size != VK_WHOLE_SIZE) {
+                if (pRange->size == VK_WHOLE_SIZE) {
+                    pMerged->size = VK_WHOLE_SIZE;
+                }
+                else if (pMerged->offset + pMerged->size < 
+                         pRange->offset + pRange->size) {
+                    pMerged->size = 
+                        pRange->offset + pRange->size - pMerged->offset;
+                }
+            }
+        }
+        else {
+            pBatch->pRanges[mergedCount++] = *pRange;
+        }
+    }
+    return mergedCount;
+}
+
+// Mapped memory range batch flush.
+VkResult vkxMappedMemoryRangeBatchFlush(
+            VkxMappedMemoryRangeBatch* pBatch)
+{
+    assert(pBatch);
+    if (pBatch->rangeCount == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Coalesce and flush.
+    uint32_t rangeCount = coalesceMappedMemoryRanges(pBatch);
+    pBatch->rangeCount = 0;
+    return 
+        vkFlushMappedMemoryRanges(
+                pBatch->device,
+                rangeCount, pBatch->pRanges);
+}
+
+// Mapped memory range batch invalidate.
+VkResult vkxMappedMemoryRangeBatchInvalidate(
+            VkxMappedMemoryRangeBatch* pBatch)
+{
+    assert(pBatch);
+    if (pBatch->rangeCount == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Coalesce and invalidate.
+    uint32_t rangeCount = coalesceMappedMemoryRanges(pBatch);
+    pBatch->rangeCount = 0;
+    return 
+        vkInvalidateMappedMemoryRanges(
+                pBatch->device,
+                rangeCount, pBatch->pRanges);
+}
@@ -852,6 +852,10 @@ VkResult vkxCreateDevice(
         malloc(sizeof(VkPhysicalDeviceFeatures));
     vkGetPhysicalDeviceFeatures(
             physicalDevice, pDevice->pPhysicalDeviceFeatures);
+    pDevice->pMemoryTypeTable = 
+        malloc(sizeof(VkxMemoryTypeTable));
+    vkxGetMemoryTypeTable(
+            physicalDevice, pDevice->pMemoryTypeTable);
 
     // Allocate queue families.
     pDevice->queueFamilyCount = pCreateInfo->queueFamilyCreateInfoCount;
@@ -968,6 +972,8 @@ void vkxDestroyDevice(
     if (pDevice) {
         // Free physical device features.
         free(pDevice->pPhysicalDeviceFeatures);
+        // Free physical device memory type table.
+        free(pDevice->pMemoryTypeTable);
         for (uint32_t familyIndex = 0; familyIndex < pDevice->queueFamilyCount;
                       familyIndex++) {
             VkxDeviceQueueFamily* pQueueFamily = 
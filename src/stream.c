@@ -0,0 +1,1070 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#if defined(__unix__) || defined(__APPLE__)
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#define VKX_STREAM_USE_MMAP 1
+#endif // #if defined(__unix__) || defined(__APPLE__)
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if VKX_STREAM_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // #if VKX_STREAM_USE_MMAP
+#include <vulkanx/result.h>
+#include <vulkanx/stream.h>
+#include "thread.h"
+
+// Stream ring cell.
+//
+// Bounded multi-producer queue after Vyukov: each cell carries a 
+// sequence number which equals its position when free for producers, 
+// and its position plus one when full for the consumer.
+typedef struct StreamCell_
+{
+    atomic_uint_fast64_t sequence;
+    VkxStreamRequest request;
+}
+StreamCell;
+
+// Stream entry, a request gathered into a batch.
+typedef struct StreamEntry_
+{
+    VkxStreamRequest request;
+    VkResult result;
+}
+StreamEntry;
+
+// Stream batch.
+typedef struct StreamBatch_
+{
+    VkxUploadBatch uploadBatch;
+    uint32_t entryCount;
+    uint32_t entryCapacity;
+    StreamEntry* pEntries;
+    uint64_t lastValue;
+}
+StreamBatch;
+
+// Streamer state.
+struct VkxStreamerState_
+{
+    // Memory type table, copied.
+    VkxMemoryTypeTable memoryTypeTable;
+
+    // Allocation callbacks.
+    const VkAllocationCallbacks* pAllocator;
+
+    // Ring.
+    uint64_t cellMask;
+    StreamCell* pCells;
+    atomic_uint_fast64_t enqueuePosition;
+    uint64_t dequeuePosition;
+
+    // Completed value.
+    atomic_uint_fast64_t completedValue;
+
+    // Fence pool, worker only.
+    VkxFencePool fencePool;
+
+    // Batches in flight, oldest first.
+    uint32_t batchHead;
+    uint32_t batchCount;
+    StreamBatch batches[VKX_STREAMER_MAX_BATCHES_IN_FLIGHT];
+
+    // Worker thread.
+    Thread thread;
+    Mutex mutex;
+    Condition condition;
+    atomic_bool running;
+    atomic_bool sleeping;
+};
+
+// Stream ring pop, worker only.
+static VkBool32 streamRingPop(
+            VkxStreamerState* pState,
+            VkxStreamRequest* pRequest)
+{
+    uint64_t position = pState->dequeuePosition;
+    StreamCell* pCell = &pState->pCells[position & pState->cellMask];
+    uint64_t sequence = 
+        atomic_load_explicit(&pCell->sequence, memory_order_acquire);
+    if (sequence != position + 1) {
+        // Empty, or producer still writing.
+        return VK_FALSE;
+    }
+    *pRequest = pCell->request;
+    atomic_store_explicit(
+            &pCell->sequence, 
+            position + pState->cellMask + 1, 
+            memory_order_release);
+    pState->dequeuePosition = position + 1;
+    return VK_TRUE;
+}
+
+// Stream ring empty? Worker only.
+static VkBool32 streamRingEmpty(VkxStreamerState* pState)
+{
+    uint64_t position = pState->dequeuePosition;
+    StreamCell* pCell = &pState->pCells[position & pState->cellMask];
+    return 
+        atomic_load_explicit(&pCell->sequence, memory_order_acquire) != 
+        position + 1;
+}
+
+// Retire completed batches, oldest first. If wait, block on oldest batch.
+static void retireStreamBatches(
+            VkxStreamer* pStreamer,
+            VkBool32 wait)
+{
+    VkxStreamerState* pState = pStreamer->pState;
+    while (pState->batchCount > 0) {
+        StreamBatch* pBatch = &pState->batches[pState->batchHead];
+
+        // Complete?
+        VkResult result = 
+            wait ?
+            vkxWaitTransferTicket(&pBatch->uploadBatch.ticket, UINT64_MAX) :
+            vkxGetTransferTicketStatus(&pBatch->uploadBatch.ticket);
+        if (result == VK_NOT_READY ||
+            result == VK_TIMEOUT) {
+            break;
+        }
+        wait = VK_FALSE;
+
+        // Invoke callbacks.
+        for (uint32_t entryIndex = 0;
+                      entryIndex < pBatch->entryCount;
+                      entryIndex++) {
+            StreamEntry* pEntry = &pBatch->pEntries[entryIndex];
+            if (pEntry->request.pfnCallback) {
+                pEntry->request.pfnCallback(
+                        pEntry->request.pUserData,
+                        VKX_IS_ERROR(pEntry->result) ? 
+                            pEntry->result : result);
+            }
+        }
+
+        // Publish completed value.
+        atomic_store_explicit(
+                &pState->completedValue,
+                pBatch->lastValue,
+                memory_order_release);
+
+        // Destroy batch.
+        vkxDestroyUploadBatch(&pBatch->uploadBatch, pState->pAllocator);
+        free(pBatch->pEntries);
+        memset(pBatch, 0, sizeof(StreamBatch));
+        pState->batchHead = 
+            (pState->batchHead + 1) % VKX_STREAMER_MAX_BATCHES_IN_FLIGHT;
+        pState->batchCount--;
+    }
+}
+
+// Gather requests from ring into new batch, then submit.
+static void submitStreamBatch(VkxStreamer* pStreamer)
+{
+    VkxStreamerState* pState = pStreamer->pState;
+    if (pState->batchCount == VKX_STREAMER_MAX_BATCHES_IN_FLIGHT) {
+        // Block on oldest batch.
+        retireStreamBatches(pStreamer, VK_TRUE);
+    }
+    StreamBatch* pBatch = 
+        &pState->batches[
+            (pState->batchHead + pState->batchCount) % 
+                VKX_STREAMER_MAX_BATCHES_IN_FLIGHT];
+    vkxBeginUploadBatch(
+            &pState->memoryTypeTable, 
+            pStreamer->device, 
+            &pBatch->uploadBatch);
+    pBatch->uploadBatch.pFencePool = &pState->fencePool;
+
+    // Gather.
+    VkDeviceSize batchSize = 0;
+    VkxStreamRequest request;
+    while (batchSize < VKX_STREAMER_MAX_BATCH_SIZE &&
+           streamRingPop(pState, &request)) {
+        VkResult result;
+        if (request.buffer != VK_NULL_HANDLE) {
+            // Write buffer.
+            result = 
+                vkxUploadBatchWriteBuffer(
+                        &pBatch->uploadBatch,
+                        request.buffer,
+                        &request.bufferDataAccess,
+                        request.pData,
+                        pState->pAllocator);
+            batchSize += request.bufferDataAccess.size;
+        }
+        else {
+            // Write image.
+            result = 
+                vkxUploadBatchWriteImage(
+                        &pBatch->uploadBatch,
+                        request.image,
+                        &request.imageDataAccess,
+                        request.newImageLayout,
+                        request.pData,
+                        pState->pAllocator);
+            batchSize += request.imageDataAccess.size;
+        }
+
+        // Push entry.
+        if (pBatch->entryCount == pBatch->entryCapacity) {
+            pBatch->entryCapacity = 
+            pBatch->entryCapacity == 0 ? 16 :
+            pBatch->entryCapacity * 2;
+            pBatch->pEntries = 
+                (StreamEntry*)realloc(
+                        pBatch->pEntries,
+                        sizeof(StreamEntry) * pBatch->entryCapacity);
+        }
+        pBatch->pEntries[pBatch->entryCount].request = request;
+        pBatch->pEntries[pBatch->entryCount].result = result;
+        pBatch->entryCount++;
+    }
+    pBatch->lastValue = pState->dequeuePosition;
+
+    // Submit.
+    VkResult result = 
+        vkxSubmitUploadBatch(
+                &pBatch->uploadBatch,
+                pStreamer->queue,
+                pStreamer->commandPool,
+                VK_NULL_HANDLE, 0,
+                pState->pAllocator);
+    if (VKX_IS_ERROR(result)) {
+        // Fail every entry, batch retires immediately.
+        for (uint32_t entryIndex = 0;
+                      entryIndex < pBatch->entryCount;
+                      entryIndex++) {
+            if (!VKX_IS_ERROR(pBatch->pEntries[entryIndex].result)) {
+                pBatch->pEntries[entryIndex].result = result;
+            }
+        }
+    }
+    pState->batchCount++;
+}
+
+// Streamer worker thread.
+static int streamerMain(void* pArg)
+{
+    VkxStreamer* pStreamer = (VkxStreamer*)pArg;
+    VkxStreamerState* pState = pStreamer->pState;
+    for (;;) {
+        // Retire completed batches.
+        retireStreamBatches(pStreamer, VK_FALSE);
+
+        // Requests pending?
+        if (!streamRingEmpty(pState)) {
+            submitStreamBatch(pStreamer);
+            continue;
+        }
+
+        // Stopped and drained?
+        if (!atomic_load(&pState->running) &&
+            pState->batchCount == 0) {
+            break;
+        }
+
+        if (pState->batchCount > 0) {
+            // Wait briefly on oldest batch.
+            (void) vkxWaitTransferTicket(
+                        &pState->batches[pState->batchHead].
+                            uploadBatch.ticket,
+                        1000000);
+        }
+        else {
+            // Sleep briefly, unless woken by producer.
+            mutexLock(&pState->mutex);
+            atomic_store(&pState->sleeping, true);
+            if (streamRingEmpty(pState) &&
+                atomic_load(&pState->running)) {
+                conditionWaitFor(&pState->condition, &pState->mutex, 1000000);
+            }
+            atomic_store(&pState->sleeping, false);
+            mutexUnlock(&pState->mutex);
+        }
+    }
+    return 0;
+}
+
+// Create streamer.
+VkResult vkxCreateStreamer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            uint32_t queueFamilyIndex,
+            uint32_t ringCapacity,
+            const VkAllocationCallbacks* pAllocator,
+            VkxStreamer* pStreamer)
+{
+    assert(pMemoryTypeTable);
+    assert(pStreamer);
+    memset(pStreamer, 0, sizeof(VkxStreamer));
+    pStreamer->device = device;
+    pStreamer->queue = queue;
+
+    {
+        // Command pool create info.
+        VkCommandPoolCreateInfo commandPoolCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = NULL,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = queueFamilyIndex
+        };
+
+        // Create command pool.
+        VkResult result = 
+            vkCreateCommandPool(
+                    device,
+                    &commandPoolCreateInfo,
+                    pAllocator,
+                    &pStreamer->commandPool);
+        if (VKX_IS_ERROR(result)) {
+            memset(pStreamer, 0, sizeof(VkxStreamer));
+            return result;
+        }
+    }
+
+    // Allocate state.
+    VkxStreamerState* pState = 
+        (VkxStreamerState*)calloc(1, sizeof(VkxStreamerState));
+    if (!pState) {
+        vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    pStreamer->pState = pState;
+    pState->memoryTypeTable = *pMemoryTypeTable;
+    pState->pAllocator = pAllocator;
+
+    // Allocate ring, round capacity up to power of two.
+    uint64_t cellCount = 2;
+    while (cellCount < ringCapacity) {
+        cellCount *= 2;
+    }
+    pState->cellMask = cellCount - 1;
+    pState->pCells = (StreamCell*)malloc(sizeof(StreamCell) * cellCount);
+    if (!pState->pCells) {
+        free(pState);
+        vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+    for (uint64_t cellIndex = 0; cellIndex < cellCount; cellIndex++) {
+        atomic_init(&pState->pCells[cellIndex].sequence, cellIndex);
+    }
+    atomic_init(&pState->enqueuePosition, 0);
+    atomic_init(&pState->completedValue, 0);
+    atomic_init(&pState->running, true);
+    atomic_init(&pState->sleeping, false);
+
+    {
+        // Create fence pool.
+        VkResult result = 
+            vkxCreateFencePool(device, VK_FALSE, &pState->fencePool);
+        if (VKX_IS_ERROR(result)) {
+            free(pState->pCells);
+            free(pState);
+            vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+            memset(pStreamer, 0, sizeof(VkxStreamer));
+            return result;
+        }
+    }
+
+    // Create mutex and condition.
+    if (!mutexInit(&pState->mutex)) {
+        vkxDestroyFencePool(&pState->fencePool, pAllocator);
+        free(pState->pCells);
+        free(pState);
+        vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (!conditionInit(&pState->condition)) {
+        mutexDestroy(&pState->mutex);
+        vkxDestroyFencePool(&pState->fencePool, pAllocator);
+        free(pState->pCells);
+        free(pState);
+        vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Start worker thread.
+    if (!threadCreate(&pState->thread, streamerMain, pStreamer)) {
+        conditionDestroy(&pState->condition);
+        mutexDestroy(&pState->mutex);
+        vkxDestroyFencePool(&pState->fencePool, pAllocator);
+        free(pState->pCells);
+        free(pState);
+        vkDestroyCommandPool(device, pStreamer->commandPool, pAllocator);
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    return VK_SUCCESS;
+}
+
+// Destroy streamer.
+void vkxDestroyStreamer(
+            VkxStreamer* pStreamer,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pStreamer && pStreamer->pState) {
+        VkxStreamerState* pState = pStreamer->pState;
+
+        // Stop worker thread, which drains first.
+        atomic_store(&pState->running, false);
+        conditionSignal(&pState->condition);
+        threadJoin(&pState->thread);
+
+        // Free state.
+        conditionDestroy(&pState->condition);
+        mutexDestroy(&pState->mutex);
+        vkxDestroyFencePool(&pState->fencePool, pAllocator);
+        free(pState->pCells);
+        free(pState);
+
+        // Destroy command pool.
+        vkDestroyCommandPool(
+                pStreamer->device,
+                pStreamer->commandPool,
+                pAllocator);
+
+        // Nullify.
+        memset(pStreamer, 0, sizeof(VkxStreamer));
+    }
+}
+
+// Streamer push.
+VkResult vkxStreamerPush(
+            VkxStreamer* pStreamer,
+            const VkxStreamRequest* pRequest,
+            uint64_t* pValue)
+{
+    assert(pStreamer && pStreamer->pState);
+    assert(pRequest);
+    assert((pRequest->buffer != VK_NULL_HANDLE) != 
+           (pRequest->image != VK_NULL_HANDLE));
+    VkxStreamerState* pState = pStreamer->pState;
+
+    // Claim position.
+    StreamCell* pCell;
+    uint64_t position = 
+        atomic_load_explicit(
+                &pState->enqueuePosition, 
+                memory_order_relaxed);
+    for (;;) {
+        pCell = &pState->pCells[position & pState->cellMask];
+        uint64_t sequence = 
+            atomic_load_explicit(&pCell->sequence, memory_order_acquire);
+        if (sequence == position) {
+            // Free, try to claim.
+            if (atomic_compare_exchange_weak_explicit(
+                    &pState->enqueuePosition,
+                    &position, position + 1,
+                    memory_order_relaxed,
+                    memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (sequence < position) {
+            // Full.
+            return VK_NOT_READY;
+        }
+        else {
+            // Claimed by another producer, reload.
+            position = 
+                atomic_load_explicit(
+                        &pState->enqueuePosition, 
+                        memory_order_relaxed);
+        }
+    }
+
+    // Write cell, then publish.
+    pCell->request = *pRequest;
+    atomic_store_explicit(
+            &pCell->sequence, 
+            position + 1, 
+            memory_order_release);
+    if (pValue) {
+        *pValue = position + 1;
+    }
+
+    // Wake worker, if sleeping.
+    if (atomic_load(&pState->sleeping)) {
+        conditionSignal(&pState->condition);
+    }
+    return VK_SUCCESS;
+}
+
+// Streamer get completed value.
+uint64_t vkxStreamerGetCompletedValue(
+            const VkxStreamer* pStreamer)
+{
+    assert(pStreamer && pStreamer->pState);
+    return 
+        atomic_load_explicit(
+                &pStreamer->pState->completedValue,
+                memory_order_acquire);
+}
+
+// Streamer is complete?
+VkResult vkxStreamerIsComplete(
+            const VkxStreamer* pStreamer,
+            uint64_t value)
+{
+    return 
+        vkxStreamerGetCompletedValue(pStreamer) >= value ? 
+            VK_SUCCESS : VK_NOT_READY;
+}
+
+// Stream file, mapped where supported, read otherwise.
+typedef struct StreamFile_
+{
+    VkDeviceSize size;
+    const unsigned char* pData;
+    FILE* pFile;
+}
+StreamFile;
+
+// Seek stream file, with 64-bit offsets where supported.
+static VkBool32 seekStreamFile(
+            StreamFile* pFile, 
+            VkDeviceSize offset, 
+            int origin)
+{
+#if VKX_STREAM_USE_MMAP
+    return fseeko(pFile->pFile, (off_t)offset, origin) == 0;
+#elif defined(_WIN32)
+    return _fseeki64(pFile->pFile, (__int64)offset, origin) == 0;
+#else
+    return fseek(pFile->pFile, (long)offset, origin) == 0;
+#endif // #if VKX_STREAM_USE_MMAP
+}
+
+// Open stream file.
+static VkBool32 openStreamFile(const char* pFilename, StreamFile* pFile)
+{
+    memset(pFile, 0, sizeof(StreamFile));
+#if VKX_STREAM_USE_MMAP
+    // Open.
+    int fd = open(pFilename, O_RDONLY);
+    if (fd == -1) {
+        return VK_FALSE;
+    }
+
+    // Find size.
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1) {
+        close(fd);
+        return VK_FALSE;
+    }
+    pFile->size = (VkDeviceSize)fileStat.st_size;
+    if (pFile->size == 0) {
+        close(fd);
+        return VK_TRUE;
+    }
+
+    // Map, if it fits in the address space.
+    if (pFile->size <= SIZE_MAX) {
+        void* pData = 
+            mmap(NULL, (size_t)pFile->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pData != MAP_FAILED) {
+            // Close, since the mapping holds a reference.
+            close(fd);
+
+            // Read ahead sequentially.
+            (void) posix_madvise(
+                        pData, (size_t)pFile->size, 
+                        POSIX_MADV_SEQUENTIAL);
+            pFile->pData = (const unsigned char*)pData;
+            return VK_TRUE;
+        }
+    }
+
+    // Map failed, fall back to reading.
+    pFile->pFile = fdopen(fd, "rb");
+    if (!pFile->pFile) {
+        close(fd);
+        return VK_FALSE;
+    }
+    return VK_TRUE;
+#else
+    // Open.
+    pFile->pFile = fopen(pFilename, "rb");
+    if (!pFile->pFile) {
+        return VK_FALSE;
+    }
+
+    // Find size.
+    if (!seekStreamFile(pFile, 0, SEEK_END)) {
+        fclose(pFile->pFile);
+        pFile->pFile = NULL;
+        return VK_FALSE;
+    }
+#if defined(_WIN32)
+    pFile->size = (VkDeviceSize)_ftelli64(pFile->pFile);
+#else
+    pFile->size = (VkDeviceSize)ftell(pFile->pFile);
+#endif // #if defined(_WIN32)
+    return VK_TRUE;
+#endif // #if VKX_STREAM_USE_MMAP
+}
+
+// Read stream file.
+static VkBool32 readStreamFile(
+            StreamFile* pFile, 
+            VkDeviceSize offset, 
+            VkDeviceSize size,
+            void* pDst)
+{
+    if (pFile->pData) {
+        memcpy(pDst, pFile->pData + offset, size);
+        return VK_TRUE;
+    }
+    return 
+        seekStreamFile(pFile, offset, SEEK_SET) &&
+        fread(pDst, 1, size, pFile->pFile) == size;
+}
+
+// Close stream file.
+static void closeStreamFile(StreamFile* pFile)
+{
+#if VKX_STREAM_USE_MMAP
+    if (pFile->pData) {
+        munmap((void*)pFile->pData, (size_t)pFile->size);
+    }
+#endif // #if VKX_STREAM_USE_MMAP
+    if (pFile->pFile) {
+        fclose(pFile->pFile);
+    }
+    memset(pFile, 0, sizeof(StreamFile));
+}
+
+// Stream chunk, reading it from file into staging block and recording 
+// its copy from staging block to target.
+typedef VkBool32 (*StreamChunk)(
+            const void* pTarget,
+            StreamFile* pFile,
+            VkDeviceSize fileOffset,
+            VkDeviceSize chunkOffset,
+            VkDeviceSize chunkSize,
+            const VkxBuffer* pBlock,
+            VkCommandBuffer commandBuffer);
+
+// Stream file through ring of staging blocks.
+static VkResult streamFile(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            const char* pFilename,
+            VkDeviceSize fileOffset,
+            VkDeviceSize size,
+            VkDeviceSize chunkSize,
+            VkDeviceSize blockSize,
+            StreamChunk streamChunk,
+            const void* pTarget,
+            const VkAllocationCallbacks* pAllocator)
+{
+    // Open file.
+    StreamFile file;
+    if (!openStreamFile(pFilename, &file)) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (fileOffset > file.size) {
+        closeStreamFile(&file);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+    if (size == VK_WHOLE_SIZE) {
+        size = file.size - fileOffset;
+    }
+    if (size > file.size - fileOffset) {
+        closeStreamFile(&file);
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Fence pool, recycling ticket fences.
+    VkxFencePool fencePool;
+    VkResult result = vkxCreateFencePool(device, VK_FALSE, &fencePool);
+    if (VKX_IS_ERROR(result)) {
+        closeStreamFile(&file);
+        return result;
+    }
+
+    // Staging blocks and tickets, created lazily.
+    VkxBuffer blocks[VKX_FILE_STREAM_BLOCK_COUNT];
+    VkxTransferTicket tickets[VKX_FILE_STREAM_BLOCK_COUNT];
+    memset(blocks, 0, sizeof(blocks));
+    memset(tickets, 0, sizeof(tickets));
+    if (chunkSize > size) {
+        blockSize -= chunkSize - size;
+        chunkSize = size;
+    }
+
+    for (VkDeviceSize chunkOffset = 0, chunkIndex = 0; 
+                     chunkOffset < size; 
+                     chunkOffset += chunkSize, chunkIndex++) {
+        uint32_t blockIndex = chunkIndex % VKX_FILE_STREAM_BLOCK_COUNT;
+        VkxBuffer* pBlock = &blocks[blockIndex];
+        VkxTransferTicket* pTicket = &tickets[blockIndex];
+        VkDeviceSize currentSize = 
+            size - chunkOffset < chunkSize ? 
+            size - chunkOffset : chunkSize;
+
+        // Wait for device to finish with block.
+        result = vkxWaitTransferTicket(pTicket, UINT64_MAX);
+        vkxDestroyTransferTicket(pTicket, pAllocator);
+        if (VKX_IS_ERROR(result)) {
+            break;
+        }
+
+        if (pBlock->buffer == VK_NULL_HANDLE) {
+            // Create staging block.
+            result = 
+                vkxCreateStagingBuffer(
+                        pMemoryTypeTable,
+                        device,
+                        blockSize,
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                        pAllocator,
+                        pBlock);
+            if (VKX_IS_ERROR(result)) {
+                break;
+            }
+        }
+
+        // Begin ticket.
+        result = vkxBeginTransferTicket(device, commandPool, pTicket);
+        if (VKX_IS_ERROR(result)) {
+            break;
+        }
+        pTicket->pFencePool = &fencePool;
+
+        // Read chunk straight into staging memory, and record copy.
+        if (!streamChunk(
+                pTarget,
+                &file, 
+                fileOffset,
+                chunkOffset, 
+                currentSize, 
+                pBlock,
+                pTicket->commandBuffer)) {
+            vkEndCommandBuffer(pTicket->commandBuffer);
+            vkxDestroyTransferTicket(pTicket, pAllocator);
+            result = VK_ERROR_INITIALIZATION_FAILED;
+            break;
+        }
+
+        // Flush, in case not host-coherent.
+        VkxDeviceMemoryView memoryView = {
+            .memory = pBlock->memory,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE
+        };
+        result = 
+            vkxFlushMemoryViews(
+                    pMemoryTypeTable,
+                    device,
+                    1, &memoryView);
+        if (VKX_IS_ERROR(result)) {
+            vkEndCommandBuffer(pTicket->commandBuffer);
+            vkxDestroyTransferTicket(pTicket, pAllocator);
+            break;
+        }
+
+        // Submit ticket.
+        result = 
+            vkxSubmitTransferTicket(
+                    queue,
+                    VK_NULL_HANDLE, 0,
+                    pAllocator,
+                    pTicket);
+        if (VKX_IS_ERROR(result)) {
+            break;
+        }
+    }
+
+    // Wait for and destroy tickets, then staging blocks.
+    for (uint32_t blockIndex = 0; 
+                  blockIndex < VKX_FILE_STREAM_BLOCK_COUNT; 
+                  blockIndex++) {
+        VkResult waitResult = 
+            vkxWaitTransferTicket(&tickets[blockIndex], UINT64_MAX);
+        if (!VKX_IS_ERROR(result)) {
+            result = waitResult;
+        }
+        vkxDestroyTransferTicket(&tickets[blockIndex], pAllocator);
+        vkxDestroyBuffer(device, &blocks[blockIndex], pAllocator);
+    }
+
+    // Destroy fence pool.
+    vkxDestroyFencePool(&fencePool, pAllocator);
+
+    // Close file.
+    closeStreamFile(&file);
+    return result;
+}
+
+// Buffer stream target.
+typedef struct BufferStreamTarget_
+{
+    VkBuffer buffer;
+    VkDeviceSize offset;
+}
+BufferStreamTarget;
+
+// Stream chunk to buffer.
+static VkBool32 streamBufferChunk(
+            const void* pTarget,
+            StreamFile* pFile,
+            VkDeviceSize fileOffset,
+            VkDeviceSize chunkOffset,
+            VkDeviceSize chunkSize,
+            const VkxBuffer* pBlock,
+            VkCommandBuffer commandBuffer)
+{
+    const BufferStreamTarget* pBufferTarget = 
+        (const BufferStreamTarget*)pTarget;
+    if (!readStreamFile(
+            pFile, 
+            fileOffset + chunkOffset, 
+            chunkSize, 
+            pBlock->pMappedData)) {
+        return VK_FALSE;
+    }
+    VkBufferCopy region = {
+        .srcOffset = 0,
+        .dstOffset = pBufferTarget->offset + chunkOffset,
+        .size = chunkSize
+    };
+    vkCmdCopyBuffer(
+            commandBuffer,
+            pBlock->buffer,
+            pBufferTarget->buffer,
+            1, &region);
+    return VK_TRUE;
+}
+
+// Stream file to buffer.
+VkResult vkxStreamFileToBuffer(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            const char* pFilename,
+            VkDeviceSize fileOffset,
+            VkDeviceSize size,
+            VkBuffer buffer,
+            VkDeviceSize bufferOffset,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pFilename);
+    BufferStreamTarget target = {
+        .buffer = buffer,
+        .offset = bufferOffset
+    };
+    return streamFile(
+                pMemoryTypeTable,
+                device,
+                queue,
+                commandPool,
+                pFilename,
+                fileOffset,
+                size,
+                VKX_FILE_STREAM_CHUNK_SIZE,
+                VKX_FILE_STREAM_CHUNK_SIZE,
+                streamBufferChunk,
+                &target,
+                pAllocator);
+}
+
+// Image stream target.
+typedef struct ImageStreamTarget_
+{
+    VkImage image;
+    const VkxImageDataAccess* pImageDataAccess;
+    VkDeviceSize rowSize;
+    VkDeviceSize alignment;
+}
+ImageStreamTarget;
+
+// Stream chunk to image, one region per slice spanned, each placed at 
+// an aligned offset in staging block.
+static VkBool32 streamImageChunk(
+            const void* pTarget,
+            StreamFile* pFile,
+            VkDeviceSize fileOffset,
+            VkDeviceSize chunkOffset,
+            VkDeviceSize chunkSize,
+            const VkxBuffer* pBlock,
+            VkCommandBuffer commandBuffer)
+{
+    const ImageStreamTarget* pImageTarget = 
+        (const ImageStreamTarget*)pTarget;
+    const VkxImageDataAccess* pAccess = pImageTarget->pImageDataAccess;
+    VkDeviceSize rowSize = pImageTarget->rowSize;
+    VkDeviceSize alignment = pImageTarget->alignment;
+    uint32_t height = pAccess->extent.height;
+    uint32_t depth = pAccess->extent.depth;
+
+    // Rows in chunk, flattened over layers and slices.
+    uint64_t firstRow = chunkOffset / rowSize;
+    uint64_t rowCount = chunkSize / rowSize;
+
+    // Regions, at most one per slice spanned, plus one.
+    uint32_t regionCapacity = (uint32_t)(rowCount / height) + 2;
+    VkBufferImageCopy* pRegions = 
+        (VkBufferImageCopy*)VKX_LOCAL_MALLOC(
+                sizeof(VkBufferImageCopy) * regionCapacity);
+    uint32_t regionCount = 0;
+    VkDeviceSize bufferOffset = 0;
+    for (uint64_t row = firstRow; row < firstRow + rowCount;) {
+        uint64_t slice = row / height;
+        uint32_t y = (uint32_t)(row % height);
+        uint32_t bandHeight = height - y;
+        if (bandHeight > firstRow + rowCount - row) {
+            bandHeight = (uint32_t)(firstRow + rowCount - row);
+        }
+
+        // Read band at aligned offset.
+        bufferOffset = 
+            (bufferOffset + alignment - 1) / alignment * alignment;
+        if (!readStreamFile(
+                pFile,
+                fileOffset + row * rowSize,
+                bandHeight * rowSize,
+                (char*)pBlock->pMappedData + bufferOffset)) {
+            VKX_LOCAL_FREE(pRegions);
+            return VK_FALSE;
+        }
+
+        VkBufferImageCopy* pRegion = &pRegions[regionCount++];
+        pRegion->bufferOffset = bufferOffset;
+        pRegion->bufferRowLength = 0;
+        pRegion->bufferImageHeight = 0;
+        pRegion->imageSubresource = pAccess->subresourceLayers;
+        pRegion->imageSubresource.baseArrayLayer += (uint32_t)(slice / depth);
+        pRegion->imageSubresource.layerCount = 1;
+        pRegion->imageOffset.x = pAccess->offset.x;
+        pRegion->imageOffset.y = pAccess->offset.y + (int32_t)y;
+        pRegion->imageOffset.z = pAccess->offset.z + (int32_t)(slice % depth);
+        pRegion->imageExtent.width = pAccess->extent.width;
+        pRegion->imageExtent.height = bandHeight;
+        pRegion->imageExtent.depth = 1;
+        bufferOffset += bandHeight * rowSize;
+        row += bandHeight;
+    }
+    vkCmdCopyBufferToImage(
+            commandBuffer,
+            pBlock->buffer,
+            pImageTarget->image,
+            pAccess->layout,
+            regionCount, pRegions);
+    VKX_LOCAL_FREE(pRegions);
+    return VK_TRUE;
+}
+
+// Stream file to image.
+VkResult vkxStreamFileToImage(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            const char* pFilename,
+            VkDeviceSize fileOffset,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pFilename);
+    assert(pImageDataAccess);
+    assert(
+        pImageDataAccess->layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL ||
+        pImageDataAccess->layout == VK_IMAGE_LAYOUT_GENERAL ||
+        pImageDataAccess->layout == VK_IMAGE_LAYOUT_SHARED_PRESENT_KHR);
+    if (pImageDataAccess->size == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Row size.
+    uint64_t rowCount = 
+        (uint64_t)pImageDataAccess->extent.height *
+        (uint64_t)pImageDataAccess->extent.depth *
+        (uint64_t)pImageDataAccess->subresourceLayers.layerCount;
+    assert(rowCount > 0);
+    assert(pImageDataAccess->size % rowCount == 0);
+    VkDeviceSize rowSize = pImageDataAccess->size / rowCount;
+    ImageStreamTarget target = {
+        .image = image,
+        .pImageDataAccess = pImageDataAccess,
+        .rowSize = rowSize,
+        // Region offset alignment, the least common multiple of the row 
+        // size and 4, hence of the texel size and 4 as rows hold whole 
+        // texels.
+        .alignment = 
+            rowSize % 4 == 0 ? rowSize : 
+            rowSize % 2 == 0 ? rowSize * 2 : rowSize * 4
+    };
+
+    // Chunk size, in whole rows.
+    VkDeviceSize chunkSize = 
+        VKX_FILE_STREAM_CHUNK_SIZE / rowSize * rowSize;
+    if (chunkSize == 0) {
+        chunkSize = rowSize;
+    }
+
+    // Block size, with room to align each region.
+    VkDeviceSize blockSize = 
+        chunkSize + 
+        (chunkSize / rowSize / pImageDataAccess->extent.height + 2) *
+        (target.alignment - 1);
+    return streamFile(
+                pMemoryTypeTable,
+                device,
+                queue,
+                commandPool,
+                pFilename,
+                fileOffset,
+                pImageDataAccess->size,
+                chunkSize,
+                blockSize,
+                streamImageChunk,
+                &target,
+                pAllocator);
+}
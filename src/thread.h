@@ -0,0 +1,256 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#pragma once
+#ifndef VULKANX_SRC_THREAD_H
+#define VULKANX_SRC_THREAD_H
+
+// Private threading shim. 
+//
+// Uses pthreads on POSIX platforms, where C11 threads are not reliably 
+// available (e.g., Apple libc has no <threads.h>), and C11 threads 
+// elsewhere. On POSIX, the including source must define _POSIX_C_SOURCE 
+// before any system header.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <time.h>
+
+// Thread. Must not move while running.
+typedef struct Thread_
+{
+    pthread_t handle;
+    int (*pMain)(void*);
+    void* pArg;
+}
+Thread;
+
+// Mutex.
+typedef pthread_mutex_t Mutex;
+
+// Condition.
+typedef pthread_cond_t Condition;
+
+// Thread trampoline.
+static inline void* threadStart(void* pArg)
+{
+    Thread* pThread = (Thread*)pArg;
+    (void) pThread->pMain(pThread->pArg);
+    return NULL;
+}
+
+// Thread create.
+static inline bool threadCreate(
+            Thread* pThread, int (*pMain)(void*), void* pArg)
+{
+    pThread->pMain = pMain;
+    pThread->pArg = pArg;
+    return pthread_create(
+                &pThread->handle, NULL, threadStart, pThread) == 0;
+}
+
+// Thread join.
+static inline void threadJoin(Thread* pThread)
+{
+    (void) pthread_join(pThread->handle, NULL);
+}
+
+// Mutex init.
+static inline bool mutexInit(Mutex* pMutex)
+{
+    return pthread_mutex_init(pMutex, NULL) == 0;
+}
+
+// Mutex destroy.
+static inline void mutexDestroy(Mutex* pMutex)
+{
+    (void) pthread_mutex_destroy(pMutex);
+}
+
+// Mutex lock.
+static inline void mutexLock(Mutex* pMutex)
+{
+    (void) pthread_mutex_lock(pMutex);
+}
+
+// Mutex unlock.
+static inline void mutexUnlock(Mutex* pMutex)
+{
+    (void) pthread_mutex_unlock(pMutex);
+}
+
+// Condition init.
+static inline bool conditionInit(Condition* pCondition)
+{
+    return pthread_cond_init(pCondition, NULL) == 0;
+}
+
+// Condition destroy.
+static inline void conditionDestroy(Condition* pCondition)
+{
+    (void) pthread_cond_destroy(pCondition);
+}
+
+// Condition wait.
+static inline void conditionWait(Condition* pCondition, Mutex* pMutex)
+{
+    (void) pthread_cond_wait(pCondition, pMutex);
+}
+
+// Condition wait, with timeout in nanoseconds.
+static inline void conditionWaitFor(
+            Condition* pCondition, Mutex* pMutex, uint64_t timeout)
+{
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout / 1000000000);
+    deadline.tv_nsec += (long)(timeout % 1000000000);
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_nsec -= 1000000000;
+        deadline.tv_sec++;
+    }
+    (void) pthread_cond_timedwait(pCondition, pMutex, &deadline);
+}
+
+// Condition signal.
+static inline void conditionSignal(Condition* pCondition)
+{
+    (void) pthread_cond_signal(pCondition);
+}
+
+// Condition broadcast.
+static inline void conditionBroadcast(Condition* pCondition)
+{
+    (void) pthread_cond_broadcast(pCondition);
+}
+
+#else
+#include <threads.h>
+#include <time.h>
+
+// Thread.
+typedef struct Thread_
+{
+    thrd_t handle;
+}
+Thread;
+
+// Mutex.
+typedef mtx_t Mutex;
+
+// Condition.
+typedef cnd_t Condition;
+
+// Thread create.
+static inline bool threadCreate(
+            Thread* pThread, int (*pMain)(void*), void* pArg)
+{
+    return thrd_create(&pThread->handle, pMain, pArg) == thrd_success;
+}
+
+// Thread join.
+static inline void threadJoin(Thread* pThread)
+{
+    (void) thrd_join(pThread->handle, NULL);
+}
+
+// Mutex init.
+static inline bool mutexInit(Mutex* pMutex)
+{
+    return mtx_init(pMutex, mtx_plain) == thrd_success;
+}
+
+// Mutex destroy.
+static inline void mutexDestroy(Mutex* pMutex)
+{
+    mtx_destroy(pMutex);
+}
+
+// Mutex lock.
+static inline void mutexLock(Mutex* pMutex)
+{
+    (void) mtx_lock(pMutex);
+}
+
+// Mutex unlock.
+static inline void mutexUnlock(Mutex* pMutex)
+{
+    (void) mtx_unlock(pMutex);
+}
+
+// Condition init.
+static inline bool conditionInit(Condition* pCondition)
+{
+    return cnd_init(pCondition) == thrd_success;
+}
+
+// Condition destroy.
+static inline void conditionDestroy(Condition* pCondition)
+{
+    cnd_destroy(pCondition);
+}
+
+// Condition wait.
+static inline void conditionWait(Condition* pCondition, Mutex* pMutex)
+{
+    (void) cnd_wait(pCondition, pMutex);
+}
+
+// Condition wait, with timeout in nanoseconds.
+static inline void conditionWaitFor(
+            Condition* pCondition, Mutex* pMutex, uint64_t timeout)
+{
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_sec += (time_t)(timeout / 1000000000);
+    deadline.tv_nsec += (long)(timeout % 1000000000);
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_nsec -= 1000000000;
+        deadline.tv_sec++;
+    }
+    (void) cnd_timedwait(pCondition, pMutex, &deadline);
+}
+
+// Condition signal.
+static inline void conditionSignal(Condition* pCondition)
+{
+    (void) cnd_signal(pCondition);
+}
+
+// Condition broadcast.
+static inline void conditionBroadcast(Condition* pCondition)
+{
+    (void) cnd_broadcast(pCondition);
+}
+
+#endif // #if defined(__unix__) || defined(__APPLE__)
+
+#endif // #ifndef VULKANX_SRC_THREAD_H
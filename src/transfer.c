@@ -0,0 +1,1039 @@
+/* Copyright (c) 2019-20 M. Grady Saunders
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *   1. Redistributions of source code must retain the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer.
+ * 
+ *   2. Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following
+ *      disclaimer in the documentation and/or other materials
+ *      provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*-*-*-*-*-*-*/
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkanx/command_buffer.h>
+#include <vulkanx/result.h>
+#include <vulkanx/transfer.h>
+
+// Begin upload batch.
+void vkxBeginUploadBatch(
+            const VkxMemoryTypeTable* pMemoryTypeTable,
+            VkDevice device,
+            VkxUploadBatch* pBatch)
+{
+    assert(pMemoryTypeTable);
+    assert(pBatch);
+    memset(pBatch, 0, sizeof(VkxUploadBatch));
+    pBatch->memoryTypeTable = *pMemoryTypeTable;
+    pBatch->device = device;
+}
+
+// Allocate staging memory from upload batch arena, return mapped pointer.
+static VkResult allocateUploadBatchStaging(
+            VkxUploadBatch* pBatch,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            const VkAllocationCallbacks* pAllocator,
+            uint32_t* pChunkIndex,
+            VkDeviceSize* pOffset,
+            void** ppData)
+{
+    // Align offset in last chunk.
+    VkDeviceSize offset = 
+        (pBatch->chunkOffset + alignment - 1) / alignment * alignment;
+
+    // Need new chunk?
+    if (pBatch->chunkCount == 0 ||
+        offset + size > pBatch->chunkSize) {
+
+        // Double chunk size, at least.
+        VkDeviceSize chunkSize = 
+            pBatch->chunkCount == 0 ? VKX_UPLOAD_BATCH_MIN_CHUNK_SIZE :
+            pBatch->chunkSize * 2;
+        while (chunkSize < size) {
+            chunkSize *= 2;
+        }
+
+        // Create staging buffer.
+        VkxBuffer chunk;
+        VkResult result = 
+            vkxCreateStagingBuffer(
+                    &pBatch->memoryTypeTable,
+                    pBatch->device,
+                    chunkSize,
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                    pAllocator,
+                    &chunk);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+
+        // Push chunk.
+        if (pBatch->chunkCount == pBatch->chunkCapacity) {
+            pBatch->chunkCapacity = 
+            pBatch->chunkCapacity == 0 ? 8 :
+            pBatch->chunkCapacity * 2;
+            pBatch->pChunks = 
+                (VkxBuffer*)realloc(
+                        pBatch->pChunks,
+                        sizeof(VkxBuffer) * pBatch->chunkCapacity);
+        }
+        pBatch->pChunks[pBatch->chunkCount++] = chunk;
+        pBatch->chunkSize = chunkSize;
+        offset = 0;
+    }
+
+    // Allocate.
+    *pChunkIndex = pBatch->chunkCount - 1;
+    *pOffset = offset;
+    *ppData = 
+        (char*)pBatch->pChunks[pBatch->chunkCount - 1].pMappedData + offset;
+    pBatch->chunkOffset = offset + size;
+    return VK_SUCCESS;
+}
+
+// Upload batch write buffer.
+VkResult vkxUploadBatchWriteBuffer(
+            VkxUploadBatch* pBatch,
+            VkBuffer buffer,
+            const VkxBufferDataAccess* pBufferDataAccess,
+            const void* pData,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pBatch);
+    assert(pBufferDataAccess);
+    assert(pData || pBufferDataAccess->size == 0);
+    if (pBufferDataAccess->size == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Allocate staging memory.
+    uint32_t chunkIndex;
+    VkDeviceSize chunkOffset;
+    void* pStagingData;
+    VkResult result = 
+        allocateUploadBatchStaging(
+                pBatch,
+                pBufferDataAccess->size, 1,
+                pAllocator,
+                &chunkIndex,
+                &chunkOffset,
+                &pStagingData);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Write staging data.
+    memcpy(pStagingData, pData, pBufferDataAccess->size);
+
+    // Push buffer write.
+    if (pBatch->bufferWriteCount == pBatch->bufferWriteCapacity) {
+        pBatch->bufferWriteCapacity = 
+        pBatch->bufferWriteCapacity == 0 ? 16 :
+        pBatch->bufferWriteCapacity * 2;
+        pBatch->pBufferWrites = 
+            (VkxUploadBufferWrite*)realloc(
+                    pBatch->pBufferWrites,
+                    sizeof(VkxUploadBufferWrite) * 
+                    pBatch->bufferWriteCapacity);
+    }
+    VkxUploadBufferWrite* pWrite = 
+        &pBatch->pBufferWrites[pBatch->bufferWriteCount++];
+    pWrite->buffer = buffer;
+    pWrite->chunkIndex = chunkIndex;
+    pWrite->region.srcOffset = chunkOffset;
+    pWrite->region.dstOffset = pBufferDataAccess->offset;
+    pWrite->region.size = pBufferDataAccess->size;
+    return VK_SUCCESS;
+}
+
+// Upload batch write image.
+VkResult vkxUploadBatchWriteImage(
+            VkxUploadBatch* pBatch,
+            VkImage image,
+            const VkxImageDataAccess* pImageDataAccess,
+            VkImageLayout newLayout,
+            const void* pData,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pBatch);
+    assert(pImageDataAccess);
+    assert(pData || pImageDataAccess->size == 0);
+    if (pImageDataAccess->size == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Subresource range.
+    VkImageSubresourceRange subresourceRange = {
+        .aspectMask = pImageDataAccess->subresourceLayers.aspectMask,
+        .baseMipLevel = pImageDataAccess->subresourceLayers.mipLevel,
+        .levelCount = 1,
+        .baseArrayLayer = pImageDataAccess->subresourceLayers.baseArrayLayer,
+        .layerCount = pImageDataAccess->subresourceLayers.layerCount
+    };
+
+    // Validate layouts now, so that submit cannot fail on them.
+    VkImageMemoryBarrier memoryBarrier;
+    if ((pImageDataAccess->layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
+         VKX_IS_ERROR(
+            vkxGetTransitionImageLayoutBarrier(
+                    image, 
+                    pImageDataAccess->layout, 
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    subresourceRange,
+                    &memoryBarrier))) ||
+        (newLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
+         VKX_IS_ERROR(
+            vkxGetTransitionImageLayoutBarrier(
+                    image, 
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    newLayout,
+                    subresourceRange,
+                    &memoryBarrier)))) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    // Texel size, as texel count divides size.
+    VkDeviceSize texelSize = 
+        pImageDataAccess->size / 
+        ((VkDeviceSize)pImageDataAccess->extent.width *
+         (VkDeviceSize)pImageDataAccess->extent.height *
+         (VkDeviceSize)pImageDataAccess->extent.depth *
+         (VkDeviceSize)pImageDataAccess->subresourceLayers.layerCount);
+    assert(texelSize > 0);
+
+    // Least common multiple of texel size and 4.
+    VkDeviceSize alignment = 
+        texelSize % 4 == 0 ? texelSize : 
+        texelSize % 2 == 0 ? texelSize * 2 : texelSize * 4;
+
+    // Allocate staging memory.
+    uint32_t chunkIndex;
+    VkDeviceSize chunkOffset;
+    void* pStagingData;
+    VkResult result = 
+        allocateUploadBatchStaging(
+                pBatch,
+                pImageDataAccess->size, 
+                alignment,
+                pAllocator,
+                &chunkIndex,
+                &chunkOffset,
+                &pStagingData);
+    if (VKX_IS_ERROR(result)) {
+        return result;
+    }
+
+    // Write staging data.
+    memcpy(pStagingData, pData, pImageDataAccess->size);
+
+    // Push image write.
+    if (pBatch->imageWriteCount == pBatch->imageWriteCapacity) {
+        pBatch->imageWriteCapacity = 
+        pBatch->imageWriteCapacity == 0 ? 16 :
+        pBatch->imageWriteCapacity * 2;
+        pBatch->pImageWrites = 
+            (VkxUploadImageWrite*)realloc(
+                    pBatch->pImageWrites,
+                    sizeof(VkxUploadImageWrite) * 
+                    pBatch->imageWriteCapacity);
+    }
+    VkxUploadImageWrite* pWrite = 
+        &pBatch->pImageWrites[pBatch->imageWriteCount++];
+    pWrite->image = image;
+    pWrite->oldLayout = pImageDataAccess->layout;
+    pWrite->newLayout = newLayout;
+    pWrite->chunkIndex = chunkIndex;
+    pWrite->region.bufferOffset = chunkOffset;
+    pWrite->region.bufferRowLength = 0;
+    pWrite->region.bufferImageHeight = 0;
+    pWrite->region.imageSubresource = pImageDataAccess->subresourceLayers;
+    pWrite->region.imageOffset = pImageDataAccess->offset;
+    pWrite->region.imageExtent = pImageDataAccess->extent;
+    return VK_SUCCESS;
+}
+
+// Compare upload buffer writes, by buffer then chunk then offset.
+static int compareUploadBufferWrites(const void* pValue1, const void* pValue2)
+{
+    const VkxUploadBufferWrite* pWrite1 = 
+        (const VkxUploadBufferWrite*)pValue1;
+    const VkxUploadBufferWrite* pWrite2 = 
+        (const VkxUploadBufferWrite*)pValue2;
+    int bufferOrder = 
+        memcmp(&pWrite1->buffer, &pWrite2->buffer, sizeof(VkBuffer));
+    if (bufferOrder != 0) {
+        return bufferOrder;
+    }
+    if (pWrite1->chunkIndex != pWrite2->chunkIndex) {
+        return pWrite1->chunkIndex < pWrite2->chunkIndex ? -1 : +1;
+    }
+    if (pWrite1->region.srcOffset != pWrite2->region.srcOffset) {
+        return pWrite1->region.srcOffset < 
+               pWrite2->region.srcOffset ? -1 : +1;
+    }
+    return 0;
+}
+
+// Compare upload image writes, by image then chunk then offset.
+static int compareUploadImageWrites(const void* pValue1, const void* pValue2)
+{
+    const VkxUploadImageWrite* pWrite1 = 
+        (const VkxUploadImageWrite*)pValue1;
+    const VkxUploadImageWrite* pWrite2 = 
+        (const VkxUploadImageWrite*)pValue2;
+    int imageOrder = 
+        memcmp(&pWrite1->image, &pWrite2->image, sizeof(VkImage));
+    if (imageOrder != 0) {
+        return imageOrder;
+    }
+    if (pWrite1->chunkIndex != pWrite2->chunkIndex) {
+        return pWrite1->chunkIndex < pWrite2->chunkIndex ? -1 : +1;
+    }
+    if (pWrite1->region.bufferOffset != pWrite2->region.bufferOffset) {
+        return pWrite1->region.bufferOffset < 
+               pWrite2->region.bufferOffset ? -1 : +1;
+    }
+    return 0;
+}
+
+// Push image memory barrier, unless already pushed for same image and 
+// subresource range. Barriers for each image are contiguous, since image 
+// writes are sorted by image.
+static void pushUploadImageBarrier(
+            VkImage image,
+            VkImageLayout oldLayout,
+            VkImageLayout newLayout,
+            VkImageSubresourceRange subresourceRange,
+            VkBool32 force,
+            uint32_t* pMemoryBarrierCount,
+            VkImageMemoryBarrier* pMemoryBarriers)
+{
+    if (oldLayout == newLayout && !force) {
+        return;
+    }
+    for (uint32_t barrierIndex = *pMemoryBarrierCount; 
+                  barrierIndex-- > 0;) {
+        const VkImageMemoryBarrier* pMemoryBarrier = 
+            &pMemoryBarriers[barrierIndex];
+        if (pMemoryBarrier->image != image) {
+            break;
+        }
+        if (!memcmp(
+                &pMemoryBarrier->subresourceRange,
+                &subresourceRange,
+                sizeof(VkImageSubresourceRange))) {
+            return;
+        }
+    }
+
+    // Validated on write.
+    (void) vkxGetTransitionImageLayoutBarrier(
+                image,
+                oldLayout,
+                newLayout,
+                subresourceRange,
+                &pMemoryBarriers[(*pMemoryBarrierCount)++]);
+}
+
+// Record upload batch.
+//
+// If acquireCommandBuffer is not VK_NULL_HANDLE, the post-copy barriers
+// release ownership from srcQueueFamilyIndex to dstQueueFamilyIndex in
+// commandBuffer, and acquire ownership in acquireCommandBuffer.
+static void recordUploadBatch(
+            VkxUploadBatch* pBatch,
+            VkCommandBuffer commandBuffer,
+            VkCommandBuffer acquireCommandBuffer,
+            uint32_t srcQueueFamilyIndex,
+            uint32_t dstQueueFamilyIndex)
+{
+    // Sort writes, so that copies into the same destination from the
+    // same chunk are contiguous.
+    qsort(
+        pBatch->pBufferWrites,
+        pBatch->bufferWriteCount,
+        sizeof(VkxUploadBufferWrite),
+        compareUploadBufferWrites);
+    qsort(
+        pBatch->pImageWrites,
+        pBatch->imageWriteCount,
+        sizeof(VkxUploadImageWrite),
+        compareUploadImageWrites);
+
+    // Scratch arrays.
+    VkBufferCopy* pBufferRegions = 
+        (VkBufferCopy*)malloc(
+                sizeof(VkBufferCopy) * pBatch->bufferWriteCount);
+    VkBufferImageCopy* pImageRegions = 
+        (VkBufferImageCopy*)malloc(
+                sizeof(VkBufferImageCopy) * pBatch->imageWriteCount);
+    VkBufferMemoryBarrier* pBufferMemoryBarriers = 
+        (VkBufferMemoryBarrier*)malloc(
+                sizeof(VkBufferMemoryBarrier) * pBatch->bufferWriteCount);
+    VkImageMemoryBarrier* pPreMemoryBarriers = 
+        (VkImageMemoryBarrier*)malloc(
+                sizeof(VkImageMemoryBarrier) * pBatch->imageWriteCount);
+    VkImageMemoryBarrier* pPostMemoryBarriers = 
+        (VkImageMemoryBarrier*)malloc(
+                sizeof(VkImageMemoryBarrier) * pBatch->imageWriteCount);
+
+    // Gather image memory barriers.
+    uint32_t preMemoryBarrierCount = 0;
+    uint32_t postMemoryBarrierCount = 0;
+    for (uint32_t writeIndex = 0;
+                  writeIndex < pBatch->imageWriteCount;
+                  writeIndex++) {
+        const VkxUploadImageWrite* pWrite = 
+            &pBatch->pImageWrites[writeIndex];
+        VkImageSubresourceRange subresourceRange = {
+            .aspectMask = pWrite->region.imageSubresource.aspectMask,
+            .baseMipLevel = pWrite->region.imageSubresource.mipLevel,
+            .levelCount = 1,
+            .baseArrayLayer = 
+                pWrite->region.imageSubresource.baseArrayLayer,
+            .layerCount = pWrite->region.imageSubresource.layerCount
+        };
+        pushUploadImageBarrier(
+                pWrite->image,
+                pWrite->oldLayout,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                subresourceRange,
+                VK_FALSE,
+                &preMemoryBarrierCount,
+                pPreMemoryBarriers);
+        pushUploadImageBarrier(
+                pWrite->image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                pWrite->newLayout,
+                subresourceRange,
+                acquireCommandBuffer != VK_NULL_HANDLE,
+                &postMemoryBarrierCount,
+                pPostMemoryBarriers);
+    }
+
+    if (preMemoryBarrierCount > 0) {
+        // Transition images for transfer.
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                0, NULL,
+                0, NULL,
+                preMemoryBarrierCount, pPreMemoryBarriers);
+    }
+
+    // Copy buffers, merging adjacent regions.
+    uint32_t bufferMemoryBarrierCount = 0;
+    for (uint32_t writeIndex = 0;
+                  writeIndex < pBatch->bufferWriteCount;) {
+        const VkxUploadBufferWrite* pFirstWrite = 
+            &pBatch->pBufferWrites[writeIndex];
+        uint32_t regionCount = 0;
+        for (; writeIndex < pBatch->bufferWriteCount; writeIndex++) {
+            const VkxUploadBufferWrite* pWrite = 
+                &pBatch->pBufferWrites[writeIndex];
+            if (pWrite->buffer != pFirstWrite->buffer ||
+                pWrite->chunkIndex != pFirstWrite->chunkIndex) {
+                break;
+            }
+            VkBufferCopy* pLastRegion = 
+                regionCount > 0 ? &pBufferRegions[regionCount - 1] : NULL;
+            if (pLastRegion &&
+                pLastRegion->srcOffset + pLastRegion->size == 
+                    pWrite->region.srcOffset &&
+                pLastRegion->dstOffset + pLastRegion->size == 
+                    pWrite->region.dstOffset) {
+                // Merge.
+                pLastRegion->size += pWrite->region.size;
+            }
+            else {
+                pBufferRegions[regionCount++] = pWrite->region;
+            }
+        }
+        vkCmdCopyBuffer(
+                commandBuffer,
+                pBatch->pChunks[pFirstWrite->chunkIndex].buffer,
+                pFirstWrite->buffer,
+                regionCount, pBufferRegions);
+
+        // Buffer memory barrier, once per buffer.
+        if (bufferMemoryBarrierCount == 0 ||
+            pBufferMemoryBarriers[bufferMemoryBarrierCount - 1].buffer != 
+                pFirstWrite->buffer) {
+            VkBufferMemoryBarrier bufferMemoryBarrier = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .pNext = NULL,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = pFirstWrite->buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE
+            };
+            pBufferMemoryBarriers[bufferMemoryBarrierCount++] = 
+                bufferMemoryBarrier;
+        }
+    }
+
+    // Copy images.
+    for (uint32_t writeIndex = 0;
+                  writeIndex < pBatch->imageWriteCount;) {
+        const VkxUploadImageWrite* pFirstWrite = 
+            &pBatch->pImageWrites[writeIndex];
+        uint32_t regionCount = 0;
+        for (; writeIndex < pBatch->imageWriteCount; writeIndex++) {
+            const VkxUploadImageWrite* pWrite = 
+                &pBatch->pImageWrites[writeIndex];
+            if (pWrite->image != pFirstWrite->image ||
+                pWrite->chunkIndex != pFirstWrite->chunkIndex) {
+                break;
+            }
+            pImageRegions[regionCount++] = pWrite->region;
+        }
+        vkCmdCopyBufferToImage(
+                commandBuffer,
+                pBatch->pChunks[pFirstWrite->chunkIndex].buffer,
+                pFirstWrite->image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                regionCount, pImageRegions);
+    }
+
+    if (acquireCommandBuffer == VK_NULL_HANDLE) {
+        // Make buffer writes visible to later commands, and transition
+        // images for use.
+        if (bufferMemoryBarrierCount > 0 ||
+            postMemoryBarrierCount > 0) {
+            vkCmdPipelineBarrier(
+                    commandBuffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                    0,
+                    0, NULL,
+                    bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                    postMemoryBarrierCount, pPostMemoryBarriers);
+        }
+    }
+    else {
+        // Set queue family indices.
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < bufferMemoryBarrierCount;
+                      barrierIndex++) {
+            pBufferMemoryBarriers[barrierIndex].srcQueueFamilyIndex = 
+                srcQueueFamilyIndex;
+            pBufferMemoryBarriers[barrierIndex].dstQueueFamilyIndex = 
+                dstQueueFamilyIndex;
+        }
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < postMemoryBarrierCount;
+                      barrierIndex++) {
+            pPostMemoryBarriers[barrierIndex].srcQueueFamilyIndex = 
+                srcQueueFamilyIndex;
+            pPostMemoryBarriers[barrierIndex].dstQueueFamilyIndex = 
+                dstQueueFamilyIndex;
+        }
+
+        // Acquire ownership, ignoring source access, since release
+        // already made writes available.
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < bufferMemoryBarrierCount;
+                      barrierIndex++) {
+            pBufferMemoryBarriers[barrierIndex].srcAccessMask = 0;
+        }
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < postMemoryBarrierCount;
+                      barrierIndex++) {
+            pPostMemoryBarriers[barrierIndex].srcAccessMask = 0;
+        }
+        vkCmdPipelineBarrier(
+                acquireCommandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                0,
+                0, NULL,
+                bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                postMemoryBarrierCount, pPostMemoryBarriers);
+
+        // Release ownership, ignoring destination access, since acquire
+        // makes writes visible.
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < bufferMemoryBarrierCount;
+                      barrierIndex++) {
+            pBufferMemoryBarriers[barrierIndex].srcAccessMask = 
+                VK_ACCESS_TRANSFER_WRITE_BIT;
+            pBufferMemoryBarriers[barrierIndex].dstAccessMask = 0;
+        }
+        for (uint32_t barrierIndex = 0;
+                      barrierIndex < postMemoryBarrierCount;
+                      barrierIndex++) {
+            pPostMemoryBarriers[barrierIndex].srcAccessMask = 
+                VK_ACCESS_TRANSFER_WRITE_BIT;
+            pPostMemoryBarriers[barrierIndex].dstAccessMask = 0;
+        }
+        vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                0,
+                0, NULL,
+                bufferMemoryBarrierCount, pBufferMemoryBarriers,
+                postMemoryBarrierCount, pPostMemoryBarriers);
+    }
+
+    // Free scratch arrays.
+    free(pBufferRegions);
+    free(pImageRegions);
+    free(pBufferMemoryBarriers);
+    free(pPreMemoryBarriers);
+    free(pPostMemoryBarriers);
+}
+
+// Flush upload batch staging chunks, in case not host-coherent.
+static VkResult flushUploadBatch(VkxUploadBatch* pBatch)
+{
+    VkxDeviceMemoryView* pMemoryViews = 
+        (VkxDeviceMemoryView*)VKX_LOCAL_MALLOC(
+                sizeof(VkxDeviceMemoryView) * pBatch->chunkCount);
+    for (uint32_t chunkIndex = 0;
+                  chunkIndex < pBatch->chunkCount;
+                  chunkIndex++) {
+        pMemoryViews[chunkIndex].memory = 
+            pBatch->pChunks[chunkIndex].memory;
+        pMemoryViews[chunkIndex].offset = 0;
+        pMemoryViews[chunkIndex].size = VK_WHOLE_SIZE;
+    }
+    VkResult result = 
+        vkxFlushMemoryViews(
+                &pBatch->memoryTypeTable,
+                pBatch->device,
+                pBatch->chunkCount, pMemoryViews);
+    VKX_LOCAL_FREE(pMemoryViews);
+    return result;
+}
+
+// Submit upload batch.
+VkResult vkxSubmitUploadBatch(
+            VkxUploadBatch* pBatch,
+            VkQueue queue,
+            VkCommandPool commandPool,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pBatch);
+    assert(pBatch->ticket.commandBuffer == VK_NULL_HANDLE);
+    if (pBatch->bufferWriteCount == 0 &&
+        pBatch->imageWriteCount == 0) {
+        return VK_SUCCESS;
+    }
+
+    {
+        // Flush staging chunks.
+        VkResult result = flushUploadBatch(pBatch);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    {
+        // Begin transfer ticket.
+        VkResult result = 
+            vkxBeginTransferTicket(
+                    pBatch->device,
+                    commandPool,
+                    &pBatch->ticket);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+        pBatch->ticket.pFencePool = pBatch->pFencePool;
+    }
+
+    // Record.
+    recordUploadBatch(
+            pBatch,
+            pBatch->ticket.commandBuffer,
+            VK_NULL_HANDLE,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED);
+
+    // Submit transfer ticket.
+    return vkxSubmitTransferTicket(
+                queue,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                &pBatch->ticket);
+}
+
+// Destroy upload batch.
+void vkxDestroyUploadBatch(
+            VkxUploadBatch* pBatch,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pBatch) {
+        // Wait for and destroy tickets.
+        vkxDestroyTransferTicket(&pBatch->ticket, pAllocator);
+        vkxDestroyTransferTicket(&pBatch->acquireTicket, pAllocator);
+
+        if (pBatch->ownershipSemaphore) {
+            if (pBatch->pSemaphorePool) {
+                // Release ownership semaphore, consumed by acquire.
+                vkxSemaphorePoolRelease(
+                        pBatch->pSemaphorePool,
+                        pBatch->ownershipSemaphore);
+            }
+            else {
+                // Destroy ownership semaphore.
+                vkxDestroySemaphores(
+                        pBatch->device, 
+                        1, &pBatch->ownershipSemaphore, pAllocator);
+            }
+        }
+
+        // Destroy staging chunks.
+        for (uint32_t chunkIndex = 0;
+                      chunkIndex < pBatch->chunkCount;
+                      chunkIndex++) {
+            vkxDestroyBuffer(
+                    pBatch->device,
+                    &pBatch->pChunks[chunkIndex],
+                    pAllocator);
+        }
+
+        // Free.
+        free(pBatch->pChunks);
+        free(pBatch->pBufferWrites);
+        free(pBatch->pImageWrites);
+
+        // Nullify.
+        memset(pBatch, 0, sizeof(VkxUploadBatch));
+    }
+}
+
+// Find transfer queue family, return index in device queue families.
+static uint32_t findTransferQueueFamily(
+            const VkxDevice* pDevice,
+            uint32_t graphicsQueueFamily)
+{
+    // Prefer transfer-only, then anything but graphics.
+    const VkQueueFlags excludeFlags[2] = {
+        VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT,
+        VK_QUEUE_GRAPHICS_BIT
+    };
+    for (uint32_t excludeIndex = 0; excludeIndex < 2; excludeIndex++) {
+        for (uint32_t familyIndex = 0;
+                      familyIndex < pDevice->queueFamilyCount;
+                      familyIndex++) {
+            const VkxDeviceQueueFamily* pFamily = 
+                &pDevice->pQueueFamilies[familyIndex];
+            VkQueueFlags queueFlags = 
+                pFamily->queueFamilyProperties.queueFlags;
+            // Graphics and compute imply transfer.
+            VkQueueFlags transferFlags = 
+                VK_QUEUE_TRANSFER_BIT |
+                VK_QUEUE_GRAPHICS_BIT |
+                VK_QUEUE_COMPUTE_BIT;
+            if (pFamily->queueCount > 0 &&
+                pFamily->queueFamilyIndex != 
+                    pDevice->pQueueFamilies[graphicsQueueFamily].
+                        queueFamilyIndex &&
+                (queueFlags & transferFlags) != 0 &&
+                (queueFlags & excludeFlags[excludeIndex]) == 0) {
+                return familyIndex;
+            }
+        }
+    }
+
+    // Fall back to graphics queue family.
+    return graphicsQueueFamily;
+}
+
+// Create transfer engine.
+VkResult vkxCreateTransferEngine(
+            const VkxDevice* pDevice,
+            uint32_t graphicsQueueFamily,
+            const VkAllocationCallbacks* pAllocator,
+            VkxTransferEngine* pEngine)
+{
+    assert(pDevice);
+    assert(pEngine);
+    assert(graphicsQueueFamily < pDevice->queueFamilyCount);
+    memset(pEngine, 0, sizeof(VkxTransferEngine));
+    pEngine->device = pDevice->device;
+
+    // Graphics queue family.
+    const VkxDeviceQueueFamily* pGraphicsFamily = 
+        &pDevice->pQueueFamilies[graphicsQueueFamily];
+    assert(pGraphicsFamily->queueCount > 0);
+    pEngine->graphicsQueueFamilyIndex = pGraphicsFamily->queueFamilyIndex;
+    pEngine->graphicsQueue = pGraphicsFamily->pQueues[0];
+
+    // Transfer queue family.
+    const VkxDeviceQueueFamily* pTransferFamily = 
+        &pDevice->pQueueFamilies[
+            findTransferQueueFamily(pDevice, graphicsQueueFamily)];
+    pEngine->transferQueueFamilyIndex = pTransferFamily->queueFamilyIndex;
+    pEngine->transferQueue = pTransferFamily->pQueues[0];
+    pEngine->transferGranularity = 
+        pTransferFamily->queueFamilyProperties.minImageTransferGranularity;
+
+    // Command pool create info.
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = NULL,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = pEngine->graphicsQueueFamilyIndex
+    };
+
+    {
+        // Create graphics command pool.
+        VkResult result = 
+            vkCreateCommandPool(
+                    pEngine->device,
+                    &commandPoolCreateInfo,
+                    pAllocator,
+                    &pEngine->graphicsCommandPool);
+        if (VKX_IS_ERROR(result)) {
+            memset(pEngine, 0, sizeof(VkxTransferEngine));
+            return result;
+        }
+    }
+
+    {
+        // Create fence pool and semaphore pool.
+        VkResult result = 
+            vkxCreateFencePool(
+                    pEngine->device, VK_TRUE, 
+                    &pEngine->fencePool);
+        if (!VKX_IS_ERROR(result)) {
+            result = 
+                vkxCreateSemaphorePool(
+                        pEngine->device, VK_TRUE,
+                        &pEngine->semaphorePool);
+        }
+        if (VKX_IS_ERROR(result)) {
+            pEngine->transferCommandPool = pEngine->graphicsCommandPool;
+            vkxDestroyTransferEngine(pEngine, pAllocator);
+            return result;
+        }
+    }
+
+    // Same queue family?
+    if (pEngine->transferQueueFamilyIndex == 
+        pEngine->graphicsQueueFamilyIndex) {
+        pEngine->transferCommandPool = pEngine->graphicsCommandPool;
+        return VK_SUCCESS;
+    }
+
+    {
+        // Create transfer command pool.
+        commandPoolCreateInfo.queueFamilyIndex = 
+            pEngine->transferQueueFamilyIndex;
+        VkResult result = 
+            vkCreateCommandPool(
+                    pEngine->device,
+                    &commandPoolCreateInfo,
+                    pAllocator,
+                    &pEngine->transferCommandPool);
+        if (VKX_IS_ERROR(result)) {
+            vkxDestroyTransferEngine(pEngine, pAllocator);
+            return result;
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
+// Destroy transfer engine.
+void vkxDestroyTransferEngine(
+            VkxTransferEngine* pEngine,
+            const VkAllocationCallbacks* pAllocator)
+{
+    if (pEngine) {
+        // Destroy transfer command pool, if distinct.
+        if (pEngine->transferCommandPool != 
+            pEngine->graphicsCommandPool) {
+            vkDestroyCommandPool(
+                    pEngine->device,
+                    pEngine->transferCommandPool,
+                    pAllocator);
+        }
+
+        // Destroy graphics command pool.
+        vkDestroyCommandPool(
+                pEngine->device,
+                pEngine->graphicsCommandPool,
+                pAllocator);
+
+        // Destroy fence pool and semaphore pool.
+        vkxDestroyFencePool(&pEngine->fencePool, pAllocator);
+        vkxDestroySemaphorePool(&pEngine->semaphorePool, pAllocator);
+
+        // Nullify.
+        memset(pEngine, 0, sizeof(VkxTransferEngine));
+    }
+}
+
+// Transfer engine submit upload batch.
+VkResult vkxTransferEngineSubmitUploadBatch(
+            VkxTransferEngine* pEngine,
+            VkxUploadBatch* pBatch,
+            VkSemaphore timelineSemaphore,
+            uint64_t timelineValue,
+            const VkAllocationCallbacks* pAllocator)
+{
+    assert(pEngine);
+    assert(pBatch);
+    assert(pBatch->ticket.commandBuffer == VK_NULL_HANDLE);
+    if (!pBatch->pFencePool) {
+        pBatch->pFencePool = &pEngine->fencePool;
+    }
+    if (!pBatch->pSemaphorePool) {
+        pBatch->pSemaphorePool = &pEngine->semaphorePool;
+    }
+
+    // Same queue family?
+    if (pEngine->transferQueueFamilyIndex == 
+        pEngine->graphicsQueueFamilyIndex) {
+        return 
+            vkxSubmitUploadBatch(
+                    pBatch,
+                    pEngine->graphicsQueue,
+                    pEngine->graphicsCommandPool,
+                    timelineSemaphore,
+                    timelineValue,
+                    pAllocator);
+    }
+
+    if (pBatch->bufferWriteCount == 0 &&
+        pBatch->imageWriteCount == 0) {
+        return VK_SUCCESS;
+    }
+
+    // Image write offsets respect transfer granularity?
+    for (uint32_t writeIndex = 0;
+                  writeIndex < pBatch->imageWriteCount;
+                  writeIndex++) {
+        VkExtent3D granularity = pEngine->transferGranularity;
+        VkOffset3D offset = 
+            pBatch->pImageWrites[writeIndex].region.imageOffset;
+        assert(granularity.width == 0 ? offset.x == 0 : 
+               (uint32_t)offset.x % granularity.width == 0);
+        assert(granularity.height == 0 ? offset.y == 0 : 
+               (uint32_t)offset.y % granularity.height == 0);
+        assert(granularity.depth == 0 ? offset.z == 0 : 
+               (uint32_t)offset.z % granularity.depth == 0);
+        (void)granularity;
+        (void)offset;
+    }
+
+    {
+        // Flush staging chunks.
+        VkResult result = flushUploadBatch(pBatch);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    {
+        // Acquire ownership semaphore.
+        VkResult result = 
+            vkxSemaphorePoolAcquire(
+                    pBatch->pSemaphorePool,
+                    pAllocator, 
+                    &pBatch->ownershipSemaphore);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+    }
+
+    {
+        // Begin transfer ticket.
+        VkResult result = 
+            vkxBeginTransferTicket(
+                    pBatch->device,
+                    pEngine->transferCommandPool,
+                    &pBatch->ticket);
+        if (VKX_IS_ERROR(result)) {
+            return result;
+        }
+        pBatch->ticket.pFencePool = pBatch->pFencePool;
+
+        // Begin acquire ticket.
+        result = 
+            vkxBeginTransferTicket(
+                    pBatch->device,
+                    pEngine->graphicsCommandPool,
+                    &pBatch->acquireTicket);
+        if (VKX_IS_ERROR(result)) {
+            vkxDestroyTransferTicket(&pBatch->ticket, pAllocator);
+            return result;
+        }
+        pBatch->acquireTicket.pFencePool = pBatch->pFencePool;
+    }
+
+    // Record.
+    recordUploadBatch(
+            pBatch,
+            pBatch->ticket.commandBuffer,
+            pBatch->acquireTicket.commandBuffer,
+            pEngine->transferQueueFamilyIndex,
+            pEngine->graphicsQueueFamilyIndex);
+
+    {
+        // Submit transfer ticket, signaling ownership semaphore.
+        VkResult result = 
+            vkxSubmitTransferTicketWithSemaphores(
+                    pEngine->transferQueue,
+                    0, NULL, NULL,
+                    1, &pBatch->ownershipSemaphore,
+                    VK_NULL_HANDLE, 0,
+                    pAllocator,
+                    &pBatch->ticket);
+        if (VKX_IS_ERROR(result)) {
+            vkxDestroyTransferTicket(&pBatch->acquireTicket, pAllocator);
+            return result;
+        }
+    }
+
+    // Submit acquire ticket, waiting on ownership semaphore.
+    VkPipelineStageFlags waitDstStageMask = 
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    VkResult result = 
+        vkxSubmitTransferTicketWithSemaphores(
+                pEngine->graphicsQueue,
+                1, &pBatch->ownershipSemaphore, &waitDstStageMask,
+                0, NULL,
+                timelineSemaphore,
+                timelineValue,
+                pAllocator,
+                &pBatch->acquireTicket);
+    if (VKX_IS_ERROR(result)) {
+        // Ownership semaphore left signaled, so do not recycle it.
+        (void) vkxWaitTransferTicket(&pBatch->ticket, UINT64_MAX);
+        vkxDestroySemaphores(
+                pBatch->device, 
+                1, &pBatch->ownershipSemaphore, pAllocator);
+    }
+    return result;
+}